@@ -1,6 +1,7 @@
 #pragma once
 #include "Engine.h"
 #include "ModelLoader.h"
+#include "Name.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -152,9 +153,9 @@ public:
     AnimatorComponent* animator = nullptr;
     
     // Parameters for conditions
-    std::unordered_map<std::string, float> floatParams;
-    std::unordered_map<std::string, bool> boolParams;
-    std::unordered_map<std::string, int> intParams;
+    std::unordered_map<Name, float> floatParams;
+    std::unordered_map<Name, bool> boolParams;
+    std::unordered_map<Name, int> intParams;
     
     void init(AnimatorComponent* anim) {
         animator = anim;
@@ -186,19 +187,19 @@ public:
         }
     }
     
-    void setFloat(const std::string& name, float value) { floatParams[name] = value; }
-    void setBool(const std::string& name, bool value) { boolParams[name] = value; }
-    void setInt(const std::string& name, int value) { intParams[name] = value; }
+    void setFloat(Name name, float value) { floatParams[name] = value; }
+    void setBool(Name name, bool value) { boolParams[name] = value; }
+    void setInt(Name name, int value) { intParams[name] = value; }
     
-    float getFloat(const std::string& name) const {
+    float getFloat(Name name) const {
         auto it = floatParams.find(name);
         return it != floatParams.end() ? it->second : 0.0f;
     }
-    bool getBool(const std::string& name) const {
+    bool getBool(Name name) const {
         auto it = boolParams.find(name);
         return it != boolParams.end() ? it->second : false;
     }
-    int getInt(const std::string& name) const {
+    int getInt(Name name) const {
         auto it = intParams.find(name);
         return it != intParams.end() ? it->second : 0;
     }
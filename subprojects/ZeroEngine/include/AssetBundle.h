@@ -0,0 +1,514 @@
+#pragma once
+#include "ScenePackager.h"
+#include "ModelLoader.h"
+#include <cstdio>
+#include <map>
+#include <unordered_set>
+
+// Asset bundles: scene packages that carry their own cooked assets
+//
+// A cooked model is a ModelImport flattened to arrays - vertices, indices,
+// submeshes, materials, bones, animations - so loading it is a few copies
+// instead of an Assimp parse. Its decoded images are cooked separately.
+// Each cooked blob is stored under its content key ("asset/<hash>"), so a
+// texture or model shared by many paths or scenes is written once. The
+// "bundle/manifest" resource maps source paths to model keys.
+//
+// AssetBundle serves imports straight from a MappedPackageReader; the
+// scene loaders check it before going to the filesystem.
+
+namespace ScenePackage {
+
+// 128-bit content address: two independently seeded multiply-xor lanes
+struct ContentKey {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    std::string toString() const {
+        char text[33];
+        std::snprintf(text, sizeof(text), "%016llx%016llx",
+                      static_cast<unsigned long long>(hi), static_cast<unsigned long long>(lo));
+        return text;
+    }
+};
+
+inline ContentKey hashContent(const uint8_t* data, size_t size) {
+    uint64_t a = 0x9E3779B97F4A7C15ull ^ size;
+    uint64_t b = 0xC2B2AE3D27D4EB4Full + size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        a = (a ^ word) * 0xFF51AFD7ED558CCDull;
+        a ^= a >> 32;
+        b = (b + word) * 0x9FB21C651E98DF25ull;
+        b ^= b >> 29;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    a = (a ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    b = (b + tail) * 0xFF51AFD7ED558CCDull;
+    return {a ^ (a >> 33), b ^ (b >> 31)};
+}
+
+} // namespace ScenePackage
+
+// Flat binary form of ModelImport
+//
+// Layout: "ZCMD" | version | vertex stride | counts | globalInverse |
+//         vertices | indices | submeshes | materials | bones | animations |
+//         images (content key + source path each) | collision mesh (optional)
+class ModelCooker {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    // imageKeys[i] is the content key of imported.images[i]
+    static std::vector<uint8_t> cookModel(const ModelImport& imported, const std::vector<std::string>& imageKeys) {
+        const Model& model = imported.model;
+        std::vector<uint8_t> out;
+        out.insert(out.end(), {'Z', 'C', 'M', 'D'});
+        write(out, VERSION);
+        write(out, static_cast<uint32_t>(sizeof(Vertex)));
+        write(out, static_cast<uint32_t>(model.vertices.size()));
+        write(out, static_cast<uint32_t>(model.indices.size()));
+        write(out, static_cast<uint32_t>(model.submeshes.size()));
+        write(out, static_cast<uint32_t>(model.materials.size()));
+        write(out, static_cast<uint32_t>(model.bones.size()));
+        write(out, static_cast<uint32_t>(model.animations.size()));
+        write(out, static_cast<uint32_t>(imported.images.size()));
+        write(out, model.globalInverseTransform);
+
+        writeArray(out, model.vertices.data(), model.vertices.size());
+        writeArray(out, model.indices.data(), model.indices.size());
+
+        for (const SubMesh& mesh : model.submeshes) {
+            write(out, mesh.indexOffset);
+            write(out, mesh.indexCount);
+            write(out, mesh.vertexOffset);
+            write(out, mesh.materialIndex);
+            writeString(out, mesh.name);
+        }
+        for (const MaterialData& mat : model.materials) {
+            write(out, mat.baseColor);
+            write(out, mat.emissive);
+            write(out, mat.metallic);
+            write(out, mat.roughness);
+            write(out, mat.ao);
+            write(out, mat.albedoTexture);
+            write(out, mat.normalTexture);
+            write(out, mat.metallicRoughnessTexture);
+            write(out, mat.emissiveTexture);
+            writeString(out, mat.name);
+        }
+        for (const BoneInfo& bone : model.bones) {
+            write(out, bone.offset);
+            write(out, bone.parentIndex);
+            writeString(out, bone.name);
+        }
+        for (const Animation& anim : model.animations) {
+            writeString(out, anim.name);
+            write(out, anim.duration);
+            write(out, anim.ticksPerSecond);
+            write(out, static_cast<uint32_t>(anim.channels.size()));
+            for (const auto& channel : anim.channels) {
+                writeString(out, channel.nodeName);
+                writeKeys(out, channel.positions);
+                writeKeys(out, channel.rotations);
+                writeKeys(out, channel.scales);
+            }
+        }
+        for (size_t i = 0; i < imported.images.size(); i++) {
+            writeString(out, imageKeys[i]);
+            writeString(out, imported.images[i].path);
+        }
+
+        std::vector<uint8_t> collision;
+        if (model.collisionMesh) collision = model.collisionMesh->serialize();
+        write(out, static_cast<uint32_t>(collision.size()));
+        out.insert(out.end(), collision.begin(), collision.end());
+        return out;
+    }
+
+    // Image blob: width | height | RGBA8 pixels
+    static std::vector<uint8_t> cookImage(const DecodedImage& image) {
+        std::vector<uint8_t> out;
+        write(out, static_cast<uint32_t>(image.width));
+        write(out, static_cast<uint32_t>(image.height));
+        out.insert(out.end(), image.pixels.begin(), image.pixels.end());
+        return out;
+    }
+
+    static bool uncookImage(ScenePackage::DataView blob, DecodedImage& image) {
+        Cursor in{blob.data, blob.size};
+        uint32_t width = 0, height = 0;
+        if (!in.read(width) || !in.read(height)) return false;
+        if (in.left != size_t(width) * height * 4) return false;
+        image.width = static_cast<int>(width);
+        image.height = static_cast<int>(height);
+        image.pixels.assign(in.data, in.data + in.left);
+        return true;
+    }
+
+    // Fills everything but images' pixels; imageKeys lists what to fetch
+    static bool uncookModel(ScenePackage::DataView blob, ModelImport& out, std::vector<std::string>& imageKeys) {
+        Cursor in{blob.data, blob.size};
+        if (blob.size < 4 || std::memcmp(blob.data, "ZCMD", 4) != 0) return false;
+        in.skip(4);
+
+        uint32_t version = 0, stride = 0, vertexCount = 0, indexCount = 0, submeshCount = 0;
+        uint32_t materialCount = 0, boneCount = 0, animationCount = 0, imageCount = 0;
+        Model& model = out.model;
+        if (!in.read(version) || version != VERSION) return false;
+        if (!in.read(stride) || stride != sizeof(Vertex)) return false; // Cooked for another vertex layout
+        if (!in.read(vertexCount) || !in.read(indexCount) || !in.read(submeshCount) || !in.read(materialCount) ||
+            !in.read(boneCount) || !in.read(animationCount) || !in.read(imageCount) ||
+            !in.read(model.globalInverseTransform)) return false;
+
+        if (!in.readArray(model.vertices, vertexCount) || !in.readArray(model.indices, indexCount)) return false;
+        // Every remaining record takes at least a byte; reject counts before resizing
+        if (submeshCount > in.left || materialCount > in.left || boneCount > in.left ||
+            animationCount > in.left || imageCount > in.left) return false;
+
+        model.submeshes.resize(submeshCount);
+        for (SubMesh& mesh : model.submeshes) {
+            if (!in.read(mesh.indexOffset) || !in.read(mesh.indexCount) || !in.read(mesh.vertexOffset) ||
+                !in.read(mesh.materialIndex) || !in.readString(mesh.name)) return false;
+        }
+        model.materials.resize(materialCount);
+        for (MaterialData& mat : model.materials) {
+            if (!in.read(mat.baseColor) || !in.read(mat.emissive) || !in.read(mat.metallic) ||
+                !in.read(mat.roughness) || !in.read(mat.ao) || !in.read(mat.albedoTexture) ||
+                !in.read(mat.normalTexture) || !in.read(mat.metallicRoughnessTexture) ||
+                !in.read(mat.emissiveTexture) || !in.readString(mat.name)) return false;
+        }
+        model.bones.resize(boneCount);
+        for (size_t i = 0; i < model.bones.size(); i++) {
+            BoneInfo& bone = model.bones[i];
+            if (!in.read(bone.offset) || !in.read(bone.parentIndex) || !in.readString(bone.name)) return false;
+            bone.id = Name(bone.name);
+            model.boneMap[bone.id] = static_cast<int>(i);
+        }
+        model.animations.resize(animationCount);
+        for (Animation& anim : model.animations) {
+            uint32_t channelCount = 0;
+            if (!in.readString(anim.name) || !in.read(anim.duration) || !in.read(anim.ticksPerSecond) ||
+                !in.read(channelCount) || channelCount > in.left) return false;
+            anim.channels.resize(channelCount);
+            for (auto& channel : anim.channels) {
+                if (!in.readString(channel.nodeName) || !readKeys(in, channel.positions) ||
+                    !readKeys(in, channel.rotations) || !readKeys(in, channel.scales)) return false;
+                channel.node = Name(channel.nodeName);
+            }
+        }
+        model.linkChannels();
+
+        out.images.resize(imageCount);
+        imageKeys.resize(imageCount);
+        for (uint32_t i = 0; i < imageCount; i++) {
+            if (!in.readString(imageKeys[i]) || !in.readString(out.images[i].path)) return false;
+        }
+
+        uint32_t collisionSize = 0;
+        if (!in.read(collisionSize) || collisionSize > in.left) return false;
+        if (collisionSize) {
+            model.collisionMesh = TriangleMeshShape::deserialize(in.data, collisionSize);
+            if (!model.collisionMesh) return false;
+        }
+        return validRanges(model, imageCount);
+    }
+
+private:
+    // Every index the renderer and animator will follow stays inside the
+    // decoded arrays (a blob can be stale or cooked from another build)
+    static bool validRanges(const Model& model, uint32_t imageCount) {
+        size_t vertexCount = model.vertices.size();
+        size_t materialCount = model.materials.size();
+        int boneCount = static_cast<int>(model.bones.size());
+
+        for (uint32_t index : model.indices) {
+            if (index >= vertexCount) return false;
+        }
+        // Only weighted slots are read; the loader leaves id 0 in unweighted
+        // vertices even on models without bones
+        for (const Vertex& v : model.vertices) {
+            for (int i = 0; i < 4; i++) {
+                if (v.boneWeights[i] != 0.0f && (v.boneIds[i] < 0 || v.boneIds[i] >= boneCount)) return false;
+            }
+        }
+        for (const SubMesh& mesh : model.submeshes) {
+            if (uint64_t(mesh.indexOffset) + mesh.indexCount > model.indices.size()) return false;
+            if (mesh.vertexOffset > vertexCount) return false;
+            if (materialCount ? mesh.materialIndex >= materialCount : mesh.materialIndex != 0) return false;
+        }
+        auto validTexture = [imageCount](int texture) { return texture >= -1 && texture < int64_t(imageCount); };
+        for (const MaterialData& mat : model.materials) {
+            if (!validTexture(mat.albedoTexture) || !validTexture(mat.normalTexture) ||
+                !validTexture(mat.metallicRoughnessTexture) || !validTexture(mat.emissiveTexture)) return false;
+        }
+        for (const BoneInfo& bone : model.bones) {
+            if (bone.parentIndex < -1 || bone.parentIndex >= boneCount) return false;
+        }
+        return true;
+    }
+
+    // Bounds-checked reads over a blob
+    struct Cursor {
+        const uint8_t* data;
+        size_t left;
+
+        void skip(size_t bytes) {
+            data += bytes;
+            left -= bytes;
+        }
+
+        template<typename T>
+        bool read(T& value) {
+            if (left < sizeof(T)) return false;
+            std::memcpy(&value, data, sizeof(T));
+            skip(sizeof(T));
+            return true;
+        }
+
+        template<typename T>
+        bool readArray(std::vector<T>& values, uint32_t count) {
+            if (left / sizeof(T) < count) return false;
+            values.resize(count);
+            std::memcpy(values.data(), data, count * sizeof(T));
+            skip(count * sizeof(T));
+            return true;
+        }
+
+        bool readString(std::string& value) {
+            uint16_t length = 0;
+            if (!read(length) || left < length) return false;
+            value.assign(reinterpret_cast<const char*>(data), length);
+            skip(length);
+            return true;
+        }
+    };
+
+    template<typename T>
+    static void write(std::vector<uint8_t>& out, const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Cooked fields must be trivially copyable");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    static void writeArray(std::vector<uint8_t>& out, const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Cooked arrays must be trivially copyable");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values);
+        out.insert(out.end(), bytes, bytes + count * sizeof(T));
+    }
+
+    static void writeString(std::vector<uint8_t>& out, const std::string& value) {
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+        write(out, length);
+        out.insert(out.end(), value.begin(), value.begin() + length);
+    }
+
+    // Animation keys as (time, value) pairs
+    template<typename V>
+    static void writeKeys(std::vector<uint8_t>& out, const std::vector<std::pair<float, V>>& keys) {
+        write(out, static_cast<uint32_t>(keys.size()));
+        for (const auto& key : keys) {
+            write(out, key.first);
+            write(out, key.second);
+        }
+    }
+
+    template<typename V>
+    static bool readKeys(Cursor& in, std::vector<std::pair<float, V>>& keys) {
+        uint32_t count = 0;
+        if (!in.read(count) || in.left / (sizeof(float) + sizeof(V)) < count) return false;
+        keys.resize(count);
+        for (auto& key : keys) {
+            in.read(key.first);
+            in.read(key.second);
+        }
+        return true;
+    }
+};
+
+// Adds cooked models (and their images) to a scene snapshot, once per content
+class AssetBundleWriter {
+public:
+    explicit AssetBundleWriter(ScenePackaging::SceneSnapshot& snapshot) : snapshot(snapshot) {}
+
+    // Import path with loader and cook it into the bundle
+    bool addModel(ModelLoader& loader, const std::string& path) {
+        if (path.empty() || manifest.count(path)) return true;
+        ModelImport imported;
+        if (!loader.import(path, imported) || !imported.valid()) {
+            std::cerr << "  ✗ Not bundled (import failed): " << path << std::endl;
+            return false;
+        }
+        addImported(path, imported);
+        return true;
+    }
+
+    // Cook an import the caller already has, served later for path
+    void addImported(const std::string& path, const ModelImport& imported) {
+        std::vector<std::string> imageKeys;
+        for (const DecodedImage& image : imported.images) {
+            imageKeys.push_back(addContent(ModelCooker::cookImage(image), ScenePackage::ResourceType::CookedTexture));
+        }
+        manifest[path] = addContent(ModelCooker::cookModel(imported, imageKeys), ScenePackage::ResourceType::CookedModel);
+
+        auto& files = textures[path];
+        for (const DecodedImage& image : imported.images) {
+            if (!image.path.empty()) files.push_back({image.path, uint64_t(image.width) * image.height * 4});
+        }
+    }
+
+    // Snapshot the scene, bundle every model it references, and write it
+    static bool saveScene(ECS* ecs, ModelLoader& loader, const std::string& filepath,
+                          const std::string& sceneName = "Untitled",
+                          ScenePackage::CompressionType compression = ScenePackage::CompressionType::LZ4) {
+        ScenePackaging::SceneSnapshot snapshot = ScenePackaging::ScenePackager::snapshotScene(ecs, sceneName);
+        AssetBundleWriter bundle(snapshot);
+        bundle.addSceneModels(ecs, loader);
+        bundle.finish();
+        return ScenePackaging::ScenePackager::writeSnapshot(std::move(snapshot), filepath, compression);
+    }
+
+    // Every model referenced by the scene's ModelComponents
+    void addSceneModels(ECS* ecs, ModelLoader& loader) {
+        std::vector<std::string> paths;
+        ecs->each<ModelComponent>([&](EntityID, ModelComponent& mc) { paths.push_back(mc.modelPath); });
+        for (const std::string& path : paths) addModel(loader, path);
+    }
+
+    // Write the manifest; call once, after the last addModel()
+    void finish() {
+        std::vector<uint8_t> data;
+        auto writeString = [&](const std::string& s) {
+            uint16_t length = static_cast<uint16_t>(s.size());
+            data.insert(data.end(), reinterpret_cast<const uint8_t*>(&length), reinterpret_cast<const uint8_t*>(&length) + 2);
+            data.insert(data.end(), s.begin(), s.end());
+        };
+        uint32_t count = static_cast<uint32_t>(manifest.size());
+        data.insert(data.end(), reinterpret_cast<const uint8_t*>(&count), reinterpret_cast<const uint8_t*>(&count) + 4);
+        for (const auto& entry : manifest) {
+            writeString(entry.first);
+            writeString(entry.second);
+        }
+        snapshot.resources.push_back({"bundle/manifest", "bundle/manifest.bin",
+                                      ScenePackage::ResourceType::AssetManifest, std::move(data)});
+
+        // The imports show which textures each model reads
+        AssetGraph graph;
+        if (ScenePackaging::ScenePackager::loadAssetGraph(snapshot, graph)) {
+            for (const auto& entry : textures) graph.setTextures(entry.first, entry.second);
+            ScenePackaging::ScenePackager::storeAssetGraph(snapshot, graph);
+        }
+
+        std::cout << "  Bundled: " << manifest.size() << " models, " << blobCount << " unique blobs ("
+                  << bundledBytes / 1024.0f << " KB, " << dedupedBytes / 1024.0f << " KB shared)" << std::endl;
+    }
+
+private:
+    ScenePackaging::SceneSnapshot& snapshot;
+    std::map<std::string, std::string> manifest;    // Source path -> content key
+    std::map<std::string, std::vector<std::pair<std::string, uint64_t>>> textures; // Source path -> texture files
+    std::unordered_set<std::string> stored;
+    size_t blobCount = 0;
+    size_t bundledBytes = 0;
+    size_t dedupedBytes = 0;
+
+    // Store blob under its content key unless an identical one already is
+    std::string addContent(std::vector<uint8_t> blob, ScenePackage::ResourceType type) {
+        std::string key = ScenePackage::hashContent(blob.data(), blob.size()).toString();
+        if (!stored.insert(key).second) {
+            dedupedBytes += blob.size();
+            return key;
+        }
+        blobCount++;
+        bundledBytes += blob.size();
+        snapshot.resources.push_back({"asset/" + key, "asset/" + key, type, std::move(blob)});
+        return key;
+    }
+};
+
+// Read side: imports served from a mapped package
+class AssetBundle {
+public:
+    // Read the manifest of an open package; false when it carries no bundle
+    bool attach(const ScenePackage::MappedPackageReader& reader) {
+        this->reader = nullptr;
+        manifest.clear();
+
+        int index = reader.findResource("bundle/manifest");
+        if (index < 0) return false;
+        std::vector<uint8_t> storage;
+        ScenePackage::DataView view = ScenePackaging::ScenePackager::resourceBytes(reader, index, storage);
+
+        size_t offset = 0;
+        auto readString = [&](std::string& s) {
+            uint16_t length = 0;
+            if (view.size - offset < 2) return false;
+            std::memcpy(&length, view.data + offset, 2);
+            offset += 2;
+            if (view.size - offset < length) return false;
+            s.assign(reinterpret_cast<const char*>(view.data + offset), length);
+            offset += length;
+            return true;
+        };
+        uint32_t count = 0;
+        if (view.size < 4) return false;
+        std::memcpy(&count, view.data, 4);
+        offset = 4;
+        for (uint32_t i = 0; i < count; i++) {
+            std::string path, key;
+            if (!readString(path) || !readString(key)) {
+                manifest.clear();
+                return false;
+            }
+            manifest[path] = key;
+        }
+        this->reader = &reader;
+        return true;
+    }
+
+    void detach() {
+        reader = nullptr;
+        manifest.clear();
+    }
+
+    bool contains(const std::string& path) const { return reader && manifest.count(path); }
+    size_t modelCount() const { return manifest.size(); }
+
+    // Same result as ModelLoader::import(path) at cook time; any thread
+    bool importModel(const std::string& path, ModelImport& out) const {
+        auto found = manifest.find(path);
+        if (!reader || found == manifest.end()) return false;
+
+        std::vector<uint8_t> storage;
+        ScenePackage::DataView blob = fetch(found->second, storage);
+        std::vector<std::string> imageKeys;
+        out = ModelImport{};
+        out.path = path;
+        if (!blob.data || !ModelCooker::uncookModel(blob, out, imageKeys)) {
+            std::cerr << "✗ Corrupt bundled model: " << path << std::endl;
+            out = ModelImport{};
+            return false;
+        }
+        for (size_t i = 0; i < imageKeys.size(); i++) {
+            ScenePackage::DataView pixels = fetch(imageKeys[i], storage);
+            if (!pixels.data || !ModelCooker::uncookImage(pixels, out.images[i])) {
+                std::cerr << "✗ Corrupt bundled texture in " << path << std::endl;
+                out = ModelImport{};
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const ScenePackage::MappedPackageReader* reader = nullptr;
+    std::unordered_map<std::string, std::string> manifest;
+
+    ScenePackage::DataView fetch(const std::string& key, std::vector<uint8_t>& storage) const {
+        return ScenePackaging::ScenePackager::resourceBytes(*reader, reader->findResource("asset/" + key), storage);
+    }
+};
@@ -0,0 +1,314 @@
+#pragma once
+#include "ScenePackage.h"
+#include "Engine.h"
+#include "transform.h"
+#include "ModelComponent.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+
+// Asset dependency graph
+//
+// Recorded when a scene is saved, so a loader knows everything the scene
+// needs before decoding any of it. Roots are the scene ("scene") or world
+// cells ("cell/<x>_<z>", "cell/global"); each lists the models its
+// entities use, with the instance count and the bounds of their world
+// positions. Models list the texture files they read. Animations live in
+// the model file in this engine, so they come with their model.
+//
+// plan() orders a root's models for loading from a focus point (usually
+// the camera): nearest first, and at similar distances widely instanced
+// models before one-offs. Stored in packages as "assets/graph".
+
+enum class AssetKind : uint8_t { Model = 0, Texture = 1 };
+
+class AssetGraph {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+    static constexpr uint32_t USE_UNPLACED = 1u << 0;  // Some instances have no Transform
+    static constexpr const char* RESOURCE_NAME = "assets/graph";
+
+    struct Asset {
+        std::string path;
+        AssetKind kind = AssetKind::Model;
+        uint64_t bytes = 0;                 // Estimated load size, 0 = unknown
+        std::vector<uint32_t> dependencies; // Asset indices
+    };
+
+    // One model as used by a root
+    struct Use {
+        uint32_t asset = 0;
+        uint32_t instances = 0;
+        uint32_t flags = 0;
+        glm::vec3 boundsMin{std::numeric_limits<float>::max()};
+        glm::vec3 boundsMax{-std::numeric_limits<float>::max()};
+    };
+
+    struct Root {
+        std::string name;
+        std::vector<Use> uses;
+    };
+
+    // A model to load; plan() returns these best first
+    struct PlanEntry {
+        uint32_t asset = 0;
+        uint32_t instances = 0;
+        float distance = 0.0f;      // From the focus to the nearest instance bounds
+        float score = 0.0f;         // Lower loads sooner
+    };
+
+    // === Recording ===
+
+    uint32_t addAsset(const std::string& path, AssetKind kind) {
+        auto found = index.find(path);
+        if (found != index.end()) return found->second;
+        uint32_t id = static_cast<uint32_t>(assets.size());
+        assets.push_back({path, kind, 0, {}});
+        index[path] = id;
+        return id;
+    }
+
+    void addDependency(uint32_t from, uint32_t to) {
+        auto& deps = assets[from].dependencies;
+        if (from != to && std::find(deps.begin(), deps.end(), to) == deps.end()) deps.push_back(to);
+    }
+
+    // Root listing the models of ids, replacing any root of the same name.
+    // Model sizes come from the VFS when the files are mounted.
+    void addRoot(const std::string& name, ECS* ecs, const std::vector<EntityID>& ids) {
+        Root root;
+        root.name = name;
+        std::unordered_map<uint32_t, size_t> useOf;
+        for (EntityID e : ids) {
+            auto* mc = ecs->getComponent<ModelComponent>(e);
+            if (!mc || mc->modelPath.empty()) continue;
+
+            bool added = index.find(mc->modelPath) == index.end();
+            uint32_t model = addAsset(mc->modelPath, AssetKind::Model);
+            if (added) assets[model].bytes = fileSize(mc->modelPath);
+
+            auto slot = useOf.emplace(model, root.uses.size());
+            if (slot.second) {
+                root.uses.emplace_back();
+                root.uses.back().asset = model;
+            }
+            Use& use = root.uses[slot.first->second];
+            use.instances++;
+
+            auto* t = ecs->getComponent<Transform>(e);
+            if (!t) {
+                use.flags |= USE_UNPLACED;
+                continue;
+            }
+            glm::vec3 p = t->getWorldPosition(ecs);
+            use.boundsMin = glm::min(use.boundsMin, p);
+            use.boundsMax = glm::max(use.boundsMax, p);
+        }
+
+        for (Root& existing : roots) {
+            if (existing.name == name) {
+                existing = std::move(root);
+                return;
+            }
+        }
+        roots.push_back(std::move(root));
+    }
+
+    // Texture edges of a model (path, estimated bytes; 0 = ask the VFS)
+    void setTextures(const std::string& modelPath, const std::vector<std::pair<std::string, uint64_t>>& textures) {
+        uint32_t model = addAsset(modelPath, AssetKind::Model);
+        for (const auto& texture : textures) {
+            uint32_t id = addAsset(texture.first, AssetKind::Texture);
+            assets[id].bytes = texture.second ? texture.second : fileSize(texture.first);
+            addDependency(model, id);
+        }
+    }
+
+    // Record the texture files of every model that has none yet, by
+    // parsing its materials (no mesh processing or decoding)
+    void scanModels(ModelLoader& loader) {
+        for (uint32_t i = 0; i < assets.size(); i++) {
+            if (assets[i].kind != AssetKind::Model || !assets[i].dependencies.empty()) continue;
+            std::vector<std::string> paths;
+            if (!loader.dependencies(assets[i].path, paths)) continue;
+            std::vector<std::pair<std::string, uint64_t>> textures;
+            for (const std::string& path : paths) textures.push_back({path, 0});
+            setTextures(assets[i].path, textures);
+        }
+    }
+
+    // === Queries ===
+
+    bool empty() const { return roots.empty(); }
+    size_t assetCount() const { return assets.size(); }
+    const Asset& asset(uint32_t id) const { return assets[id]; }
+    const std::vector<Root>& getRoots() const { return roots; }
+
+    uint32_t find(const std::string& path) const {
+        auto found = index.find(path);
+        return found == index.end() ? NONE : found->second;
+    }
+
+    const Root* findRoot(const std::string& name) const {
+        for (const Root& root : roots) {
+            if (root.name == name) return &root;
+        }
+        return nullptr;
+    }
+
+    // Bytes of an asset and everything it depends on
+    uint64_t totalBytes(uint32_t id) const {
+        uint64_t bytes = assets[id].bytes;
+        for (uint32_t dep : assets[id].dependencies) bytes += assets[dep].bytes;
+        return bytes;
+    }
+
+    // A root's models in load order from focus. Distance is to the box
+    // around the model's instances (0 inside it or for unplaced ones) and is
+    // divided by 1 + log2(instances).
+    std::vector<PlanEntry> plan(const std::string& rootName, const glm::vec3& focus) const {
+        std::vector<PlanEntry> entries;
+        const Root* root = findRoot(rootName);
+        if (!root) return entries;
+
+        entries.reserve(root->uses.size());
+        for (const Use& use : root->uses) {
+            PlanEntry entry;
+            entry.asset = use.asset;
+            entry.instances = use.instances;
+            if (!(use.flags & USE_UNPLACED) && use.boundsMin.x <= use.boundsMax.x) {
+                glm::vec3 d = glm::max(glm::max(use.boundsMin - focus, glm::vec3(0.0f)), focus - use.boundsMax);
+                entry.distance = glm::length(d);
+            }
+            entry.score = entry.distance / (1.0f + std::log2(float(std::max(use.instances, 1u))));
+            entries.push_back(entry);
+        }
+        std::sort(entries.begin(), entries.end(), [](const PlanEntry& a, const PlanEntry& b) {
+            if (a.score != b.score) return a.score < b.score;
+            if (a.instances != b.instances) return a.instances > b.instances;
+            return a.asset < b.asset;
+        });
+        return entries;
+    }
+
+    // === Storage ===
+    //
+    // Layout: version | assetCount | rootCount |
+    //         assets {kind u8 | bytes u64 | path | depCount | deps[]} |
+    //         roots {name | useCount | uses {asset | instances | flags | min | max}}
+    // Strings are u16 length + chars.
+
+    std::vector<uint8_t> serialize() const {
+        std::vector<uint8_t> out;
+        write(out, VERSION);
+        write(out, static_cast<uint32_t>(assets.size()));
+        write(out, static_cast<uint32_t>(roots.size()));
+        for (const Asset& a : assets) {
+            write(out, static_cast<uint8_t>(a.kind));
+            write(out, a.bytes);
+            writeString(out, a.path);
+            write(out, static_cast<uint32_t>(a.dependencies.size()));
+            for (uint32_t dep : a.dependencies) write(out, dep);
+        }
+        for (const Root& root : roots) {
+            writeString(out, root.name);
+            write(out, static_cast<uint32_t>(root.uses.size()));
+            for (const Use& use : root.uses) {
+                write(out, use.asset);
+                write(out, use.instances);
+                write(out, use.flags);
+                write(out, use.boundsMin);
+                write(out, use.boundsMax);
+            }
+        }
+        return out;
+    }
+
+    // False (and left empty) if blob is corrupt or from a newer version
+    bool deserialize(ScenePackage::DataView blob) {
+        clear();
+        const uint8_t* data = blob.data;
+        size_t left = blob.size;
+        auto read = [&](auto& value) {
+            if (left < sizeof(value)) return false;
+            std::memcpy(&value, data, sizeof(value));
+            data += sizeof(value);
+            left -= sizeof(value);
+            return true;
+        };
+        auto readString = [&](std::string& s) {
+            uint16_t length = 0;
+            if (!read(length) || left < length) return false;
+            s.assign(reinterpret_cast<const char*>(data), length);
+            data += length;
+            left -= length;
+            return true;
+        };
+
+        uint32_t version = 0, assetCount = 0, rootCount = 0;
+        if (!read(version) || version != VERSION || !read(assetCount) || !read(rootCount) ||
+            assetCount > left || rootCount > left) return false;
+
+        assets.resize(assetCount);
+        for (uint32_t i = 0; i < assetCount; i++) {
+            Asset& a = assets[i];
+            uint8_t kind = 0;
+            uint32_t depCount = 0;
+            if (!read(kind) || kind > uint8_t(AssetKind::Texture) || !read(a.bytes) || !readString(a.path) ||
+                !read(depCount) || depCount > left / sizeof(uint32_t)) return fail();
+            a.kind = static_cast<AssetKind>(kind);
+            a.dependencies.resize(depCount);
+            for (uint32_t& dep : a.dependencies) {
+                if (!read(dep) || dep >= assetCount) return fail();
+            }
+            index[a.path] = i;
+        }
+
+        roots.resize(rootCount);
+        for (Root& root : roots) {
+            uint32_t useCount = 0;
+            if (!readString(root.name) || !read(useCount) || useCount > left) return fail();
+            root.uses.resize(useCount);
+            for (Use& use : root.uses) {
+                if (!read(use.asset) || use.asset >= assetCount || !read(use.instances) || !read(use.flags) ||
+                    !read(use.boundsMin) || !read(use.boundsMax)) return fail();
+            }
+        }
+        return left == 0 || fail();
+    }
+
+    void clear() {
+        assets.clear();
+        roots.clear();
+        index.clear();
+    }
+
+private:
+    std::vector<Asset> assets;
+    std::vector<Root> roots;
+    std::unordered_map<std::string, uint32_t> index;
+
+    bool fail() {
+        clear();
+        return false;
+    }
+
+    static uint64_t fileSize(const std::string& path) {
+        VFS::FileInfo info;
+        return VFS::FileSystem::get().stat(path, info) ? info.size : 0;
+    }
+
+    template<typename T>
+    static void write(std::vector<uint8_t>& out, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    static void writeString(std::vector<uint8_t>& out, const std::string& value) {
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+        write(out, length);
+        out.insert(out.end(), value.begin(), value.begin() + length);
+    }
+};
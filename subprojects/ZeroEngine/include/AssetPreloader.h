@@ -0,0 +1,251 @@
+#pragma once
+#include "AssetBundle.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <unordered_set>
+
+// Preloading from the asset dependency graph (AssetGraph.h)
+//
+// preload() queues the models a scene or world cell needs, ordered by
+// AssetGraph::plan() from a focus point, and worker threads import them:
+// the cooked copy when the package bundles it, otherwise ModelLoader,
+// which reads all of a model's textures in one batch. Every preload()
+// feeds one priority queue, so a cell next to the camera requested late
+// still goes ahead of a far one requested early. Readiness is tracked
+// per asset and summed per root, for load screens; SceneLoadPipeline
+// takes the finished imports instead of importing again.
+
+struct PreloadProgress {
+    size_t assetsReady = 0;     // Models imported (or failed) and their textures
+    size_t assetCount = 0;
+    uint64_t bytesReady = 0;
+    uint64_t byteCount = 0;
+    size_t failed = 0;          // Models
+
+    bool done() const { return assetsReady == assetCount; }
+
+    float fraction() const {
+        if (byteCount) return float(double(bytesReady) / double(byteCount));
+        return assetCount ? float(assetsReady) / float(assetCount) : 1.0f;
+    }
+};
+
+class AssetPreloader {
+public:
+    explicit AssetPreloader(ModelLoader& loader, unsigned threads = 0) : loader(loader) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+        for (unsigned i = 0; i < threads; i++) workers.emplace_back([this] { run(); });
+    }
+
+    AssetPreloader(const AssetPreloader&) = delete;
+    AssetPreloader& operator=(const AssetPreloader&) = delete;
+
+    // Imports in progress finish first
+    ~AssetPreloader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    // Use the graph and bundle of an open package (which must stay open
+    // while preloading). False when the package has no asset graph.
+    // Waits for imports in flight, so a previous package can be closed
+    // once this returns.
+    bool attach(const ScenePackage::MappedPackageReader& reader) {
+        AssetGraph graph;
+        if (!ScenePackaging::ScenePackager::loadAssetGraph(reader, graph)) return false;
+        std::unique_lock<std::mutex> lock(mutex);
+        drainLocked(lock);
+        this->graph = std::move(graph);
+        slots.assign(this->graph.assetCount(), Slot{});
+        bundle.attach(reader);
+        return true;
+    }
+
+    // Use a graph built or loaded elsewhere; models import from files.
+    // Waits for imports in flight, like attach().
+    void setGraph(AssetGraph graph) {
+        std::unique_lock<std::mutex> lock(mutex);
+        drainLocked(lock);
+        bundle.detach();
+        this->graph = std::move(graph);
+        slots.assign(this->graph.assetCount(), Slot{});
+    }
+
+    // Queue root's models, best first from focus. Models already queued
+    // move up if this ranks them higher. False if the graph has no such root.
+    bool preload(const std::string& root, const glm::vec3& focus) {
+        std::vector<AssetGraph::PlanEntry> plan;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!graph.findRoot(root)) return false;
+            plan = graph.plan(root, focus);
+            for (const AssetGraph::PlanEntry& entry : plan) {
+                Slot& slot = slots[entry.asset];
+                if (slot.state == State::Idle || (slot.state == State::Queued && entry.score < slot.score)) {
+                    slot.state = State::Queued;
+                    slot.score = entry.score;
+                    queue.push({entry.score, nextOrder++, entry.asset});
+                }
+            }
+        }
+        workAvailable.notify_all();
+        return true;
+    }
+
+    PreloadProgress progress(const std::string& root) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return progressLocked(graph.findRoot(root));
+    }
+
+    // False for roots the graph doesn't have
+    bool isReady(const std::string& root) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        const AssetGraph::Root* found = graph.findRoot(root);
+        return found && progressLocked(found).done();
+    }
+
+    // The import of a preloaded model, waiting while it's queued or being
+    // imported. Failed imports come back !valid(); nullptr means the model
+    // was never requested (or clear() dropped it).
+    std::shared_ptr<ModelImport> acquire(const std::string& path) {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint32_t asset = graph.find(path);
+        if (asset == AssetGraph::NONE) return nullptr;
+        if (slots[asset].state == State::Queued) {
+            slots[asset].score = -1.0f; // Someone is waiting; ahead of everything
+            queue.push({-1.0f, nextOrder++, asset});
+            workAvailable.notify_one();
+        }
+        uint64_t started = generation;
+        importDone.wait(lock, [&] {
+            return generation != started ||
+                   (slots[asset].state != State::Queued && slots[asset].state != State::Loading);
+        });
+        return generation == started ? slots[asset].imported : nullptr;
+    }
+
+    // Drop finished imports and anything still queued; imports in
+    // progress finish but are discarded
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        resetLocked();
+        slots.assign(graph.assetCount(), Slot{});
+    }
+
+    const AssetGraph& getGraph() const { return graph; }
+
+private:
+    enum class State : uint8_t { Idle, Queued, Loading, Ready, Failed };
+
+    struct Slot {
+        State state = State::Idle;
+        float score = 0.0f;
+        std::shared_ptr<ModelImport> imported;
+    };
+
+    // Lowest score first, then request order. Entries whose slot moved on
+    // (requeued with a better score, or already imported) are skipped.
+    struct Pending {
+        float score;
+        uint64_t order;
+        uint32_t asset;
+        bool operator<(const Pending& other) const {
+            if (score != other.score) return score > other.score;
+            return order > other.order;
+        }
+    };
+
+    ModelLoader& loader;
+    AssetBundle bundle;
+    AssetGraph graph;
+    std::vector<Slot> slots;
+    std::priority_queue<Pending> queue;
+    uint64_t nextOrder = 0;
+    uint64_t generation = 0;            // Bumped by clear(), so stale imports are dropped
+    size_t importing = 0;               // Workers reading bundle with the lock released
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable importDone;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    PreloadProgress progressLocked(const AssetGraph::Root* root) const {
+        PreloadProgress progress;
+        if (!root) return progress;
+
+        std::unordered_set<uint32_t> counted;
+        auto add = [&](uint32_t asset, bool ready) {
+            if (!counted.insert(asset).second) return;
+            uint64_t bytes = graph.asset(asset).bytes;
+            progress.assetCount++;
+            progress.byteCount += bytes;
+            if (ready) {
+                progress.assetsReady++;
+                progress.bytesReady += bytes;
+            }
+        };
+        for (const AssetGraph::Use& use : root->uses) {
+            State state = slots[use.asset].state;
+            bool ready = state == State::Ready || state == State::Failed;
+            if (state == State::Failed) progress.failed++;
+            add(use.asset, ready);
+            for (uint32_t dep : graph.asset(use.asset).dependencies) add(dep, ready);
+        }
+        return progress;
+    }
+
+    void resetLocked() {
+        queue = {};
+        generation++;
+        importDone.notify_all();
+    }
+
+    // Reset, then wait until no worker is reading bundle so it can change
+    void drainLocked(std::unique_lock<std::mutex>& lock) {
+        resetLocked();
+        importDone.wait(lock, [&] { return importing == 0; });
+        queue = {}; // preload() calls made while waiting were for the old graph
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            workAvailable.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (stopping) return;
+
+            Pending next = queue.top();
+            queue.pop();
+            Slot& slot = slots[next.asset];
+            if (slot.state != State::Queued || next.score != slot.score) continue;
+
+            slot.state = State::Loading;
+            std::string path = graph.asset(next.asset).path;
+            uint64_t started = generation;
+            importing++;
+            lock.unlock();
+
+            auto imported = std::make_shared<ModelImport>();
+            if (!bundle.importModel(path, *imported)) {
+                loader.import(path, *imported); // Failures come through as !valid()
+            }
+
+            lock.lock();
+            importing--;
+            if (generation != started) {
+                importDone.notify_all();
+                continue;
+            }
+            Slot& done = slots[next.asset];
+            done.imported = std::move(imported);
+            done.state = done.imported->valid() ? State::Ready : State::Failed;
+            importDone.notify_all();
+        }
+    }
+};
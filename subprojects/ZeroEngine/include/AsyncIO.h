@@ -0,0 +1,785 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#else
+#include <filesystem>
+#endif
+
+#ifdef USE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+// Asynchronous file reads
+//
+// One process-wide Service reads files for every loader. Requests are
+// split into 1 MB chunks that run in parallel, on io_uring when the
+// kernel allows it (one thread keeps up to 64 reads in flight) and on a
+// small pread() thread pool otherwise. Higher priorities are served
+// first, chunk by chunk, so a texture the camera needs isn't stuck
+// behind a streaming package read. direct reads bypass the page cache
+// (O_DIRECT) and are meant for large files read once, like scene
+// packages; they fall back to buffered I/O where the filesystem can't.
+//
+// Completion callbacks run on an I/O thread and should be short; use a
+// Ticket to wait for a result instead.
+namespace AsyncIO {
+
+enum class Priority : uint8_t { Low, Normal, High };
+enum class Status : uint8_t { Done, Failed, Cancelled };
+
+using RequestID = uint64_t;
+
+// Bytes of a completed read. Direct reads land in a block-aligned
+// allocation that may start before the requested offset; data() skips it.
+class Buffer {
+public:
+    // Uninitialized storage for bytes that come from somewhere else (a
+    // package, a decoder) but are handed out like a read
+    static Buffer allocate(size_t size) {
+        Buffer buffer;
+        buffer.memory.reset(static_cast<uint8_t*>(std::malloc(std::max<size_t>(size, 1))));
+        buffer.length = buffer.memory ? size : 0;
+        return buffer;
+    }
+
+    const uint8_t* data() const { return memory ? memory.get() + start : nullptr; }
+    uint8_t* data() { return memory ? memory.get() + start : nullptr; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    std::vector<uint8_t> toVector() const {
+        return length ? std::vector<uint8_t>(data(), data() + length) : std::vector<uint8_t>();
+    }
+
+private:
+    struct Free { void operator()(uint8_t* p) const { std::free(p); } };
+    std::unique_ptr<uint8_t, Free> memory;
+    size_t start = 0;
+    size_t length = 0;
+
+    friend class Service;
+};
+
+struct ReadRequest {
+    std::string path;
+    uint64_t offset = 0;
+    uint64_t size = 0;                  // 0 = to the end of the file
+    Priority priority = Priority::Normal;
+    bool direct = false;                // Bypass the page cache
+};
+
+struct ReadResult {
+    Status status = Status::Failed;
+    Buffer buffer;
+    int error = 0;                      // errno of the first failure
+
+    bool ok() const { return status == Status::Done; }
+};
+
+using Completion = std::function<void(RequestID, ReadResult&)>;
+
+struct IOStats {
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t cancelled = 0;
+    uint64_t bytesRead = 0;
+};
+
+// A read submitted without a callback; wait() for its result
+class Ticket {
+public:
+    // A ticket that is already complete, for results that needed no I/O
+    static Ticket completed(ReadResult result) {
+        Ticket ticket;
+        ticket.state = std::make_shared<State>();
+        ticket.state->result = std::move(result);
+        ticket.state->done = true;
+        return ticket;
+    }
+
+    RequestID id() const { return requestId; }
+    bool valid() const { return state != nullptr; }
+
+    bool ready() const {
+        if (!state) return false;
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->done;
+    }
+
+    // The result lives as long as the ticket
+    ReadResult& wait() {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&] { return state->done; });
+        return state->result;
+    }
+
+    bool cancel();
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;
+        ReadResult result;
+    };
+    std::shared_ptr<State> state;
+    RequestID requestId = 0;
+
+    friend class Service;
+};
+
+class Service {
+public:
+    static constexpr size_t CHUNK_SIZE = 1 << 20;
+    static constexpr size_t DIRECT_ALIGNMENT = 4096;
+    static constexpr size_t DIRECT_MIN_BYTES = 1 << 20;    // Smaller reads stay buffered
+    static constexpr unsigned RING_DEPTH = 64;
+
+    static Service& get() {
+        static Service service;
+        return service;
+    }
+
+    Service(const Service&) = delete;
+    Service& operator=(const Service&) = delete;
+
+    ~Service() {
+        std::vector<std::shared_ptr<Op>> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            for (auto& queue : waiting) {
+                dropped.insert(dropped.end(), queue.begin(), queue.end());
+                queue.clear();
+            }
+        }
+        workAvailable.notify_all();
+        for (auto& op : dropped) {
+            op->cancelled = true;
+            complete(op);
+        }
+        for (auto& thread : threads) thread.join();
+        #ifdef USE_IO_URING
+        ring.close();
+        #endif
+    }
+
+    RequestID read(const ReadRequest& request, Completion onComplete) {
+        return readBatch({request}, std::move(onComplete)).front();
+    }
+
+    // Queue several reads at once; they're picked up together, so a batch
+    // of small files goes to the kernel in one submission
+    std::vector<RequestID> readBatch(const std::vector<ReadRequest>& requests, const Completion& onComplete) {
+        return enqueue(requests, std::vector<Completion>(requests.size(), onComplete));
+    }
+
+    Ticket submit(const ReadRequest& request) {
+        return std::move(submitBatch({request}).front());
+    }
+
+    std::vector<Ticket> submitBatch(const std::vector<ReadRequest>& requests) {
+        std::vector<Ticket> tickets(requests.size());
+        std::vector<Completion> completions;
+        for (auto& ticket : tickets) {
+            auto state = std::make_shared<Ticket::State>();
+            ticket.state = state;
+            completions.push_back([state](RequestID, ReadResult& result) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->result = std::move(result);
+                state->done = true;
+                state->finished.notify_all();
+            });
+        }
+        std::vector<RequestID> ids = enqueue(requests, std::move(completions));
+        for (size_t i = 0; i < tickets.size(); i++) tickets[i].requestId = ids[i];
+        return tickets;
+    }
+
+    // Stop a read. Queued reads never start; chunks already in flight
+    // finish and are discarded. The completion still runs, with Cancelled.
+    // False if the read already completed.
+    bool cancel(RequestID id) {
+        std::shared_ptr<Op> finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = ops.find(id);
+            if (found == ops.end()) return false;
+            std::shared_ptr<Op> op = found->second;
+            op->cancelled = true;
+
+            auto& queue = op->state == OpState::Waiting ? waiting[static_cast<int>(op->request.priority)]
+                                                        : active[static_cast<int>(op->request.priority)];
+            switch (op->state) {
+                case OpState::Waiting:
+                    queue.erase(std::find(queue.begin(), queue.end(), op));
+                    finished = op;
+                    break;
+                case OpState::Active: {
+                    queue.erase(std::find(queue.begin(), queue.end(), op));
+                    uint32_t unclaimed = op->chunkCount - op->nextChunk;
+                    op->nextChunk = op->chunkCount;
+                    op->state = OpState::Draining;
+                    if (op->chunksLeft.fetch_sub(unclaimed) == unclaimed) finished = op;
+                    break;
+                }
+                case OpState::Preparing:    // The preparing thread sees the flag
+                case OpState::Draining:     // The last chunk completes it
+                    break;
+            }
+        }
+        if (finished) complete(finished);
+        return true;
+    }
+
+    const char* backend() const {
+        #ifdef USE_IO_URING
+        if (ring.fd >= 0) return "io_uring";
+        #endif
+        return "thread pool";
+    }
+
+    IOStats getStats() const {
+        IOStats stats;
+        stats.completed = completedCount;
+        stats.failed = failedCount;
+        stats.cancelled = cancelledCount;
+        stats.bytesRead = bytesRead;
+        return stats;
+    }
+
+private:
+    enum class OpState { Waiting, Preparing, Active, Draining };
+
+    struct Op {
+        RequestID id = 0;
+        ReadRequest request;
+        Completion onComplete;
+        OpState state = OpState::Waiting;
+
+        int fd = -1;
+        Buffer buffer;
+        uint8_t* target = nullptr;      // Start of the aligned span in buffer
+        uint64_t spanOffset = 0;        // File offset of target[0]
+        uint64_t spanLength = 0;
+        uint64_t spanEnd = 0;           // Readable end (EOF may cut the last block short)
+        uint32_t chunkCount = 0;
+        uint32_t nextChunk = 0;
+        std::atomic<uint32_t> chunksLeft{0};
+        std::atomic<bool> cancelled{false};
+        std::atomic<int> error{0};
+    };
+
+    struct Chunk {
+        std::shared_ptr<Op> op;
+        uint64_t offset = 0;
+        uint8_t* target = nullptr;
+        size_t length = 0;              // Bytes asked for (block-aligned when direct)
+        size_t needed = 0;              // Bytes that must arrive before EOF
+    };
+
+    enum class Work { None, Prepare, Read };
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::deque<std::shared_ptr<Op>> waiting[3];     // Not opened yet, per priority
+    std::deque<std::shared_ptr<Op>> active[3];      // Opened, chunks left to claim
+    std::unordered_map<RequestID, std::shared_ptr<Op>> ops;
+    std::vector<std::thread> threads;
+    RequestID nextId = 1;
+    bool stopping = false;
+
+    std::atomic<uint64_t> completedCount{0};
+    std::atomic<uint64_t> failedCount{0};
+    std::atomic<uint64_t> cancelledCount{0};
+    std::atomic<uint64_t> bytesRead{0};
+
+    std::vector<RequestID> enqueue(const std::vector<ReadRequest>& requests, std::vector<Completion> completions) {
+        std::vector<RequestID> ids;
+        ids.reserve(requests.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < requests.size(); i++) {
+                auto op = std::make_shared<Op>();
+                op->id = nextId++;
+                op->request = requests[i];
+                op->onComplete = std::move(completions[i]);
+                ops.emplace(op->id, op);
+                waiting[static_cast<int>(requests[i].priority)].push_back(op);
+                ids.push_back(op->id);
+            }
+        }
+        workAvailable.notify_all();
+        return ids;
+    }
+
+    Service() {
+        #ifdef USE_IO_URING
+        if (ring.open(RING_DEPTH)) {
+            threads.emplace_back([this] { ringLoop(); });
+            return;
+        }
+        #endif
+        unsigned count = std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+        for (unsigned i = 0; i < count; i++) threads.emplace_back([this] { poolLoop(); });
+    }
+
+    bool hasWork() const {
+        for (int p = 0; p < 3; p++) {
+            if (!waiting[p].empty() || !active[p].empty()) return true;
+        }
+        return false;
+    }
+
+    // Highest priority first; at equal priority, finish files already open
+    // before opening more. Called with the lock held.
+    Work next(std::shared_ptr<Op>& op, Chunk& chunk) {
+        for (int p = 2; p >= 0; p--) {
+            if (!active[p].empty()) {
+                op = active[p].front();
+                uint32_t index = op->nextChunk++;
+                if (op->nextChunk == op->chunkCount) {
+                    active[p].pop_front();
+                    op->state = OpState::Draining;
+                }
+                chunk.op = op;
+                chunk.offset = op->spanOffset + uint64_t(index) * CHUNK_SIZE;
+                chunk.target = op->target + size_t(index) * CHUNK_SIZE;
+                uint64_t spanBytes = uint64_t(op->chunkCount - 1) * CHUNK_SIZE;
+                chunk.length = index + 1 < op->chunkCount ? CHUNK_SIZE : size_t(op->spanLength - spanBytes);
+                chunk.needed = size_t(std::min<uint64_t>(chunk.length, op->spanEnd - chunk.offset));
+                return Work::Read;
+            }
+            if (!waiting[p].empty()) {
+                op = waiting[p].front();
+                waiting[p].pop_front();
+                op->state = OpState::Preparing;
+                return Work::Prepare;
+            }
+        }
+        return Work::None;
+    }
+
+    // Open the file and size the buffer, then queue its chunks
+    void start(const std::shared_ptr<Op>& op) {
+        bool ok = !op->cancelled && prepare(*op);
+        bool finished = !ok || op->chunkCount == 0;
+        if (!finished) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (op->cancelled) {
+                finished = true;
+            } else {
+                op->state = OpState::Active;
+                active[static_cast<int>(op->request.priority)].push_front(op);
+            }
+        }
+        if (finished) {
+            complete(op);
+        } else {
+            workAvailable.notify_all();
+        }
+    }
+
+    bool prepare(Op& op) {
+        const ReadRequest& request = op.request;
+        uint64_t fileSize = 0;
+        bool direct = false;
+
+        #ifndef _WIN32
+        int flags = O_RDONLY | O_CLOEXEC;
+        #ifdef O_DIRECT
+        if (request.direct) {
+            op.fd = ::open(request.path.c_str(), flags | O_DIRECT);
+            direct = op.fd >= 0;
+        }
+        #endif
+        if (op.fd < 0) op.fd = ::open(request.path.c_str(), flags);
+        if (op.fd < 0) return fail(op, errno);
+
+        struct stat st;
+        if (fstat(op.fd, &st) != 0) return fail(op, errno);
+        fileSize = static_cast<uint64_t>(st.st_size);
+        #else
+        std::error_code ec;
+        fileSize = std::filesystem::file_size(request.path, ec);
+        if (ec) return fail(op, ENOENT);
+        #endif
+
+        if (request.offset > fileSize) return fail(op, EINVAL);
+        uint64_t length = request.size ? request.size : fileSize - request.offset;
+        if (length > fileSize - request.offset) return fail(op, EINVAL);
+
+        // Direct I/O only pays off on big reads, and needs whole blocks
+        #if !defined(_WIN32) && defined(O_DIRECT)
+        if (direct && length < DIRECT_MIN_BYTES) {
+            fcntl(op.fd, F_SETFL, fcntl(op.fd, F_GETFL) & ~O_DIRECT);
+            direct = false;
+        }
+        #endif
+        uint64_t begin = request.offset;
+        uint64_t end = request.offset + length;
+        if (direct) {
+            begin &= ~uint64_t(DIRECT_ALIGNMENT - 1);
+            end = (end + DIRECT_ALIGNMENT - 1) & ~uint64_t(DIRECT_ALIGNMENT - 1);
+        }
+
+        size_t span = static_cast<size_t>(end - begin);
+        uint8_t* memory = nullptr;
+        #ifndef _WIN32
+        if (direct) memory = static_cast<uint8_t*>(std::aligned_alloc(DIRECT_ALIGNMENT, span));
+        #endif
+        if (!direct) memory = static_cast<uint8_t*>(std::malloc(std::max<size_t>(span, 1)));
+        if (!memory) return fail(op, ENOMEM);
+        op.buffer.memory.reset(memory);
+        op.buffer.start = static_cast<size_t>(request.offset - begin);
+        op.buffer.length = static_cast<size_t>(length);
+
+        op.target = memory;
+        op.spanOffset = begin;
+        op.spanLength = span;
+        op.spanEnd = std::min(end, fileSize);
+        op.chunkCount = static_cast<uint32_t>((span + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        op.chunksLeft = op.chunkCount;
+        return true;
+    }
+
+    static bool fail(Op& op, int error) {
+        int expected = 0;
+        op.error.compare_exchange_strong(expected, error ? error : EIO);
+        return false;
+    }
+
+    // result: bytes read, or -errno
+    void finishChunk(const Chunk& chunk, int64_t result) {
+        Op& op = *chunk.op;
+        if (result < 0) {
+            fail(op, static_cast<int>(-result));
+        } else if (static_cast<size_t>(result) < chunk.needed) {
+            fail(op, EIO); // The file shrank under us
+        } else {
+            bytesRead += chunk.needed;
+        }
+        if (op.chunksLeft.fetch_sub(1) == 1) complete(chunk.op);
+    }
+
+    void complete(const std::shared_ptr<Op>& op) {
+        #ifndef _WIN32
+        if (op->fd >= 0) ::close(op->fd);
+        #endif
+        op->fd = -1;
+
+        ReadResult result;
+        if (op->cancelled) {
+            result.status = Status::Cancelled;
+            cancelledCount++;
+        } else if (op->error) {
+            result.status = Status::Failed;
+            result.error = op->error;
+            failedCount++;
+        } else {
+            result.status = Status::Done;
+            result.buffer = std::move(op->buffer);
+            completedCount++;
+        }
+        op->buffer = Buffer{};
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ops.erase(op->id);
+        }
+        if (op->onComplete) op->onComplete(op->id, result);
+    }
+
+    // ---- Thread pool backend ----
+
+    void poolLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            workAvailable.wait(lock, [&] { return stopping || hasWork(); });
+            std::shared_ptr<Op> op;
+            Chunk chunk;
+            Work work = next(op, chunk);
+            if (work == Work::None) {
+                if (stopping) return;
+                continue;
+            }
+            lock.unlock();
+            if (work == Work::Prepare) {
+                start(op);
+            } else {
+                finishChunk(chunk, readChunk(chunk));
+            }
+            lock.lock();
+        }
+    }
+
+    static int64_t readChunk(const Chunk& chunk) {
+        size_t done = 0;
+        #ifndef _WIN32
+        while (done < chunk.needed) {
+            ssize_t count = pread(chunk.op->fd, chunk.target + done, chunk.length - done,
+                                  static_cast<off_t>(chunk.offset + done));
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                return -errno;
+            }
+            if (count == 0) break;
+            done += static_cast<size_t>(count);
+        }
+        #else
+        std::ifstream file(chunk.op->request.path, std::ios::binary);
+        if (!file) return -ENOENT;
+        file.seekg(static_cast<std::streamoff>(chunk.offset));
+        file.read(reinterpret_cast<char*>(chunk.target), static_cast<std::streamsize>(chunk.needed));
+        done = static_cast<size_t>(file.gcount());
+        #endif
+        return static_cast<int64_t>(done);
+    }
+
+    #ifdef USE_IO_URING
+    // ---- io_uring backend ----
+    //
+    // A minimal ring over the raw kernel interface (no liburing): one
+    // submission and one completion queue, shared with the kernel through
+    // mmap, driven by a single thread.
+    struct Ring {
+        int fd = -1;
+        unsigned* sqHead = nullptr;
+        unsigned* sqTail = nullptr;
+        unsigned* sqArray = nullptr;
+        unsigned sqMask = 0;
+        io_uring_sqe* sqes = nullptr;
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned cqMask = 0;
+        io_uring_cqe* cqes = nullptr;
+        unsigned localTail = 0;
+        unsigned unsubmitted = 0;
+
+        void* sqMap = MAP_FAILED;
+        void* cqMap = MAP_FAILED;
+        size_t sqMapSize = 0;
+        size_t cqMapSize = 0;
+        size_t sqesSize = 0;
+
+        bool open(unsigned entries) {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd < 0) return false;
+            // IORING_OP_READ needs 5.6, which is also when this flag appeared
+            if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+                close();
+                return false;
+            }
+
+            sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single) sqMapSize = cqMapSize = std::max(sqMapSize, cqMapSize);
+
+            sqMap = mmap(nullptr, sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sqMap == MAP_FAILED) {
+                close();
+                return false;
+            }
+            cqMap = single ? sqMap
+                           : mmap(nullptr, cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqeMap = cqMap == MAP_FAILED ? MAP_FAILED
+                         : mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (sqeMap == MAP_FAILED) {
+                close();
+                return false;
+            }
+
+            auto* sq = static_cast<uint8_t*>(sqMap);
+            auto* cq = static_cast<uint8_t*>(cqMap);
+            sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            sqes = static_cast<io_uring_sqe*>(sqeMap);
+            cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            localTail = *sqTail;
+            return true;
+        }
+
+        void close() {
+            if (sqes) munmap(sqes, sqesSize);
+            if (cqMap != MAP_FAILED && cqMap != sqMap) munmap(cqMap, cqMapSize);
+            if (sqMap != MAP_FAILED) munmap(sqMap, sqMapSize);
+            if (fd >= 0) ::close(fd);
+            sqes = nullptr;
+            sqMap = cqMap = MAP_FAILED;
+            fd = -1;
+        }
+
+        // The caller keeps in-flight reads under the ring size, so a slot
+        // is always free
+        void queueRead(int file, uint8_t* target, size_t length, uint64_t offset, uint64_t userData) {
+            unsigned index = localTail & sqMask;
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = file;
+            sqe.addr = reinterpret_cast<uint64_t>(target);
+            sqe.len = static_cast<uint32_t>(length);
+            sqe.off = offset;
+            sqe.user_data = userData;
+            sqArray[index] = index;
+            localTail++;
+            unsubmitted++;
+        }
+
+        // Submit what's queued and block until at least waitFor completions.
+        // Anything the kernel didn't take (EAGAIN/EBUSY) goes with the next call.
+        void submit(unsigned waitFor) {
+            __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+            while (true) {
+                long result = syscall(__NR_io_uring_enter, fd, unsubmitted, waitFor,
+                                      waitFor ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                if (result >= 0) {
+                    unsubmitted -= static_cast<unsigned>(result);
+                    return;
+                }
+                if (errno != EINTR) return;
+            }
+        }
+
+        template<typename Fn>
+        void reap(Fn&& handle) {
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            while (head != tail) {
+                const io_uring_cqe& cqe = cqes[head & cqMask];
+                handle(cqe.user_data, cqe.res);
+                head++;
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        }
+    };
+
+    Ring ring;
+
+    void ringLoop() {
+        std::vector<Chunk> slots(RING_DEPTH);
+        std::vector<uint32_t> freeSlots;
+        for (uint32_t i = 0; i < RING_DEPTH; i++) freeSlots.push_back(RING_DEPTH - 1 - i);
+        unsigned inFlight = 0;
+
+        auto queue = [&](uint32_t slot) {
+            const Chunk& chunk = slots[slot];
+            ring.queueRead(chunk.op->fd, chunk.target, chunk.length, chunk.offset, slot);
+        };
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            // Fill the submission queue, opening files as they come up
+            while (!freeSlots.empty()) {
+                std::shared_ptr<Op> op;
+                Chunk chunk;
+                Work work = next(op, chunk);
+                if (work == Work::None) break;
+                lock.unlock();
+                if (work == Work::Prepare) {
+                    start(op);
+                } else {
+                    uint32_t slot = freeSlots.back();
+                    freeSlots.pop_back();
+                    slots[slot] = std::move(chunk);
+                    queue(slot);
+                    inFlight++;
+                }
+                lock.lock();
+            }
+
+            if (inFlight == 0) {
+                if (stopping && !hasWork()) return;
+                workAvailable.wait(lock, [&] { return stopping || hasWork(); });
+                continue;
+            }
+
+            lock.unlock();
+            ring.submit(1);
+            ring.reap([&](uint64_t slot, int32_t result) {
+                Chunk& chunk = slots[slot];
+                if (result == -EINTR || result == -EAGAIN) {
+                    queue(static_cast<uint32_t>(slot));
+                    return;
+                }
+                // Short read before EOF: ask for the rest
+                if (result > 0 && static_cast<size_t>(result) < chunk.needed) {
+                    chunk.offset += result;
+                    chunk.target += result;
+                    chunk.length -= result;
+                    chunk.needed -= result;
+                    queue(static_cast<uint32_t>(slot));
+                    return;
+                }
+                finishChunk(chunk, result);
+                chunk = Chunk{};
+                freeSlots.push_back(static_cast<uint32_t>(slot));
+                inFlight--;
+            });
+            lock.lock();
+        }
+    }
+    #endif
+};
+
+inline bool Ticket::cancel() {
+    return state && Service::get().cancel(requestId);
+}
+
+// Blocking whole-file reads for loaders
+inline bool readFile(const std::string& path, Buffer& out, Priority priority = Priority::High) {
+    ReadRequest request;
+    request.path = path;
+    request.priority = priority;
+    Ticket ticket = Service::get().submit(request);
+    ReadResult& result = ticket.wait();
+    if (!result.ok()) return false;
+    out = std::move(result.buffer);
+    return true;
+}
+
+inline bool readFile(const std::string& path, std::vector<uint8_t>& out, Priority priority = Priority::High) {
+    Buffer buffer;
+    if (!readFile(path, buffer, priority)) return false;
+    out = buffer.toVector();
+    return true;
+}
+
+inline bool readText(const std::string& path, std::string& out, Priority priority = Priority::High) {
+    Buffer buffer;
+    if (!readFile(path, buffer, priority)) return false;
+    out.assign(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return true;
+}
+
+} // namespace AsyncIO
@@ -4,14 +4,16 @@
 #include <fstream>
 #include <sstream>
 #include <glm/glm.hpp>
+#include "VirtualFileSystem.h"
 
 class Config {
     std::unordered_map<std::string, std::string> values;
     
 public:
     bool load(const std::string& filepath) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) return false;
+        std::string text;
+        if (!VFS::readText(filepath, text)) return false;
+        std::istringstream file(text);
         
         std::string line;
         while (std::getline(file, line)) {
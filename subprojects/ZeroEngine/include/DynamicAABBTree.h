@@ -0,0 +1,614 @@
+#pragma once
+#include "Engine.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+// Axis-aligned bounding box
+struct AABB {
+    glm::vec3 min{0};
+    glm::vec3 max{0};
+
+    bool contains(const AABB& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    bool overlaps(const AABB& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    float surfaceArea() const {
+        glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    // Squared distance from a point to the box (0 inside)
+    float distanceSq(glm::vec3 p) const {
+        glm::vec3 d = glm::max(glm::max(min - p, p - max), glm::vec3(0));
+        return glm::dot(d, d);
+    }
+
+    static AABB merge(const AABB& a, const AABB& b) {
+        return AABB{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+    }
+
+    // Reciprocal direction with zero components nudged, so slab tests never hit 0 * inf
+    static glm::vec3 safeInverse(glm::vec3 dir) {
+        glm::vec3 inv;
+        for (int i = 0; i < 3; ++i) {
+            float d = std::abs(dir[i]) < 1e-20f ? (std::signbit(dir[i]) ? -1e-20f : 1e-20f) : dir[i];
+            inv[i] = 1.0f / d;
+        }
+        return inv;
+    }
+
+    // Entry distance of origin + dir * t, or +inf when missed within maxT.
+    // invDir must come from safeInverse().
+    float rayEntry(glm::vec3 origin, glm::vec3 invDir, float maxT) const {
+        float tx1 = (min.x - origin.x) * invDir.x, tx2 = (max.x - origin.x) * invDir.x;
+        float ty1 = (min.y - origin.y) * invDir.y, ty2 = (max.y - origin.y) * invDir.y;
+        float tz1 = (min.z - origin.z) * invDir.z, tz2 = (max.z - origin.z) * invDir.z;
+
+        float tNear = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)),
+                               std::max(std::min(tz1, tz2), 0.0f));
+        float tFar = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)),
+                              std::min(std::max(tz1, tz2), maxT));
+        return tNear <= tFar ? tNear : std::numeric_limits<float>::infinity();
+    }
+};
+
+// Dynamic bounding volume hierarchy (Box2D-style b2DynamicTree, in 3D).
+//
+// Leaves hold "fat" AABBs so small movements don't touch the tree; only
+// proxies that leave their fat box are reinserted. Insertion uses the
+// surface-area heuristic and rotations keep the tree height balanced.
+// Every node carries a layer mask and flag bits (union of its children),
+// so filtered queries skip whole subtrees.
+class DynamicAABBTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+    static constexpr int STACK_SIZE = 256;
+
+    struct Node {
+        AABB box;
+        int32_t parent = NULL_NODE; // Next free node while on the free list
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        int32_t height = -1;        // 0 = leaf, -1 = free
+        EntityID entity = 0;
+        uint32_t layerMask = 0;
+        uint32_t flags = 0;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    float margin = 0.1f;              // Fat AABB padding
+    float displacementFactor = 2.0f;  // Predictive stretch along movement
+
+    int32_t createProxy(const AABB& box, EntityID entity, uint32_t layerMask, uint32_t flags) {
+        int32_t proxy = allocateNode();
+        Node& node = nodes[proxy];
+        node.box = fatten(box);
+        node.entity = entity;
+        node.layerMask = layerMask;
+        node.flags = flags;
+        node.height = 0;
+        insertLeaf(proxy);
+        ++proxyCount;
+        return proxy;
+    }
+
+    void destroyProxy(int32_t proxy) {
+        removeLeaf(proxy);
+        freeNode(proxy);
+        --proxyCount;
+    }
+
+    // Returns true when the proxy had to be reinserted
+    bool moveProxy(int32_t proxy, const AABB& box, glm::vec3 displacement) {
+        const AABB& fat = nodes[proxy].box;
+        if (fat.contains(box)) {
+            // Still inside; only rebuild if the fat box has grown far too loose
+            AABB huge = box;
+            huge.min -= glm::vec3(4.0f * margin);
+            huge.max += glm::vec3(4.0f * margin);
+            if (huge.contains(fat)) return false;
+        }
+
+        removeLeaf(proxy);
+
+        AABB fatBox = fatten(box);
+        glm::vec3 d = displacement * displacementFactor;
+        for (int i = 0; i < 3; ++i) {
+            if (d[i] < 0.0f) fatBox.min[i] += d[i];
+            else fatBox.max[i] += d[i];
+        }
+        nodes[proxy].box = fatBox;
+
+        insertLeaf(proxy);
+        return true;
+    }
+
+    // Update filter bits in place, refreshing the ancestors' unions
+    void setFilter(int32_t proxy, uint32_t layerMask, uint32_t flags) {
+        Node& node = nodes[proxy];
+        if (node.layerMask == layerMask && node.flags == flags) return;
+        node.layerMask = layerMask;
+        node.flags = flags;
+        for (int32_t i = node.parent; i != NULL_NODE; i = nodes[i].parent) {
+            refit(i);
+        }
+    }
+
+    // Rebuild the interior nodes top-down with a binned SAH. Incremental
+    // insertion degrades when thousands of proxies arrive at once (scene
+    // load), so bulk inserts are followed by a rebuild. Proxy IDs stay valid.
+    void rebuild() {
+        std::vector<int32_t> leaves;
+        leaves.reserve(proxyCount);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].height < 0) continue;
+            if (nodes[i].isLeaf()) {
+                nodes[i].parent = NULL_NODE;
+                leaves.push_back(static_cast<int32_t>(i));
+            } else {
+                freeNode(static_cast<int32_t>(i));
+            }
+        }
+
+        root = leaves.empty() ? NULL_NODE : buildTopDown(leaves, 0, leaves.size());
+        if (root != NULL_NODE) nodes[root].parent = NULL_NODE;
+    }
+
+    const AABB& getFatAABB(int32_t proxy) const { return nodes[proxy].box; }
+    EntityID getEntity(int32_t proxy) const { return nodes[proxy].entity; }
+    int32_t getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+    int32_t getProxyCount() const { return proxyCount; }
+
+    void clear() {
+        nodes.clear();
+        root = NULL_NODE;
+        freeList = NULL_NODE;
+        proxyCount = 0;
+    }
+
+    // fn(EntityID, int32_t proxy) -> bool (false stops the query)
+    template<typename Fn>
+    void query(const AABB& box, uint32_t layerMask, uint32_t requiredFlags, Fn&& fn) const {
+        if (root == NULL_NODE) return;
+
+        int32_t stack[STACK_SIZE];
+        int sp = 0;
+        stack[sp++] = root;
+
+        while (sp > 0) {
+            const Node& node = nodes[stack[--sp]];
+            if (!passes(node, layerMask, requiredFlags) || !node.box.overlaps(box)) continue;
+
+            if (node.isLeaf()) {
+                if (!fn(node.entity, static_cast<int32_t>(&node - nodes.data()))) return;
+            } else if (sp + 2 <= STACK_SIZE) {
+                stack[sp++] = node.child1;
+                stack[sp++] = node.child2;
+            }
+        }
+    }
+
+    // Front-to-back traversal along origin + direction * t.
+    // fn(EntityID, int32_t proxy, float maxDistance) -> float new maxDistance
+    // (return the current value to continue, a hit distance to clip, 0 to stop).
+    template<typename Fn>
+    void raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance,
+                 uint32_t layerMask, uint32_t requiredFlags, Fn&& fn) const {
+        if (root == NULL_NODE) return;
+
+        glm::vec3 invDir = AABB::safeInverse(direction);
+
+        // Each entry carries its node's entry distance, so nodes are slab-tested once
+        struct Entry {
+            int32_t node;
+            float t;
+        };
+        Entry stack[STACK_SIZE];
+        int sp = 0;
+
+        float tRoot = nodes[root].box.rayEntry(origin, invDir, maxDistance);
+        if (tRoot > maxDistance || !passes(nodes[root], layerMask, requiredFlags)) return;
+        stack[sp++] = {root, tRoot};
+
+        while (sp > 0) {
+            Entry entry = stack[--sp];
+            if (entry.t > maxDistance) continue; // Clipped by a closer hit
+
+            const Node& node = nodes[entry.node];
+            if (node.isLeaf()) {
+                maxDistance = fn(node.entity, entry.node, maxDistance);
+                if (maxDistance <= 0.0f) return;
+                continue;
+            }
+
+            if (sp + 2 > STACK_SIZE) continue;
+
+            const Node& c1 = nodes[node.child1];
+            const Node& c2 = nodes[node.child2];
+            float t1 = passes(c1, layerMask, requiredFlags) ? c1.box.rayEntry(origin, invDir, maxDistance)
+                                                            : std::numeric_limits<float>::infinity();
+            float t2 = passes(c2, layerMask, requiredFlags) ? c2.box.rayEntry(origin, invDir, maxDistance)
+                                                            : std::numeric_limits<float>::infinity();
+
+            // Push the farther child first so the nearer one is visited next
+            if (t1 <= t2) {
+                if (t2 <= maxDistance) stack[sp++] = {node.child2, t2};
+                if (t1 <= maxDistance) stack[sp++] = {node.child1, t1};
+            } else {
+                if (t1 <= maxDistance) stack[sp++] = {node.child1, t1};
+                if (t2 <= maxDistance) stack[sp++] = {node.child2, t2};
+            }
+        }
+    }
+
+    // Packet traversal: up to PACKET_SIZE rays walk the tree together, so each
+    // node is fetched once per packet. Lanes are stored SoA so the per-node
+    // slab test vectorizes. Directions must be normalized; a ray's layer mask
+    // and clip distance are tracked per lane.
+    // fn(int lane, EntityID, int32_t proxy, float maxDistance) -> float new maxDistance
+    static constexpr int PACKET_SIZE = 8;
+
+    template<typename Fn>
+    void raycastPacket(const glm::vec3* origins, const glm::vec3* directions, const float* maxDistances,
+                       const uint32_t* layerMasks, int count, uint32_t requiredFlags, Fn&& fn) const {
+        if (root == NULL_NODE || count <= 0) return;
+        count = std::min(count, PACKET_SIZE);
+
+        alignas(32) float ox[PACKET_SIZE], oy[PACKET_SIZE], oz[PACKET_SIZE];
+        alignas(32) float ix[PACKET_SIZE], iy[PACKET_SIZE], iz[PACKET_SIZE];
+        alignas(32) float tmax[PACKET_SIZE];
+        alignas(32) float tNear[PACKET_SIZE], tFar[PACKET_SIZE];
+        uint32_t masks[PACKET_SIZE];
+
+        for (int i = 0; i < PACKET_SIZE; ++i) {
+            int src = i < count ? i : 0;
+            ox[i] = origins[src].x;
+            oy[i] = origins[src].y;
+            oz[i] = origins[src].z;
+            glm::vec3 inv = AABB::safeInverse(directions[src]);
+            ix[i] = inv.x;
+            iy[i] = inv.y;
+            iz[i] = inv.z;
+            tmax[i] = i < count ? maxDistances[i] : -1.0f;
+            masks[i] = i < count ? layerMasks[i] : 0;
+        }
+
+        int32_t stack[STACK_SIZE];
+        int sp = 0;
+        stack[sp++] = root;
+
+        while (sp > 0) {
+            const Node& node = nodes[stack[--sp]];
+            if ((node.flags & requiredFlags) != requiredFlags) continue;
+
+            // Pure arithmetic over SoA lanes so the compiler emits packed min/max
+            const float minX = node.box.min.x, minY = node.box.min.y, minZ = node.box.min.z;
+            const float maxX = node.box.max.x, maxY = node.box.max.y, maxZ = node.box.max.z;
+            for (int i = 0; i < PACKET_SIZE; ++i) {
+                float tx1 = (minX - ox[i]) * ix[i], tx2 = (maxX - ox[i]) * ix[i];
+                float ty1 = (minY - oy[i]) * iy[i], ty2 = (maxY - oy[i]) * iy[i];
+                float tz1 = (minZ - oz[i]) * iz[i], tz2 = (maxZ - oz[i]) * iz[i];
+                tNear[i] = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)),
+                                    std::max(std::min(tz1, tz2), 0.0f));
+                tFar[i] = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)),
+                                   std::min(std::max(tz1, tz2), tmax[i]));
+            }
+
+            uint32_t active = 0;
+            for (int i = 0; i < PACKET_SIZE; ++i) {
+                if (tNear[i] <= tFar[i] && (node.layerMask & masks[i])) active |= 1u << i;
+            }
+            if (!active) continue;
+
+            if (node.isLeaf()) {
+                int32_t proxy = static_cast<int32_t>(&node - nodes.data());
+                for (int i = 0; i < count; ++i) {
+                    if (active & (1u << i)) tmax[i] = fn(i, node.entity, proxy, tmax[i]);
+                }
+                continue;
+            }
+
+            if (sp + 2 > STACK_SIZE) continue;
+
+            // Order children by the first active ray's direction along the widest axis
+            int lead = 0;
+            while (!(active & (1u << lead))) ++lead;
+            const AABB& b1 = nodes[node.child1].box;
+            const AABB& b2 = nodes[node.child2].box;
+            glm::vec3 c = (b2.min + b2.max) - (b1.min + b1.max);
+            glm::vec3 inv(ix[lead], iy[lead], iz[lead]);
+            int axis = 0;
+            if (std::abs(c.y) > std::abs(c[axis])) axis = 1;
+            if (std::abs(c.z) > std::abs(c[axis])) axis = 2;
+            bool firstIsNear = (c[axis] >= 0.0f) == (inv[axis] >= 0.0f);
+
+            stack[sp++] = firstIsNear ? node.child2 : node.child1;
+            stack[sp++] = firstIsNear ? node.child1 : node.child2;
+        }
+    }
+
+    // Nearest-first search around a point. fn(EntityID, int32_t proxy, float bestDistanceSq)
+    // -> float new bestDistanceSq; subtrees farther than the current best are pruned.
+    template<typename Fn>
+    void nearest(glm::vec3 point, float maxDistanceSq, uint32_t layerMask, uint32_t requiredFlags, Fn&& fn) const {
+        if (root == NULL_NODE) return;
+
+        int32_t stack[STACK_SIZE];
+        int sp = 0;
+        stack[sp++] = root;
+
+        while (sp > 0) {
+            const Node& node = nodes[stack[--sp]];
+            if (!passes(node, layerMask, requiredFlags)) continue;
+            if (node.box.distanceSq(point) > maxDistanceSq) continue;
+
+            if (node.isLeaf()) {
+                maxDistanceSq = fn(node.entity, static_cast<int32_t>(&node - nodes.data()), maxDistanceSq);
+                continue;
+            }
+
+            if (sp + 2 > STACK_SIZE) continue;
+
+            float d1 = nodes[node.child1].box.distanceSq(point);
+            float d2 = nodes[node.child2].box.distanceSq(point);
+            if (d1 <= d2) {
+                stack[sp++] = node.child2;
+                stack[sp++] = node.child1;
+            } else {
+                stack[sp++] = node.child1;
+                stack[sp++] = node.child2;
+            }
+        }
+    }
+
+private:
+    std::vector<Node> nodes;
+    int32_t root = NULL_NODE;
+    int32_t freeList = NULL_NODE;
+    int32_t proxyCount = 0;
+
+    static bool passes(const Node& node, uint32_t layerMask, uint32_t requiredFlags) {
+        return (node.layerMask & layerMask) && (node.flags & requiredFlags) == requiredFlags;
+    }
+
+    AABB fatten(const AABB& box) const {
+        return AABB{box.min - glm::vec3(margin), box.max + glm::vec3(margin)};
+    }
+
+    int32_t allocateNode() {
+        if (freeList == NULL_NODE) {
+            nodes.emplace_back();
+            return static_cast<int32_t>(nodes.size() - 1);
+        }
+        int32_t index = freeList;
+        freeList = nodes[index].parent;
+        nodes[index] = Node();
+        return index;
+    }
+
+    void freeNode(int32_t index) {
+        nodes[index].parent = freeList;
+        nodes[index].height = -1;
+        freeList = index;
+    }
+
+    // Recompute an interior node from its children
+    void refit(int32_t index) {
+        Node& node = nodes[index];
+        const Node& c1 = nodes[node.child1];
+        const Node& c2 = nodes[node.child2];
+        node.box = AABB::merge(c1.box, c2.box);
+        node.height = 1 + std::max(c1.height, c2.height);
+        node.layerMask = c1.layerMask | c2.layerMask;
+        node.flags = c1.flags | c2.flags;
+    }
+
+    int32_t buildTopDown(std::vector<int32_t>& leaves, size_t begin, size_t end) {
+        size_t count = end - begin;
+        if (count == 1) return leaves[begin];
+
+        AABB centroids{glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max())};
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 c = (nodes[leaves[i]].box.min + nodes[leaves[i]].box.max) * 0.5f;
+            centroids.min = glm::min(centroids.min, c);
+            centroids.max = glm::max(centroids.max, c);
+        }
+
+        // Binned SAH over the widest centroid axis
+        constexpr int BINS = 16;
+        glm::vec3 extent = centroids.max - centroids.min;
+        int axis = 0;
+        if (extent.y > extent[axis]) axis = 1;
+        if (extent.z > extent[axis]) axis = 2;
+
+        size_t mid = begin + count / 2;
+        if (extent[axis] > 1e-6f) {
+            AABB binBox[BINS];
+            size_t binCount[BINS] = {};
+            float scale = BINS / extent[axis];
+            auto binOf = [&](int32_t leaf) {
+                float c = (nodes[leaf].box.min[axis] + nodes[leaf].box.max[axis]) * 0.5f;
+                return std::min(BINS - 1, static_cast<int>((c - centroids.min[axis]) * scale));
+            };
+
+            for (size_t i = begin; i < end; ++i) {
+                int b = binOf(leaves[i]);
+                binBox[b] = binCount[b] ? AABB::merge(binBox[b], nodes[leaves[i]].box) : nodes[leaves[i]].box;
+                binCount[b]++;
+            }
+
+            float rightArea[BINS];
+            size_t rightCount[BINS];
+            AABB acc;
+            size_t n = 0;
+            for (int b = BINS - 1; b > 0; --b) {
+                if (binCount[b]) acc = n ? AABB::merge(acc, binBox[b]) : binBox[b];
+                n += binCount[b];
+                rightArea[b] = n ? acc.surfaceArea() : 0.0f;
+                rightCount[b] = n;
+            }
+
+            float bestCost = std::numeric_limits<float>::max();
+            int bestSplit = -1;
+            n = 0;
+            for (int b = 0; b < BINS - 1; ++b) {
+                if (binCount[b]) acc = n ? AABB::merge(acc, binBox[b]) : binBox[b];
+                n += binCount[b];
+                if (n == 0 || rightCount[b + 1] == 0) continue;
+                float cost = acc.surfaceArea() * n + rightArea[b + 1] * rightCount[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = b;
+                }
+            }
+
+            if (bestSplit >= 0) {
+                auto it = std::partition(leaves.begin() + begin, leaves.begin() + end,
+                    [&](int32_t leaf) { return binOf(leaf) <= bestSplit; });
+                mid = static_cast<size_t>(it - leaves.begin());
+            }
+        }
+
+        int32_t child1 = buildTopDown(leaves, begin, mid);
+        int32_t child2 = buildTopDown(leaves, mid, end);
+
+        int32_t parent = allocateNode();
+        nodes[parent].child1 = child1;
+        nodes[parent].child2 = child2;
+        nodes[child1].parent = parent;
+        nodes[child2].parent = parent;
+        refit(parent);
+        return parent;
+    }
+
+    void replaceChild(int32_t parent, int32_t oldChild, int32_t newChild) {
+        if (parent == NULL_NODE) {
+            root = newChild;
+        } else if (nodes[parent].child1 == oldChild) {
+            nodes[parent].child1 = newChild;
+        } else {
+            nodes[parent].child2 = newChild;
+        }
+    }
+
+    void insertLeaf(int32_t leaf) {
+        if (root == NULL_NODE) {
+            root = leaf;
+            nodes[root].parent = NULL_NODE;
+            return;
+        }
+
+        // Find the best sibling (SAH descent)
+        AABB leafBox = nodes[leaf].box;
+        int32_t index = root;
+        while (!nodes[index].isLeaf()) {
+            const Node& node = nodes[index];
+            float area = node.box.surfaceArea();
+            float combinedArea = AABB::merge(node.box, leafBox).surfaceArea();
+
+            // Cost of creating a new parent here, and of pushing the leaf further down
+            float cost = 2.0f * combinedArea;
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int32_t child) {
+                const Node& c = nodes[child];
+                float merged = AABB::merge(leafBox, c.box).surfaceArea();
+                return c.isLeaf() ? merged + inheritanceCost
+                                  : (merged - c.box.surfaceArea()) + inheritanceCost;
+            };
+            float cost1 = descendCost(node.child1);
+            float cost2 = descendCost(node.child2);
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        int32_t sibling = index;
+        int32_t oldParent = nodes[sibling].parent;
+        int32_t newParent = allocateNode();
+
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+        replaceChild(oldParent, sibling, newParent);
+
+        // Walk back up, refitting and rebalancing
+        for (int32_t i = newParent; i != NULL_NODE; i = nodes[i].parent) {
+            refit(i);
+            i = balance(i);
+        }
+    }
+
+    void removeLeaf(int32_t leaf) {
+        if (leaf == root) {
+            root = NULL_NODE;
+            return;
+        }
+
+        int32_t parent = nodes[leaf].parent;
+        int32_t grandParent = nodes[parent].parent;
+        int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+        replaceChild(grandParent, parent, sibling);
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        for (int32_t i = grandParent; i != NULL_NODE; i = nodes[i].parent) {
+            refit(i);
+            i = balance(i);
+        }
+    }
+
+    // Single rotation when the children's heights differ by more than one.
+    // Returns the index of the node now at this position.
+    int32_t balance(int32_t iA) {
+        Node& A = nodes[iA];
+        if (A.isLeaf() || A.height < 2) return iA;
+
+        int32_t iB = A.child1;
+        int32_t iC = A.child2;
+        int32_t diff = nodes[iC].height - nodes[iB].height;
+
+        if (diff > 1) return rotateUp(iA, iC, false);
+        if (diff < -1) return rotateUp(iA, iB, true);
+        return iA;
+    }
+
+    // Lift child iX of iA into iA's place; iX keeps its taller child and
+    // hands the shorter one to iA.
+    int32_t rotateUp(int32_t iA, int32_t iX, bool xIsChild1) {
+        int32_t iF = nodes[iX].child1;
+        int32_t iG = nodes[iX].child2;
+
+        nodes[iX].parent = nodes[iA].parent;
+        replaceChild(nodes[iX].parent, iA, iX);
+        nodes[iA].parent = iX;
+        nodes[iX].child1 = iA;
+
+        int32_t keep = nodes[iF].height > nodes[iG].height ? iF : iG;
+        int32_t give = keep == iF ? iG : iF;
+
+        nodes[iX].child2 = keep;
+        if (xIsChild1) nodes[iA].child1 = give;
+        else nodes[iA].child2 = give;
+        nodes[give].parent = iA;
+
+        refit(iA);
+        refit(iX);
+        return iX;
+    }
+};
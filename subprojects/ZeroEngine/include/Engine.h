@@ -35,13 +35,15 @@ class TypedComponentArray : public ComponentArray {
     std::unordered_map<EntityID, size_t> entityToIndex;
     std::unordered_map<size_t, EntityID> indexToEntity;
     std::vector<T> components;
+    std::vector<EntityID> entityList; // Parallel to components
     size_t size = 0;
 
 public:
     void insert(EntityID entity, T component) {
         entityToIndex[entity] = size;
         indexToEntity[size] = entity;
-        components.push_back(component);
+        components.push_back(std::move(component));
+        entityList.push_back(entity);
         size++;
     }
 
@@ -49,6 +51,7 @@ public:
         size_t removedIndex = entityToIndex[entity];
         size_t lastIndex = size - 1;
         components[removedIndex] = components[lastIndex];
+        entityList[removedIndex] = entityList[lastIndex];
         
         EntityID lastEntity = indexToEntity[lastIndex];
         entityToIndex[lastEntity] = removedIndex;
@@ -57,6 +60,7 @@ public:
         entityToIndex.erase(entity);
         indexToEntity.erase(lastIndex);
         components.pop_back();
+        entityList.pop_back();
         size--;
     }
 
@@ -66,6 +70,23 @@ public:
     return &components[it->second];
 }
 
+    // Dense iteration: fn(EntityID, T&) for every stored component
+    template<typename Fn>
+    void each(Fn&& fn) {
+        for (size_t i = 0; i < size; ++i) {
+            fn(entityList[i], components[i]);
+        }
+    }
+
+    size_t count() const { return size; }
+    
+    void reserve(size_t capacity) {
+        components.reserve(capacity);
+        entityList.reserve(capacity);
+        entityToIndex.reserve(capacity);
+        indexToEntity.reserve(capacity);
+    }
+
     void entityDestroyed(EntityID entity) override {
         if (entityToIndex.find(entity) != entityToIndex.end())
             remove(entity);
@@ -131,6 +152,12 @@ void clear() {
         componentArrays[typeIndex] = std::make_shared<TypedComponentArray<T>>();
     }
 
+    // Bit of a registered component in entity masks and system signatures
+    template<typename T>
+    uint8_t getComponentType() {
+        return componentTypes[std::type_index(typeid(T))];
+    }
+
     template<typename T>
     void addComponent(EntityID entity, T component) {
         getComponentArray<T>()->insert(entity, component);
@@ -138,6 +165,20 @@ void clear() {
         updateEntitySystems(entity);
     }
 
+    // Bulk insert (scene loading): systems are refreshed once for the whole
+    // batch instead of once per entity
+    template<typename T>
+    void addComponents(const std::vector<EntityID>& ids, std::vector<T>& components) {
+        auto array = getComponentArray<T>();
+        array->reserve(array->count() + ids.size());
+        uint8_t bit = componentTypes[std::type_index(typeid(T))];
+        for (size_t i = 0; i < ids.size(); ++i) {
+            array->insert(ids[i], std::move(components[i]));
+            entities[ids[i]].mask.set(bit);
+        }
+        updateEntitySystems(ids);
+    }
+    
     template<typename T>
     void removeComponent(EntityID entity) {
         getComponentArray<T>()->remove(entity);
@@ -156,6 +197,21 @@ T* getComponent(EntityID entity) {
     return array->get(entity);
 }
 
+    // Visit every entity that has a T without probing IDs one by one
+    template<typename T, typename Fn>
+    void each(Fn&& fn) {
+        auto it = componentArrays.find(std::type_index(typeid(T)));
+        if (it == componentArrays.end()) return;
+        static_cast<TypedComponentArray<T>*>(it->second.get())->each(std::forward<Fn>(fn));
+    }
+
+    template<typename T>
+    size_t componentCount() {
+        auto it = componentArrays.find(std::type_index(typeid(T)));
+        if (it == componentArrays.end()) return 0;
+        return static_cast<TypedComponentArray<T>*>(it->second.get())->count();
+    }
+
     template<typename T>
     std::shared_ptr<T> registerSystem() {
         auto system = std::make_shared<T>();
@@ -197,4 +253,30 @@ private:
                 ents.erase(it);
         }
     }
+    
+    void updateEntitySystems(const std::vector<EntityID>& batch) {
+        std::vector<uint8_t> member(entities.size());
+        for (auto& system : systems) {
+            auto& ents = system->entities;
+            std::fill(member.begin(), member.end(), 0);
+            for (EntityID e : ents) member[e] = 1;
+            
+            bool removed = false;
+            for (EntityID e : batch) {
+                bool matches = (entities[e].mask & system->signature) == system->signature;
+                if (matches && !member[e]) {
+                    ents.push_back(e);
+                    member[e] = 1;
+                } else if (!matches && member[e]) {
+                    member[e] = 0;
+                    removed = true;
+                }
+            }
+            
+            if (removed) {
+                ents.erase(std::remove_if(ents.begin(), ents.end(),
+                                          [&](EntityID e) { return !member[e]; }), ents.end());
+            }
+        }
+    }
 };
@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Bounded lock-free multi-producer, single-consumer queue
+//
+// A ring of cells, each with a sequence number that says whose turn it is:
+// a producer claims a position with one CAS on the shared tail, constructs
+// the value in place and publishes it by bumping the cell's sequence; the
+// consumer reads cells in order without touching the tail. No locks and no
+// allocation after construction. push() fails instead of waiting when the
+// ring is full, so producers choose between dropping and retrying.
+template<typename T>
+class MPSCQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit MPSCQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    ~MPSCQueue() {
+        drain([](T&&) {});
+    }
+
+    // Any thread. False when full; nothing is constructed then.
+    template<typename... Args>
+    bool push(Args&&... args) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // The consumer hasn't freed this cell yet
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only
+    bool pop(T& out) {
+        Cell& cell = cells[head & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) return false;
+        T* value = reinterpret_cast<T*>(cell.storage);
+        out = std::move(*value);
+        value->~T();
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+    // Consumer thread only: fn(T&&) for what's published, up to limit
+    // (producers can refill as fast as this empties). Stops at the first
+    // cell still being written. Returns the count.
+    template<typename Fn>
+    size_t drain(Fn&& fn, size_t limit = SIZE_MAX) {
+        size_t count = 0;
+        while (count < limit) {
+            Cell& cell = cells[head & mask];
+            if (cell.sequence.load(std::memory_order_acquire) != head + 1) break;
+            T* value = reinterpret_cast<T*>(cell.storage);
+            fn(std::move(*value));
+            value->~T();
+            cell.sequence.store(head + mask + 1, std::memory_order_release);
+            head++;
+            count++;
+        }
+        return count;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Successful pushes since construction
+    size_t pushed() const { return tail.load(std::memory_order_relaxed); }
+
+    // Approximate while producers are active; exact on the consumer with none
+    size_t size() const {
+        size_t t = tail.load(std::memory_order_acquire);
+        return t > head ? t - head : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> tail{0};   // Shared by producers
+    alignas(64) size_t head = 0;                // Consumer's own line
+};
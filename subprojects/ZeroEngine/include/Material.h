@@ -8,6 +8,8 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include "VirtualFileSystem.h"
+#include "Name.h"
 
 // Shader property types
 using ShaderProperty = std::variant<float, glm::vec2, glm::vec3, glm::vec4, glm::mat4, int>;
@@ -50,7 +52,7 @@ struct MaterialProperties {
     int emissiveMap = -1;
     
     // Custom properties
-    std::unordered_map<std::string, ShaderProperty> customProperties;
+    std::unordered_map<Name, ShaderProperty> customProperties;
 };
 
 struct ShaderPass {
@@ -72,28 +74,28 @@ public:
     
     VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
     
-    void setFloat(const std::string& name, float value) {
+    void setFloat(Name name, float value) {
         properties.customProperties[name] = value;
     }
     
-    void setVec2(const std::string& name, glm::vec2 value) {
+    void setVec2(Name name, glm::vec2 value) {
         properties.customProperties[name] = value;
     }
     
-    void setVec3(const std::string& name, glm::vec3 value) {
+    void setVec3(Name name, glm::vec3 value) {
         properties.customProperties[name] = value;
     }
     
-    void setVec4(const std::string& name, glm::vec4 value) {
+    void setVec4(Name name, glm::vec4 value) {
         properties.customProperties[name] = value;
     }
     
-    void setInt(const std::string& name, int value) {
+    void setInt(Name name, int value) {
         properties.customProperties[name] = value;
     }
     
     template<typename T>
-    T get(const std::string& name, T defaultValue = T{}) const {
+    T get(Name name, T defaultValue = T{}) const {
         auto it = properties.customProperties.find(name);
         if (it != properties.customProperties.end()) {
             if (auto* val = std::get_if<T>(&it->second)) {
@@ -121,7 +123,7 @@ class ShaderLibrary {
     struct ShaderDef {
         std::string name;
         std::vector<ShaderPass> passes;
-        std::unordered_map<std::string, ShaderProperty> defaultProperties;
+        std::unordered_map<Name, ShaderProperty> defaultProperties;
     };
     
     std::unordered_map<std::string, ShaderDef> shaders;
@@ -146,11 +148,12 @@ public:
     }
     
     bool loadShader(const std::string& path) {
-        std::ifstream file(path);
-        if (!file.is_open()) {
+        std::string text;
+        if (!VFS::readText(path, text)) {
             std::cerr << "Failed to open shader file: " << path << std::endl;
             return false;
         }
+        std::istringstream file(text);
         
         ShaderDef shader;
         ShaderPass* currentPass = nullptr;
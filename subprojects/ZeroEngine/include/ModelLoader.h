@@ -5,6 +5,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <assimp/Importer.hpp>
+#include <assimp/IOSystem.hpp>
+#include <assimp/IOStream.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <string>
@@ -17,6 +19,10 @@
 #include <iostream>
 #include <filesystem>
 #include "Texture.h"
+#include "TriangleMesh.h"
+#include "VirtualFileSystem.h"
+#include "Name.h"
+#include <memory>
 
 struct Vertex {
     glm::vec3 position;
@@ -96,6 +102,7 @@ struct BoneInfo {
     glm::mat4 offset{1.0f};
     glm::mat4 finalTransform{1.0f};
     std::string name;
+    Name id;
     int parentIndex = -1;
 };
 
@@ -106,6 +113,8 @@ struct Animation {
     
     struct Channel {
         std::string nodeName;
+        Name node;
+        int bone = -1;  // Index into Model::bones, set by Model::linkChannels()
         std::vector<std::pair<float, glm::vec3>> positions;
         std::vector<std::pair<float, glm::quat>> rotations;
         std::vector<std::pair<float, glm::vec3>> scales;
@@ -121,7 +130,10 @@ struct Model {
     std::vector<Texture> textures;
     std::vector<BoneInfo> bones;
     std::vector<Animation> animations;
-    std::unordered_map<std::string, int> boneMap;
+    std::unordered_map<Name, int> boneMap;
+    
+    // Static collision geometry, only built when requested at import
+    std::shared_ptr<TriangleMeshShape> collisionMesh;
     
     glm::mat4 globalInverseTransform{1.0f};
     
@@ -140,6 +152,88 @@ struct Model {
     
     bool hasAnimations() const { return !animations.empty(); }
     bool hasBones() const { return !bones.empty(); }
+    
+    // Match every animation channel to its bone once, so sampling is by index
+    void linkChannels() {
+        for (Animation& anim : animations) {
+            for (Animation::Channel& ch : anim.channels) {
+                auto it = boneMap.find(ch.node);
+                ch.bone = it != boneMap.end() ? it->second : -1;
+            }
+        }
+    }
+};
+
+// RGBA8 pixels decoded on the CPU, waiting for upload
+struct DecodedImage {
+    std::vector<unsigned char> pixels;
+    int width = 0;
+    int height = 0;
+    std::string path; // Empty for embedded textures
+};
+
+// CPU half of a model load: geometry, materials, bones and decoded images,
+// with no Vulkan objects yet. Produced by ModelLoader::import() on any
+// thread; ModelLoader::upload() turns it into a renderable Model.
+// Material texture indices refer to images (and to Model::textures after upload).
+struct ModelImport {
+    std::string path;
+    Model model;
+    std::vector<DecodedImage> images;
+    
+    bool valid() const { return !model.vertices.empty(); }
+};
+
+// Assimp file access through the VFS: each file (the model and anything it
+// pulls in, like .mtl or .bin buffers) is read whole, then parsed from memory
+class VFSStream : public Assimp::IOStream {
+public:
+    explicit VFSStream(AsyncIO::Buffer buffer) : buffer(std::move(buffer)) {}
+    
+    size_t Read(void* out, size_t size, size_t count) override {
+        if (size == 0) return 0;
+        count = std::min(count, (buffer.size() - position) / size);
+        std::memcpy(out, buffer.data() + position, size * count);
+        position += size * count;
+        return count;
+    }
+    
+    size_t Write(const void*, size_t, size_t) override { return 0; }
+    
+    aiReturn Seek(size_t offset, aiOrigin origin) override {
+        size_t target = offset;
+        if (origin == aiOrigin_CUR) target = position + offset;
+        else if (origin == aiOrigin_END) target = buffer.size() - offset;
+        if (target > buffer.size()) return aiReturn_FAILURE;
+        position = target;
+        return aiReturn_SUCCESS;
+    }
+    
+    size_t Tell() const override { return position; }
+    size_t FileSize() const override { return buffer.size(); }
+    void Flush() override {}
+    
+private:
+    AsyncIO::Buffer buffer;
+    size_t position = 0;
+};
+
+class VFSIOSystem : public Assimp::IOSystem {
+public:
+    bool Exists(const char* file) const override {
+        return VFS::FileSystem::get().exists(file);
+    }
+    
+    char getOsSeparator() const override { return '/'; }
+    
+    Assimp::IOStream* Open(const char* file, const char* mode = "rb") override {
+        if (std::strchr(mode, 'w') || std::strchr(mode, 'a')) return nullptr; // Read-only
+        AsyncIO::Buffer buffer;
+        if (!VFS::readFile(file, buffer)) return nullptr;
+        return new VFSStream(std::move(buffer));
+    }
+    
+    void Close(Assimp::IOStream* stream) override { delete stream; }
 };
 
 class ModelLoader {
@@ -153,11 +247,15 @@ class ModelLoader {
     Texture defaultWhiteTexture;
     Texture defaultNormalTexture;
     
-    // Temporary storage during loading
-    std::unordered_map<std::string, int> tempBoneMap;
-    std::vector<BoneInfo> tempBones;
+    // Staging memory kept alive until a batch's copies have executed
+    struct StagingBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = nullptr;
+    };
     
 public:
+    VmaAllocator getAllocator() const { return allocator; }
+    
    bool init(VkDevice dev, VmaAllocator alloc, VkCommandPool cmdPool, VkQueue q,
           VkDescriptorPool descPool, VkDescriptorSetLayout descLayout) {
     device = dev;
@@ -182,12 +280,39 @@ public:
     return true;
 }
     
-    Model load(const std::string& path) {
-        Model model;
-        tempBoneMap.clear();
-        tempBones.clear();
+    // Import and upload in one go (blocks on the GPU copy)
+    Model load(const std::string& path, bool buildCollisionMesh = false) {
+        ModelImport imported;
+        if (!import(path, imported, buildCollisionMesh)) return std::move(imported.model);
+        
+        std::vector<Model> models = upload({&imported});
+        Model& model = models[0];
+        
+        std::cout << "Loaded: " << path << std::endl;
+        std::cout << "  Vertices: " << model.vertices.size() << std::endl;
+        std::cout << "  Indices: " << model.indices.size() << std::endl;
+        std::cout << "  Submeshes: " << model.submeshes.size() << std::endl;
+        std::cout << "  Materials: " << model.materials.size() << std::endl;
+        std::cout << "  Textures: " << model.textures.size() << std::endl;
+        std::cout << "  Bones: " << model.bones.size() << std::endl;
+        std::cout << "  Animations: " << model.animations.size() << std::endl;
+        if (model.collisionMesh) {
+            std::cout << "  Collision: " << model.collisionMesh->getTriangleCount() << " triangles, "
+                      << model.collisionMesh->getNodeCount() << " BVH nodes" << std::endl;
+        }
+        
+        return std::move(model);
+    }
+    
+    // CPU-side import: parse the file and decode its textures. Touches no
+    // Vulkan state, so several imports may run on worker threads at once.
+    bool import(const std::string& path, ModelImport& out, bool buildCollisionMesh = false) {
+        out = ModelImport{};
+        out.path = path;
+        Model& model = out.model;
         
         Assimp::Importer importer;
+        importer.SetIOHandler(new VFSIOSystem()); // Owned by the importer
         importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
        unsigned int flags = 
     aiProcess_Triangulate |
@@ -203,7 +328,7 @@ public:
         
         if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
             std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
-            return model;
+            return false;
         }
         
         std::string baseDir = std::filesystem::path(path).parent_path().string();
@@ -211,42 +336,82 @@ public:
         
         model.globalInverseTransform = glm::inverse(aiToGlm(scene->mRootNode->mTransformation));
         
-        loadMaterials(scene, baseDir, model);
+        loadMaterials(scene, baseDir, out);
         
         // First pass: collect all bones
-        collectBones(scene);
+        collectBones(scene, model);
         
         // Build bone hierarchy
-        buildBoneHierarchy(scene->mRootNode, -1);
-        
-        // Copy to model
-        model.bones = tempBones;
-        model.boneMap = tempBoneMap;
+        buildBoneHierarchy(scene->mRootNode, -1, model);
         
         // Process meshes
         processNode(scene->mRootNode, scene, model, glm::mat4(1.0f));
         
         loadAnimations(scene, model);
+        model.linkChannels();
         
-        createBuffers(model);
-        createDescriptorSet(model);
+        if (buildCollisionMesh) {
+            model.collisionMesh = TriangleMeshShape::fromVertices(model.vertices, model.indices);
+        }
         
-        model.combinedVertexBuffer = model.vertexBuffer;
-        model.combinedIndexBuffer = model.indexBuffer;
-        model.combinedVertexAllocation = model.vertexAllocation;
-        model.combinedIndexAllocation = model.indexAllocation;
-        model.totalIndices = static_cast<uint32_t>(model.indices.size());
+        return out.valid();
+    }
+    
+    // Texture files import(path) would read, without decoding them or
+    // processing the meshes. For recording dependencies at cook time.
+    bool dependencies(const std::string& path, std::vector<std::string>& textures) {
+        Assimp::Importer importer;
+        importer.SetIOHandler(new VFSIOSystem());
+        const aiScene* scene = importer.ReadFile(path, 0);
+        if (!scene || !scene->mRootNode) {
+            std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
+            return false;
+        }
         
-        std::cout << "Loaded: " << path << std::endl;
-        std::cout << "  Vertices: " << model.vertices.size() << std::endl;
-        std::cout << "  Indices: " << model.indices.size() << std::endl;
-        std::cout << "  Submeshes: " << model.submeshes.size() << std::endl;
-        std::cout << "  Materials: " << model.materials.size() << std::endl;
-        std::cout << "  Textures: " << model.textures.size() << std::endl;
-        std::cout << "  Bones: " << model.bones.size() << std::endl;
-        std::cout << "  Animations: " << model.animations.size() << std::endl;
+        std::string baseDir = std::filesystem::path(path).parent_path().string();
+        if (!baseDir.empty()) baseDir += "/";
+        textures = texturePaths(scene, baseDir);
+        return true;
+    }
+    
+    // GPU half: one Model per entry (an import may be listed several times
+    // to get independent instances). Every buffer and texture copy is
+    // recorded into a single command buffer with one submit and one wait.
+    // Must run on the thread that owns the command pool and queue.
+    std::vector<Model> upload(const std::vector<const ModelImport*>& imports) {
+        std::vector<Model> models;
+        models.reserve(imports.size());
+        
+        std::vector<StagingBuffer> staging;
+        VkCommandBuffer cmd = beginSingleTimeCommands();
         
-        return model;
+        for (const ModelImport* imported : imports) {
+            models.push_back(imported->model);
+            Model& model = models.back();
+            
+            model.textures.resize(imported->images.size());
+            for (size_t i = 0; i < imported->images.size(); i++) {
+                const DecodedImage& image = imported->images[i];
+                recordTextureImage(image.pixels.data(), image.width, image.height, model.textures[i], cmd, staging);
+                model.textures[i].path = image.path;
+            }
+            
+            recordBuffers(model, cmd, staging);
+        }
+        
+        endSingleTimeCommands(cmd);
+        for (auto& buffer : staging) vmaDestroyBuffer(allocator, buffer.buffer, buffer.allocation);
+        
+        for (Model& model : models) {
+            createDescriptorSet(model);
+            
+            model.combinedVertexBuffer = model.vertexBuffer;
+            model.combinedIndexBuffer = model.indexBuffer;
+            model.combinedVertexAllocation = model.vertexAllocation;
+            model.combinedIndexAllocation = model.indexAllocation;
+            model.totalIndices = static_cast<uint32_t>(model.indices.size());
+        }
+        return models;
     }
     
     void cleanup(Model& model) {
@@ -293,46 +458,84 @@ private:
     glm::quat aiToGlm(const aiQuaternion& q) { return glm::quat(q.w, q.x, q.y, q.z); }
     glm::vec4 aiToGlm(const aiColor4D& c) { return glm::vec4(c.r, c.g, c.b, c.a); }
     
-    void collectBones(const aiScene* scene) {
+    void collectBones(const aiScene* scene, Model& model) {
         for (unsigned int m = 0; m < scene->mNumMeshes; m++) {
             aiMesh* mesh = scene->mMeshes[m];
             
             for (unsigned int b = 0; b < mesh->mNumBones; b++) {
                 aiBone* bone = mesh->mBones[b];
                 std::string boneName = bone->mName.C_Str();
+                Name boneId(boneName);
                 
-                if (tempBoneMap.find(boneName) == tempBoneMap.end()) {
-                    int boneIndex = static_cast<int>(tempBones.size());
-                    tempBoneMap[boneName] = boneIndex;
+                if (model.boneMap.find(boneId) == model.boneMap.end()) {
+                    int boneIndex = static_cast<int>(model.bones.size());
+                    model.boneMap[boneId] = boneIndex;
                     
                     BoneInfo boneInfo;
                     boneInfo.name = boneName;
+                    boneInfo.id = boneId;
                     boneInfo.offset = aiToGlm(bone->mOffsetMatrix);
                     boneInfo.parentIndex = -1;
-                    tempBones.push_back(boneInfo);
+                    model.bones.push_back(boneInfo);
                 }
             }
         }
     }
     
-    void buildBoneHierarchy(aiNode* node, int parentBoneIndex) {
+    void buildBoneHierarchy(aiNode* node, int parentBoneIndex, Model& model) {
         std::string nodeName = node->mName.C_Str();
         int currentBoneIndex = -1;
         
-        auto it = tempBoneMap.find(nodeName);
-        if (it != tempBoneMap.end()) {
+        auto it = model.boneMap.find(Name(nodeName));
+        if (it != model.boneMap.end()) {
             currentBoneIndex = it->second;
-            tempBones[currentBoneIndex].parentIndex = parentBoneIndex;
+            model.bones[currentBoneIndex].parentIndex = parentBoneIndex;
         }
         
         int nextParent = (currentBoneIndex != -1) ? currentBoneIndex : parentBoneIndex;
         
         for (unsigned int i = 0; i < node->mNumChildren; i++) {
-            buildBoneHierarchy(node->mChildren[i], nextParent);
+            buildBoneHierarchy(node->mChildren[i], nextParent, model);
+        }
+    }
+    
+    // External texture files being read, by full path
+    using TextureFiles = std::unordered_map<std::string, AsyncIO::Ticket>;
+    
+    // Distinct external texture files the materials use (embedded ones,
+    // "*0" and so on, are part of the model file)
+    static std::vector<std::string> texturePaths(const aiScene* scene, const std::string& baseDir) {
+        static const aiTextureType types[] = {
+            aiTextureType_DIFFUSE, aiTextureType_NORMALS, aiTextureType_METALNESS, aiTextureType_EMISSIVE
+        };
+        std::vector<std::string> paths;
+        for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
+            for (aiTextureType type : types) {
+                aiString texPath;
+                if (scene->mMaterials[i]->GetTexture(type, 0, &texPath) != AI_SUCCESS) continue;
+                if (texPath.length == 0 || texPath.C_Str()[0] == '*') continue;
+                std::string fullPath = baseDir + texPath.C_Str();
+                if (std::find(paths.begin(), paths.end(), fullPath) != paths.end()) continue;
+                paths.push_back(fullPath);
+            }
         }
+        return paths;
     }
     
-    void loadMaterials(const aiScene* scene, const std::string& baseDir, Model& model) {
+    // Start reading every texture file the materials use before decoding
+    // the first, so the reads overlap each other and the decodes
+    TextureFiles prefetchTextures(const aiScene* scene, const std::string& baseDir) {
+        std::vector<std::string> paths = texturePaths(scene, baseDir);
+        
+        TextureFiles files;
+        std::vector<AsyncIO::Ticket> tickets = VFS::FileSystem::get().readBatch(paths);
+        for (size_t i = 0; i < paths.size(); i++) files.emplace(paths[i], std::move(tickets[i]));
+        return files;
+    }
+    
+    void loadMaterials(const aiScene* scene, const std::string& baseDir, ModelImport& out) {
+        Model& model = out.model;
+        TextureFiles files = prefetchTextures(scene, baseDir);
         for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
             aiMaterial* mat = scene->mMaterials[i];
             MaterialData material;
@@ -360,16 +563,16 @@ private:
             
             aiString texPath;
             if (mat->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS) {
-                material.albedoTexture = loadTexture(scene, baseDir, texPath.C_Str(), model);
+                material.albedoTexture = loadTexture(scene, baseDir, texPath.C_Str(), out, files);
             }
             if (mat->GetTexture(aiTextureType_NORMALS, 0, &texPath) == AI_SUCCESS) {
-                material.normalTexture = loadTexture(scene, baseDir, texPath.C_Str(), model);
+                material.normalTexture = loadTexture(scene, baseDir, texPath.C_Str(), out, files);
             }
             if (mat->GetTexture(aiTextureType_METALNESS, 0, &texPath) == AI_SUCCESS) {
-                material.metallicRoughnessTexture = loadTexture(scene, baseDir, texPath.C_Str(), model);
+                material.metallicRoughnessTexture = loadTexture(scene, baseDir, texPath.C_Str(), out, files);
             }
             if (mat->GetTexture(aiTextureType_EMISSIVE, 0, &texPath) == AI_SUCCESS) {
-                material.emissiveTexture = loadTexture(scene, baseDir, texPath.C_Str(), model);
+                material.emissiveTexture = loadTexture(scene, baseDir, texPath.C_Str(), out, files);
             }
             
             model.materials.push_back(material);
@@ -380,74 +583,89 @@ private:
         }
     }
     
-    int loadTexture(const aiScene* scene, const std::string& baseDir, const char* path, Model& model) {
+    int loadTexture(const aiScene* scene, const std::string& baseDir, const char* path, ModelImport& out,
+                    TextureFiles& files) {
         std::string texPath = path;
         
         if (texPath[0] == '*') {
             int texIndex = std::stoi(texPath.substr(1));
             if (texIndex < (int)scene->mNumTextures) {
                 aiTexture* tex = scene->mTextures[texIndex];
-                Texture texture = loadEmbeddedTexture(tex);
-                if (texture.image) {
-                    model.textures.push_back(texture);
-                    return (int)model.textures.size() - 1;
+                DecodedImage image;
+                if (decodeEmbeddedTexture(tex, image)) {
+                    out.images.push_back(std::move(image));
+                    return (int)out.images.size() - 1;
                 }
             }
             return -1;
         }
         
         std::string fullPath = baseDir + texPath;
-        for (size_t i = 0; i < model.textures.size(); i++) {
-            if (model.textures[i].path == fullPath) return (int)i;
+        for (size_t i = 0; i < out.images.size(); i++) {
+            if (out.images[i].path == fullPath) return (int)i;
         }
         
-        Texture texture = loadTextureFile(fullPath);
-        if (texture.image) {
-            texture.path = fullPath;
-            model.textures.push_back(texture);
-            return (int)model.textures.size() - 1;
+        DecodedImage image;
+        if (decodeTextureFile(fullPath, image, files)) {
+            image.path = fullPath;
+            out.images.push_back(std::move(image));
+            return (int)out.images.size() - 1;
         }
         return -1;
     }
     
-    Texture loadEmbeddedTexture(aiTexture* tex) {
-        Texture texture;
-        
-        const unsigned char* data;
-        int width, height, channels;
-        
+    bool decodeEmbeddedTexture(aiTexture* tex, DecodedImage& image) {
         if (tex->mHeight == 0) {
-            data = stbi_load_from_memory(
+            int channels;
+            unsigned char* data = stbi_load_from_memory(
                 reinterpret_cast<const unsigned char*>(tex->pcData),
-                tex->mWidth, &width, &height, &channels, 4);
+                tex->mWidth, &image.width, &image.height, &channels, 4);
+            if (!data) return false;
+            image.pixels.assign(data, data + size_t(image.width) * image.height * 4);
+            stbi_image_free(data);
         } else {
-            width = tex->mWidth;
-            height = tex->mHeight;
-            channels = 4;
-            data = reinterpret_cast<const unsigned char*>(tex->pcData);
-        }
-        
-        if (data) {
-            createTextureImage(data, width, height, texture);
-            if (tex->mHeight == 0) stbi_image_free((void*)data);
+            // Uncompressed aiTexel (BGRA) data, copied as is like before
+            image.width = tex->mWidth;
+            image.height = tex->mHeight;
+            const unsigned char* data = reinterpret_cast<const unsigned char*>(tex->pcData);
+            image.pixels.assign(data, data + size_t(image.width) * image.height * 4);
         }
-        
-        return texture;
+        return true;
     }
     
-    Texture loadTextureFile(const std::string& path) {
-        Texture texture;
-        int width, height, channels;
-        unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
-        if (data) {
-            createTextureImage(data, width, height, texture);
-            stbi_image_free(data);
+    bool decodeTextureFile(const std::string& path, DecodedImage& image, TextureFiles& files) {
+        AsyncIO::Buffer file;
+        auto found = files.find(path);
+        if (found != files.end()) {
+            AsyncIO::ReadResult& result = found->second.wait();
+            if (!result.ok()) return false;
+            file = std::move(result.buffer);
+        } else if (!VFS::readFile(path, file)) {
+            return false;
         }
-        return texture;
+        
+        int channels;
+        unsigned char* data = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+                                                    &image.width, &image.height, &channels, 4);
+        if (!data) return false;
+        image.pixels.assign(data, data + size_t(image.width) * image.height * 4);
+        stbi_image_free(data);
+        return true;
     }
     
    void createTextureImage(const unsigned char* data, int width, int height, Texture& texture) {
-    VkDeviceSize imageSize = width * height * 4;
+    std::vector<StagingBuffer> staging;
+    VkCommandBuffer cmd = beginSingleTimeCommands();
+    recordTextureImage(data, width, height, texture, cmd, staging);
+    endSingleTimeCommands(cmd);
+    for (auto& buffer : staging) vmaDestroyBuffer(allocator, buffer.buffer, buffer.allocation);
+}
+    
+    // Create the image, view and sampler and record the pixel copy into cmd;
+    // the staging buffer is appended to staging and must outlive the submit
+   void recordTextureImage(const unsigned char* data, int width, int height, Texture& texture,
+                           VkCommandBuffer cmd, std::vector<StagingBuffer>& staging) {
+    VkDeviceSize imageSize = VkDeviceSize(width) * height * 4;
     
     VkBuffer stagingBuffer;
     VmaAllocation stagingAlloc;
@@ -492,8 +710,7 @@ private:
         vmaDestroyBuffer(allocator, stagingBuffer, stagingAlloc);
         return;
     }
-    
-    VkCommandBuffer cmd = beginSingleTimeCommands();
+    staging.push_back({stagingBuffer, stagingAlloc});
     
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -530,10 +747,6 @@ private:
     vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
         0, 0, nullptr, 0, nullptr, 1, &barrier);
     
-    endSingleTimeCommands(cmd);
-    
-    vmaDestroyBuffer(allocator, stagingBuffer, stagingAlloc);
-    
     // Create image view
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -628,7 +841,7 @@ private:
             std::string boneName = bone->mName.C_Str();
             
             int boneIndex = -1;
-            auto it = model.boneMap.find(boneName);
+            auto it = model.boneMap.find(Name(boneName));
             if (it != model.boneMap.end()) {
                 boneIndex = it->second;
             } else {
@@ -706,6 +919,7 @@ private:
             // Get or create channel for this bone
             auto& ch = channelMap[baseName];
             ch.nodeName = baseName;
+            ch.node = Name(baseName);
             
             // Only add position keys if this is a Translation channel or regular channel
             if (suffix.empty() || suffix == "Translation") {
@@ -747,62 +961,56 @@ private:
     }
 }
     
-    void createBuffers(Model& model) {
+    // Create the device-local vertex/index buffers and record their copies
+    void recordBuffers(Model& model, VkCommandBuffer cmd, std::vector<StagingBuffer>& staging) {
         if (model.vertices.empty()) return;
         
         VkDeviceSize vbSize = model.vertices.size() * sizeof(Vertex);
-        VkBuffer stagingVB;
-        VmaAllocation stagingVBAlloc;
+        stageBuffer(model.vertices.data(), vbSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                    model.vertexBuffer, model.vertexAllocation, cmd, staging);
+        
+        VkDeviceSize ibSize = model.indices.size() * sizeof(uint32_t);
+        stageBuffer(model.indices.data(), ibSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                    model.indexBuffer, model.indexAllocation, cmd, staging);
+    }
+    
+    void stageBuffer(const void* src, VkDeviceSize size, VkBufferUsageFlags usage,
+                     VkBuffer& buffer, VmaAllocation& allocation,
+                     VkCommandBuffer cmd, std::vector<StagingBuffer>& staging) {
+        if (size == 0) return;
+        
+        StagingBuffer stage;
         
         VkBufferCreateInfo bufferInfo{};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = vbSize;
+        bufferInfo.size = size;
         bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         
         VmaAllocationCreateInfo allocInfo{};
         allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-        vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &stagingVB, &stagingVBAlloc, nullptr);
+        if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &stage.buffer, &stage.allocation, nullptr) != VK_SUCCESS) {
+            std::cerr << "Failed to create staging buffer" << std::endl;
+            return;
+        }
+        staging.push_back(stage);
         
         void* data;
-        vmaMapMemory(allocator, stagingVBAlloc, &data);
-        memcpy(data, model.vertices.data(), vbSize);
-        vmaUnmapMemory(allocator, stagingVBAlloc);
+        vmaMapMemory(allocator, stage.allocation, &data);
+        memcpy(data, src, size);
+        vmaUnmapMemory(allocator, stage.allocation);
         
-        bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
         allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-        vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &model.vertexBuffer, &model.vertexAllocation, nullptr);
-        
-        VkDeviceSize ibSize = model.indices.size() * sizeof(uint32_t);
-        VkBuffer stagingIB;
-        VmaAllocation stagingIBAlloc;
-        
-        bufferInfo.size = ibSize;
-        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-        vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &stagingIB, &stagingIBAlloc, nullptr);
-        
-        vmaMapMemory(allocator, stagingIBAlloc, &data);
-        memcpy(data, model.indices.data(), ibSize);
-        vmaUnmapMemory(allocator, stagingIBAlloc);
-        
-        bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-        vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &model.indexBuffer, &model.indexAllocation, nullptr);
-        
-        VkCommandBuffer cmd = beginSingleTimeCommands();
+        if (vmaCreateBuffer(allocator, &bufferInfo, &allocInfo, &buffer, &allocation, nullptr) != VK_SUCCESS) {
+            std::cerr << "Failed to create device buffer" << std::endl;
+            buffer = VK_NULL_HANDLE;
+            return;
+        }
         
         VkBufferCopy copyRegion{};
-        copyRegion.size = vbSize;
-        vkCmdCopyBuffer(cmd, stagingVB, model.vertexBuffer, 1, &copyRegion);
-        
-        copyRegion.size = ibSize;
-        vkCmdCopyBuffer(cmd, stagingIB, model.indexBuffer, 1, &copyRegion);
-        
-        endSingleTimeCommands(cmd);
-        
-        vmaDestroyBuffer(allocator, stagingVB, stagingVBAlloc);
-        vmaDestroyBuffer(allocator, stagingIB, stagingIBAlloc);
+        copyRegion.size = size;
+        vkCmdCopyBuffer(cmd, stage.buffer, buffer, 1, &copyRegion);
     }
     
  
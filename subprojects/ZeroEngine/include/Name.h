@@ -0,0 +1,192 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+// Interned names
+//
+// A Name is the 64-bit FNV-1a hash of a string: tags, bone and channel
+// names, animation parameters, material properties and event payload keys
+// compare and hash as one integer instead of a string. The hash depends
+// only on the text, so IDs are the same across runs and machines and can
+// be stored in binary data as they are; literals hash at compile time
+// ("Player"_name). id32() folds the ID for tables that want 32 bits.
+//
+// NameRegistry remembers the text behind IDs for reverse lookup. Debug
+// builds (no NDEBUG) record every Name made from a runtime string and
+// report hash collisions; release builds only record what's interned
+// explicitly (intern(), or a loaded string table), so making a Name is
+// just hashing.
+
+using NameId = uint64_t;
+
+constexpr NameId hashName(std::string_view text) {
+    if (text.empty()) return 0;     // The empty name is 0, like a default Name
+    NameId hash = 14695981039346656037ull;
+    for (char c : text) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash ? hash : 1;
+}
+
+class NameRegistry {
+public:
+    static NameRegistry& get() {
+        static NameRegistry registry;
+        return registry;
+    }
+
+    // Record text for reverse lookup; false (and reported) if a different
+    // string already has its ID
+    bool intern(std::string_view text, NameId id) {
+        if (id == 0) return true;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = names.find(id);
+            if (it != names.end()) return matches(it->second, text, id);
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto inserted = names.emplace(id, std::string(text));
+        return inserted.second || matches(inserted.first->second, text, id);
+    }
+
+    NameId intern(std::string_view text) {
+        NameId id = hashName(text);
+        intern(text, id);
+        return id;
+    }
+
+    bool lookup(NameId id, std::string& text) const {
+        if (id == 0) {
+            text.clear();
+            return true;
+        }
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = names.find(id);
+        if (it == names.end()) return false;
+        text = it->second;
+        return true;
+    }
+
+    // The text, or "#<hex id>" for IDs never interned
+    std::string str(NameId id) const {
+        std::string text;
+        if (lookup(id, text)) return text;
+        static const char* digits = "0123456789abcdef";
+        text = "#";
+        for (int shift = 60; shift >= 0; shift -= 4) text += digits[(id >> shift) & 0xF];
+        return text;
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return names.size();
+    }
+
+    // === String tables ===
+    //
+    // The text of some IDs, for files that store Names as IDs but want
+    // them readable after loading (tools, debug builds).
+    // Layout: count u32 | {id u64 | length u16 | chars}. Unknown IDs are skipped.
+
+    std::vector<uint8_t> serialize(const std::vector<NameId>& ids) const {
+        std::vector<uint8_t> out(sizeof(uint32_t));
+        uint32_t count = 0;
+        std::string text;
+        for (NameId id : ids) {
+            if (id == 0 || !lookup(id, text) || text.size() > UINT16_MAX) continue;
+            uint16_t length = static_cast<uint16_t>(text.size());
+            size_t at = out.size();
+            out.resize(at + sizeof(id) + sizeof(length) + length);
+            std::memcpy(out.data() + at, &id, sizeof(id));
+            std::memcpy(out.data() + at + sizeof(id), &length, sizeof(length));
+            std::memcpy(out.data() + at + sizeof(id) + sizeof(length), text.data(), length);
+            count++;
+        }
+        std::memcpy(out.data(), &count, sizeof(count));
+        return out;
+    }
+
+    // False if the table is corrupt or an entry doesn't hash to its ID
+    bool deserialize(const uint8_t* data, size_t size) {
+        uint32_t count = 0;
+        if (size < sizeof(count)) return false;
+        std::memcpy(&count, data, sizeof(count));
+        size_t offset = sizeof(count);
+        for (uint32_t i = 0; i < count; i++) {
+            NameId id = 0;
+            uint16_t length = 0;
+            if (size - offset < sizeof(id) + sizeof(length)) return false;
+            std::memcpy(&id, data + offset, sizeof(id));
+            std::memcpy(&length, data + offset + sizeof(id), sizeof(length));
+            offset += sizeof(id) + sizeof(length);
+            if (size - offset < length) return false;
+            std::string_view text(reinterpret_cast<const char*>(data + offset), length);
+            offset += length;
+            if (hashName(text) != id || !intern(text, id)) return false;
+        }
+        return offset == size;
+    }
+
+private:
+    mutable std::shared_mutex mutex;
+    std::unordered_map<NameId, std::string> names;
+
+    static bool matches(const std::string& existing, std::string_view text, NameId id) {
+        if (existing == text) return true;
+        std::cerr << "✗ Name hash collision: \"" << existing << "\" and \"" << text << "\" (" << id << ")" << std::endl;
+        return false;
+    }
+};
+
+struct Name {
+    NameId id = 0;
+
+    constexpr Name() = default;
+
+    // From runtime text; recorded for reverse lookup in debug builds
+    Name(std::string_view text) : id(hashName(text)) {
+#ifndef NDEBUG
+        NameRegistry::get().intern(text, id);
+#endif
+    }
+    Name(const std::string& text) : Name(std::string_view(text)) {}
+    Name(const char* text) : Name(std::string_view(text)) {}
+
+    static constexpr Name fromId(NameId id) {
+        Name name;
+        name.id = id;
+        return name;
+    }
+
+    // Always recorded, for names whose text is needed later (saving, UI)
+    static Name intern(std::string_view text) { return fromId(NameRegistry::get().intern(text)); }
+
+    constexpr bool empty() const { return id == 0; }
+    constexpr uint32_t id32() const { return static_cast<uint32_t>(id ^ (id >> 32)); }
+
+    std::string str() const { return NameRegistry::get().str(id); }
+
+    constexpr bool operator==(const Name& other) const { return id == other.id; }
+    constexpr bool operator!=(const Name& other) const { return id != other.id; }
+    constexpr bool operator<(const Name& other) const { return id < other.id; }
+};
+
+// Compile-time Name of a literal: "Player"_name
+constexpr Name operator""_name(const char* text, size_t length) {
+    return Name::fromId(hashName(std::string_view(text, length)));
+}
+
+namespace std {
+    template<>
+    struct hash<Name> {
+        size_t operator()(const Name& name) const { return static_cast<size_t>(name.id); }
+    };
+}
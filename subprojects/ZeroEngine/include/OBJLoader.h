@@ -1,5 +1,6 @@
 #pragma once
 #include "Pipeline.h"
+#include "VirtualFileSystem.h"
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -48,11 +49,12 @@ struct VertexTextured {
 class OBJLoader {
 public:
     static bool loadOBJ(const std::string& filepath, std::vector<VertexTextured>& vertices) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
+        std::string text;
+        if (!VFS::readText(filepath, text)) {
             std::cerr << "Failed to open OBJ file: " << filepath << std::endl;
             return false;
         }
+        std::istringstream file(text);
         
         std::vector<glm::vec3> positions;
         std::vector<glm::vec2> texCoords;
@@ -117,8 +119,6 @@ public:
             }
         }
         
-        file.close();
-        
         if (vertices.empty()) {
             std::cerr << "No vertices loaded from OBJ file!" << std::endl;
             return false;
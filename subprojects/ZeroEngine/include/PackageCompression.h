@@ -0,0 +1,491 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+
+// Codecs are optional; meson defines these when the library is found
+#ifdef USE_COMPRESSION
+#include <zlib.h>
+#endif
+#ifdef USE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ScenePackage {
+
+enum class CompressionType : uint8_t {
+    None = 0,
+    Deflate = 1,    // zlib/deflate, one stream per resource
+    LZ4 = 2,        // Fast decompression, chunked
+    Zstd = 3        // Best ratio, chunked
+};
+
+/*
+ * Chunked resource layout (LZ4 and Zstd):
+ *   - ChunkSize: uint32 - uncompressed bytes per chunk (last may be shorter)
+ *   - ChunkCount: uint32
+ *   - StoredSizes: uint32[ChunkCount] - high bit set = chunk stored raw
+ *   - Chunk data, back to back
+ *
+ * Chunks are compressed independently, so they decode in parallel and a
+ * streaming consumer only ever needs one chunk of scratch memory.
+ */
+// What the last compress() of one resource produced, so an unchanged chunk
+// (same raw bytes, same settings) can be reused instead of re-encoded.
+// Keep one per resource across saves; it's rebuilt when settings change.
+struct ChunkCache {
+    CompressionType type = CompressionType::None;
+    int level = 0;
+    uint32_t chunkSize = 0;
+    std::vector<uint64_t> hashes;               // Raw bytes, per chunk
+    std::vector<size_t> rawSizes;
+    std::vector<std::vector<uint8_t>> chunks;   // Stored bytes, per chunk
+    std::vector<uint32_t> entries;              // Chunk table entries
+    size_t reused = 0;                          // Last compress(): chunks taken from the cache
+    size_t encoded = 0;                         // Last compress(): chunks compressed
+};
+
+class ChunkedCodec {
+public:
+    static constexpr uint32_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+    static constexpr uint32_t RAW_CHUNK = 0x80000000u;
+    static constexpr size_t PARALLEL_MIN_CHUNKS = 4; // Below this, threads cost more than they save
+
+    // Run fn(i) for i in [0, count), striped across threads (0 = hardware concurrency).
+    // Shared with checksum verification. Helpers come from a pool started on
+    // first use; the caller works too, and never waits on a helper that
+    // hasn't started, so nested calls can't deadlock the pool.
+    template<typename Fn>
+    static void parallelFor(size_t count, unsigned threads, Fn&& fn) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        // Helpers that outlive this call find next >= count and never touch fn
+        auto job = std::make_shared<Job>();
+        job->count = count;
+        job->fn = [&fn](size_t i) { fn(i); };
+        WorkerPool& pool = workerPool();
+        unsigned helpers = std::min<unsigned>(threads - 1, pool.size());
+        for (unsigned t = 0; t < helpers; ++t) {
+            pool.submit([job] {
+                {
+                    std::lock_guard<std::mutex> lock(job->mutex);
+                    job->active++;
+                }
+                job->run();
+                std::lock_guard<std::mutex> lock(job->mutex);
+                if (--job->active == 0) job->idle.notify_all();
+            });
+        }
+
+        job->run();
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->idle.wait(lock, [&] { return job->active == 0; });
+    }
+
+    static bool isAvailable(CompressionType type) {
+        switch (type) {
+            case CompressionType::None: return true;
+            #ifdef USE_COMPRESSION
+            case CompressionType::Deflate: return true;
+            #endif
+            #ifdef USE_LZ4
+            case CompressionType::LZ4: return true;
+            #endif
+            #ifdef USE_ZSTD
+            case CompressionType::Zstd: return true;
+            #endif
+            default: return false;
+        }
+    }
+
+    static bool isChunked(CompressionType type) {
+        return type == CompressionType::LZ4 || type == CompressionType::Zstd;
+    }
+
+    // Default level per codec: fast LZ4 (0), Zstd 3, Deflate 6. Cheap enough
+    // for autosave and editor saves.
+    static int defaultLevel(CompressionType type) {
+        return type == CompressionType::Zstd ? 3 : (type == CompressionType::LZ4 ? 0 : 6);
+    }
+
+    // Opt-in for offline packaging (PackageWriter::setCompressionLevel):
+    // LZ4 HC 9, Zstd 19. Several times slower to encode, no slower to load.
+    static int highLevel(CompressionType type) {
+        return type == CompressionType::Zstd ? 19 : 9;
+    }
+
+    // Compressed form of data, or empty when the codec is unavailable or the
+    // result would not be smaller. threads = 0 uses every core. With a cache
+    // from the previous compress() of the same resource, chunks whose bytes
+    // haven't changed are reused rather than compressed again.
+    static std::vector<uint8_t> compress(const uint8_t* data, size_t size, CompressionType type,
+                                         int level = -1, uint32_t chunkSize = DEFAULT_CHUNK_SIZE,
+                                         unsigned threads = 0, ChunkCache* cache = nullptr) {
+        if (size == 0 || !isAvailable(type) || type == CompressionType::None) return {};
+        if (level < 0) level = defaultLevel(type);
+        if (!isChunked(type)) chunkSize = static_cast<uint32_t>(std::min<size_t>(size, RAW_CHUNK - 1));
+        chunkSize = std::max<uint32_t>(std::min<uint32_t>(chunkSize, RAW_CHUNK - 1), 4096);
+        
+        if (cache && (cache->type != type || cache->level != level || cache->chunkSize != chunkSize)) {
+            *cache = ChunkCache{};
+            cache->type = type;
+            cache->level = level;
+            cache->chunkSize = chunkSize;
+        }
+        
+        if (!isChunked(type)) {
+            // One stream: reuse it only if the whole resource is unchanged
+            uint64_t hash = cache ? hashBytes(data, size) : 0;
+            if (cache && cache->hashes.size() == 1 && cache->hashes[0] == hash && cache->rawSizes[0] == size) {
+                cache->reused = 1;
+                cache->encoded = 0;
+                return cache->chunks[0];
+            }
+            std::vector<uint8_t> out = compressDeflate(data, size, level);
+            if (cache) {
+                cache->hashes.assign(1, hash);
+                cache->rawSizes.assign(1, size);
+                cache->chunks.assign(1, out);
+                cache->entries.assign(1, 0);
+                cache->reused = 0;
+                cache->encoded = 1;
+            }
+            return out;
+        }
+
+        size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+        if (chunkCount > UINT32_MAX) return {};
+
+        std::vector<std::vector<uint8_t>> chunks(chunkCount);
+        std::vector<uint32_t> table(2 + chunkCount);
+        std::vector<uint64_t> hashes(cache ? chunkCount : 0);
+        std::atomic<bool> ok{true};
+        std::atomic<size_t> reused{0};
+        parallelFor(chunkCount, chunkCount >= 2 ? threads : 1, [&](size_t i) {
+            size_t begin = i * chunkSize;
+            size_t length = std::min<size_t>(chunkSize, size - begin);
+            
+            if (cache) {
+                hashes[i] = hashBytes(data + begin, length);
+                if (i < cache->hashes.size() && cache->hashes[i] == hashes[i] && cache->rawSizes[i] == length) {
+                    chunks[i] = cache->chunks[i];
+                    table[2 + i] = cache->entries[i];
+                    reused++;
+                    return;
+                }
+            }
+            
+            chunks[i] = compressChunk(data + begin, length, type, level);
+            if (chunks[i].empty()) {
+                ok = false;
+            } else if (chunks[i].size() >= length) {
+                // Incompressible chunk: keep the raw bytes
+                chunks[i].assign(data + begin, data + begin + length);
+                table[2 + i] = static_cast<uint32_t>(length) | RAW_CHUNK;
+            } else {
+                table[2 + i] = static_cast<uint32_t>(chunks[i].size());
+            }
+        });
+        if (!ok) return {};
+
+        table[0] = chunkSize;
+        table[1] = static_cast<uint32_t>(chunkCount);
+        size_t total = table.size() * sizeof(uint32_t);
+        for (const auto& chunk : chunks) total += chunk.size();
+        
+        if (cache) {
+            cache->hashes = std::move(hashes);
+            cache->rawSizes.resize(chunkCount);
+            for (size_t i = 0; i < chunkCount; ++i) cache->rawSizes[i] = std::min<size_t>(chunkSize, size - i * chunkSize);
+            cache->chunks = chunks;
+            cache->entries.assign(table.begin() + 2, table.end());
+            cache->reused = reused;
+            cache->encoded = chunkCount - reused;
+        }
+        if (total >= size) return {};
+
+        std::vector<uint8_t> out(total);
+        uint8_t* cursor = out.data();
+        std::memcpy(cursor, table.data(), table.size() * sizeof(uint32_t));
+        cursor += table.size() * sizeof(uint32_t);
+        for (const auto& chunk : chunks) {
+            std::memcpy(cursor, chunk.data(), chunk.size());
+            cursor += chunk.size();
+        }
+        return out;
+    }
+
+    // Decode straight into caller memory (e.g. a mapped staging buffer);
+    // dstSize must be the original size. threads = 0 uses every core.
+    static bool decompressInto(const uint8_t* stored, size_t storedSize, CompressionType type,
+                               uint8_t* dst, size_t dstSize, unsigned threads = 0) {
+        if (type == CompressionType::None) {
+            if (storedSize != dstSize) return false;
+            std::memcpy(dst, stored, dstSize);
+            return true;
+        }
+        if (!isAvailable(type)) return false;
+        if (!isChunked(type)) return decompressDeflate(stored, storedSize, dst, dstSize);
+
+        std::vector<Chunk> chunks;
+        if (!parseChunks(stored, storedSize, dstSize, chunks)) return false;
+
+        std::atomic<bool> ok{true};
+        parallelFor(chunks.size(), chunks.size() >= PARALLEL_MIN_CHUNKS ? threads : 1, [&](size_t i) {
+            if (!decodeChunk(chunks[i], type, dst + chunks[i].rawOffset)) ok = false;
+        });
+        return ok;
+    }
+
+    static std::vector<uint8_t> decompress(const uint8_t* stored, size_t storedSize, CompressionType type,
+                                           size_t originalSize, unsigned threads = 0) {
+        std::vector<uint8_t> out(originalSize);
+        if (!decompressInto(stored, storedSize, type, out.data(), out.size(), threads)) return {};
+        return out;
+    }
+
+    // Decode one chunk at a time into a reused scratch buffer:
+    // fn(uint64_t rawOffset, const uint8_t* bytes, size_t size) -> bool (false stops).
+    // Bounded memory for streaming uploads; Deflate/None arrive as one piece.
+    static bool decompressChunks(const uint8_t* stored, size_t storedSize, CompressionType type,
+                                 size_t originalSize,
+                                 const std::function<bool(uint64_t, const uint8_t*, size_t)>& fn) {
+        if (!isChunked(type)) {
+            if (type == CompressionType::None) {
+                return storedSize == originalSize && fn(0, stored, storedSize);
+            }
+            std::vector<uint8_t> whole = decompress(stored, storedSize, type, originalSize, 1);
+            return !whole.empty() && fn(0, whole.data(), whole.size());
+        }
+        if (!isAvailable(type)) return false;
+
+        std::vector<Chunk> chunks;
+        if (!parseChunks(stored, storedSize, originalSize, chunks)) return false;
+
+        std::vector<uint8_t> scratch;
+        for (const Chunk& chunk : chunks) {
+            scratch.resize(chunk.rawSize);
+            if (!decodeChunk(chunk, type, scratch.data())) return false;
+            if (!fn(chunk.rawOffset, scratch.data(), scratch.size())) return false;
+        }
+        return true;
+    }
+
+private:
+    // One parallelFor call; shared so helpers that start late stay safe
+    struct Job {
+        size_t count = 0;
+        std::atomic<size_t> next{0};
+        std::function<void(size_t)> fn;     // Only called for claimed indices
+        std::mutex mutex;
+        std::condition_variable idle;
+        int active = 0;                     // Helpers inside run(), guarded by mutex
+
+        void run() {
+            for (size_t i = next++; i < count; i = next++) fn(i);
+        }
+    };
+
+    // Threads kept for the life of the process, so a call pays for a wakeup
+    // rather than a thread start per helper
+    class WorkerPool {
+    public:
+        WorkerPool() {
+            unsigned threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+            for (unsigned i = 0; i < threads; i++) workers.emplace_back([this] { loop(); });
+        }
+
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            available.notify_all();
+            for (auto& worker : workers) worker.join();
+        }
+
+        unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.push_back(std::move(task));
+            }
+            available.notify_one();
+        }
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable available;
+        bool stopping = false;
+
+        void loop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                available.wait(lock, [&] { return stopping || !tasks.empty(); });
+                if (stopping) return;
+                std::function<void()> task = std::move(tasks.front());
+                tasks.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        }
+    };
+
+    static WorkerPool& workerPool() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    // 64-bit multiply-xor hash over 8-byte words; change detection only
+    static uint64_t hashBytes(const uint8_t* data, size_t size) {
+        uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+        while (size >= 8) {
+            uint64_t word;
+            std::memcpy(&word, data, 8);
+            hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 32;
+            data += 8;
+            size -= 8;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data, size);
+        hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+        return hash ^ (hash >> 29);
+    }
+
+    struct Chunk {
+        const uint8_t* data;
+        size_t storedSize;
+        size_t rawOffset;
+        size_t rawSize;
+        bool raw;
+    };
+
+    static bool parseChunks(const uint8_t* stored, size_t storedSize, size_t originalSize,
+                            std::vector<Chunk>& chunks) {
+        uint32_t header[2];
+        if (storedSize < sizeof(header)) return false;
+        std::memcpy(header, stored, sizeof(header));
+        uint32_t chunkSize = header[0];
+        uint32_t chunkCount = header[1];
+        if (chunkSize == 0 || (originalSize + chunkSize - 1) / chunkSize != chunkCount) return false;
+
+        size_t tableBytes = sizeof(header) + size_t(chunkCount) * sizeof(uint32_t);
+        if (storedSize < tableBytes) return false;
+
+        chunks.resize(chunkCount);
+        size_t cursor = tableBytes;
+        for (uint32_t i = 0; i < chunkCount; ++i) {
+            uint32_t entry;
+            std::memcpy(&entry, stored + sizeof(header) + i * sizeof(uint32_t), sizeof(uint32_t));
+
+            Chunk& chunk = chunks[i];
+            chunk.raw = (entry & RAW_CHUNK) != 0;
+            chunk.storedSize = entry & ~RAW_CHUNK;
+            chunk.rawOffset = size_t(i) * chunkSize;
+            chunk.rawSize = std::min<size_t>(chunkSize, originalSize - chunk.rawOffset);
+            if (chunk.storedSize > storedSize - cursor) return false;
+            if (chunk.raw && chunk.storedSize != chunk.rawSize) return false;
+            chunk.data = stored + cursor;
+            cursor += chunk.storedSize;
+        }
+        return cursor == storedSize;
+    }
+
+    static std::vector<uint8_t> compressChunk(const uint8_t* data, size_t size, CompressionType type, int level) {
+        std::vector<uint8_t> out;
+        #ifdef USE_LZ4
+        if (type == CompressionType::LZ4) {
+            // Levels below HC's minimum use the fast compressor
+            out.resize(LZ4_compressBound(static_cast<int>(size)));
+            const char* src = reinterpret_cast<const char*>(data);
+            char* dst = reinterpret_cast<char*>(out.data());
+            int written = level < LZ4HC_CLEVEL_MIN
+                ? LZ4_compress_default(src, dst, static_cast<int>(size), static_cast<int>(out.size()))
+                : LZ4_compress_HC(src, dst, static_cast<int>(size), static_cast<int>(out.size()), level);
+            out.resize(written > 0 ? written : 0);
+        }
+        #endif
+        #ifdef USE_ZSTD
+        if (type == CompressionType::Zstd) {
+            out.resize(ZSTD_compressBound(size));
+            size_t written = ZSTD_compress(out.data(), out.size(), data, size, level);
+            out.resize(ZSTD_isError(written) ? 0 : written);
+        }
+        #endif
+        (void)data; (void)size; (void)type; (void)level;
+        return out;
+    }
+
+    static bool decodeChunk(const Chunk& chunk, CompressionType type, uint8_t* dst) {
+        if (chunk.raw) {
+            std::memcpy(dst, chunk.data, chunk.rawSize);
+            return true;
+        }
+        #ifdef USE_LZ4
+        if (type == CompressionType::LZ4) {
+            int read = LZ4_decompress_safe(reinterpret_cast<const char*>(chunk.data), reinterpret_cast<char*>(dst),
+                                           static_cast<int>(chunk.storedSize), static_cast<int>(chunk.rawSize));
+            return read >= 0 && static_cast<size_t>(read) == chunk.rawSize;
+        }
+        #endif
+        #ifdef USE_ZSTD
+        if (type == CompressionType::Zstd) {
+            size_t read = ZSTD_decompress(dst, chunk.rawSize, chunk.data, chunk.storedSize);
+            return !ZSTD_isError(read) && read == chunk.rawSize;
+        }
+        #endif
+        (void)type; (void)dst;
+        return false;
+    }
+
+    static std::vector<uint8_t> compressDeflate(const uint8_t* data, size_t size, int level) {
+        #ifdef USE_COMPRESSION
+        uLongf compressedSize = compressBound(size);
+        std::vector<uint8_t> compressed(compressedSize);
+
+        int result = compress2(compressed.data(), &compressedSize, data, size, level);
+        if (result == Z_OK && compressedSize < size) {
+            compressed.resize(compressedSize);
+            return compressed;
+        }
+        #else
+        (void)data; (void)size; (void)level;
+        #endif
+        return {};
+    }
+
+    static bool decompressDeflate(const uint8_t* stored, size_t storedSize, uint8_t* dst, size_t dstSize) {
+        #ifdef USE_COMPRESSION
+        uLongf destLen = dstSize;
+        int result = uncompress(dst, &destLen, stored, storedSize);
+        return result == Z_OK && destLen == dstSize;
+        #else
+        (void)stored; (void)storedSize; (void)dst; (void)dstSize;
+        return false;
+        #endif
+    }
+};
+
+} // namespace ScenePackage
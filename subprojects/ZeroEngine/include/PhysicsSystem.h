@@ -1,7 +1,10 @@
 #pragma once
 #include "Engine.h"
+#include "event_system.h"
+#include "TriangleMesh.h"
 #include <glm/glm.hpp>
 #include <vector>
+#include <memory>
 
 
 
@@ -10,6 +13,8 @@ struct PhysicsConfig {
     float airDrag = 0.01f;
     int solverIterations = 4;
     bool enableCollisions = true;
+    bool enableContinuousCollision = true;
+    float restitution = 0.5f;
 };
 
 struct RigidBody : Component {
@@ -19,17 +24,24 @@ struct RigidBody : Component {
     float drag = 0.0f;
     bool useGravity = true;
     bool isKinematic = false;
+    bool continuousCollision = false; // Sweep this body each step (projectiles, thrown props)
 };
 
-enum class ColliderType { Box, Sphere, Capsule };
+enum class ColliderType { Box, Sphere, Capsule, Mesh };
 
 struct Collider : Component {
     ColliderType type = ColliderType::Box;
     glm::vec3 size = glm::vec3(1);
     float radius = 0.5f;
     bool isTrigger = false;
+    std::shared_ptr<const TriangleMeshShape> mesh; // Mesh colliders only; always static
 };
 
+struct Transform;
+
+// World AABB of a collider (shared by the broadphase and spatial queries)
+void getColliderBounds(const Transform* transform, const Collider* collider, glm::vec3& min, glm::vec3& max);
+
 struct CollisionInfo {
     EntityID entityA;
     EntityID entityB;
@@ -38,17 +50,48 @@ struct CollisionInfo {
     float penetration;
 };
 
+// Published once per contact per step when PhysicsSystem::events is set
+struct CollisionEvent {
+    EntityID entityA;
+    EntityID entityB;
+    glm::vec3 point;
+    glm::vec3 normal;
+    float penetration;
+    bool trigger;       // Either collider is a trigger (no response)
+};
+
 class PhysicsSystem : public System {
 public:
     PhysicsConfig config;
     ECS* ecs = nullptr;
+    EventSystem* events = nullptr;
     
     void update(float dt) override;
     std::vector<CollisionInfo> detectCollisions();
     void resolveCollision(const CollisionInfo& info);
     
 private:
+    // Broadphase entry: world AABB, swept over the step for CCD bodies
+    struct BroadphaseProxy {
+        EntityID entity;
+        glm::vec3 min;
+        glm::vec3 max;
+        glm::vec3 sweep; // Displacement this step (zero unless continuous)
+    };
+    
+    std::vector<BroadphaseProxy> proxies;
+    std::vector<std::pair<size_t, size_t>> candidatePairs;
+    std::vector<glm::vec3> stepStart; // Pre-integration positions, parallel to entities
+    
+    void buildBroadphase(bool swept);
+    void findCandidatePairs();
+    void solveContinuous();
+    bool sweepPair(const BroadphaseProxy& a, const BroadphaseProxy& b, float& toi, glm::vec3& normal);
+    bool sweepMesh(EntityID body, glm::vec3 start, glm::vec3 delta, EntityID meshEntity,
+                   float& toi, glm::vec3& normal);
+    
     bool checkBoxBox(EntityID a, EntityID b, CollisionInfo& info);
     bool checkSphereSphere(EntityID a, EntityID b, CollisionInfo& info);
     bool checkBoxSphere(EntityID a, EntityID b, CollisionInfo& info);
+    bool checkMesh(EntityID body, EntityID meshEntity, CollisionInfo& info);
 };
@@ -636,6 +636,11 @@ struct Renderable {
     VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
     VkDescriptorSet shadowDescriptorSet = VK_NULL_HANDLE;
     glm::mat4 transform = glm::mat4(1.0f);
+    
+    // calculateBones() scratch, one entry per bone
+    std::vector<glm::vec3> bonePositions;
+    std::vector<glm::quat> boneRotations;
+    std::vector<glm::vec3> boneScales;
 
     void init(Model* mdl, VmaAllocator alloc, VkDevice device, Texture& defaultTex, 
               VkDescriptorSetLayout mainLayout, ShadowMap* shadowMap, VkDescriptorSetLayout shadowLayout) {
@@ -745,31 +750,26 @@ struct Renderable {
         const Animation& anim = model->animations[animator.animationIndex];
         float tick = fmod(animator.currentTime * anim.ticksPerSecond, anim.duration);
 
-        std::unordered_map<std::string, glm::vec3> positions;
-        std::unordered_map<std::string, glm::quat> rotations;
-        std::unordered_map<std::string, glm::vec3> scales;
+        // Channels know their bone (Model::linkChannels), so samples go
+        // straight into per-bone slots
+        size_t boneCount = model->bones.size();
+        bonePositions.assign(boneCount, glm::vec3(0.0f));
+        boneRotations.assign(boneCount, glm::quat(1, 0, 0, 0));
+        boneScales.assign(boneCount, glm::vec3(1.0f));
 
         for (const auto& ch : anim.channels) {
-            positions[ch.nodeName] = interpVec3(ch.positions, tick, glm::vec3(0));
-            rotations[ch.nodeName] = interpQuat(ch.rotations, tick);
-            scales[ch.nodeName] = interpVec3(ch.scales, tick, glm::vec3(1));
+            if (ch.bone < 0 || size_t(ch.bone) >= boneCount) continue;
+            bonePositions[ch.bone] = interpVec3(ch.positions, tick, glm::vec3(0));
+            boneRotations[ch.bone] = interpQuat(ch.rotations, tick);
+            boneScales[ch.bone] = interpVec3(ch.scales, tick, glm::vec3(1));
         }
 
-        for (size_t i = 0; i < model->bones.size(); i++) {
+        for (size_t i = 0; i < boneCount; i++) {
             const BoneInfo& bone = model->bones[i];
 
-            glm::vec3 pos(0.0f);
-            glm::quat rot(1, 0, 0, 0);
-            glm::vec3 scl(1.0f);
-
-            auto posIt = positions.find(bone.name);
-            if (posIt != positions.end()) pos = posIt->second;
-
-            auto rotIt = rotations.find(bone.name);
-            if (rotIt != rotations.end()) rot = rotIt->second;
-
-            auto sclIt = scales.find(bone.name);
-            if (sclIt != scales.end()) scl = sclIt->second;
+            const glm::vec3& pos = bonePositions[i];
+            const glm::quat& rot = boneRotations[i];
+            const glm::vec3& scl = boneScales[i];
 
             glm::mat4 localTransform = glm::translate(glm::mat4(1), pos) *
                                        glm::toMat4(rot) *
@@ -0,0 +1,289 @@
+#pragma once
+#include "Engine.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+// Lightweight component reflection: each registered type lists its
+// serialized fields (name, type, byte offset) and a version. Serializers
+// work from this table alone, so a new component needs a registration and
+// no serializer code.
+//
+//   Reflection::Registry::get().add<Health>("Health", 2)
+//       .field("current", &Health::current)
+//       .field("max", &Health::max).renamed("maximum")
+//       .entity("lastAttacker", &Health::lastAttacker)
+//       .migrate([](Health& h, uint32_t from) { if (from < 2) h.max *= 10; });
+//
+// Fields not in the list (caches, GPU handles, loaded models) are left at
+// their defaults on load.
+namespace Reflection {
+
+enum class FieldType : uint8_t {
+    Bool, U8, U16, U32, I32, F32,
+    Vec2, Vec3, Vec4, Quat,
+    Entity,     // EntityID, remapped to the new entity on load
+    String
+};
+
+inline uint32_t fieldSize(FieldType type) {
+    switch (type) {
+        case FieldType::Bool: case FieldType::U8: return 1;
+        case FieldType::U16: return 2;
+        case FieldType::U32: case FieldType::I32: case FieldType::F32: case FieldType::Entity: return 4;
+        case FieldType::Vec2: return 8;
+        case FieldType::Vec3: return 12;
+        case FieldType::Vec4: case FieldType::Quat: return 16;
+        case FieldType::String: return 0;
+    }
+    return 0;
+}
+
+inline bool isScalar(FieldType type) {
+    return type <= FieldType::F32 || type == FieldType::Entity;
+}
+
+template<typename F>
+struct FieldTypeOf;
+template<> struct FieldTypeOf<bool> { static constexpr FieldType value = FieldType::Bool; };
+template<> struct FieldTypeOf<uint8_t> { static constexpr FieldType value = FieldType::U8; };
+template<> struct FieldTypeOf<uint16_t> { static constexpr FieldType value = FieldType::U16; };
+template<> struct FieldTypeOf<uint32_t> { static constexpr FieldType value = FieldType::U32; };
+template<> struct FieldTypeOf<int32_t> { static constexpr FieldType value = FieldType::I32; };
+template<> struct FieldTypeOf<float> { static constexpr FieldType value = FieldType::F32; };
+template<> struct FieldTypeOf<glm::vec2> { static constexpr FieldType value = FieldType::Vec2; };
+template<> struct FieldTypeOf<glm::vec3> { static constexpr FieldType value = FieldType::Vec3; };
+template<> struct FieldTypeOf<glm::vec4> { static constexpr FieldType value = FieldType::Vec4; };
+template<> struct FieldTypeOf<glm::quat> { static constexpr FieldType value = FieldType::Quat; };
+template<> struct FieldTypeOf<std::string> { static constexpr FieldType value = FieldType::String; };
+
+// Enums are stored as their underlying integer
+template<typename F>
+constexpr FieldType fieldTypeOf() {
+    if constexpr (std::is_enum<F>::value) {
+        return FieldTypeOf<std::make_unsigned_t<std::underlying_type_t<F>>>::value;
+    } else {
+        return FieldTypeOf<F>::value;
+    }
+}
+
+// Scalar fields convert between each other when a field's type changes
+inline double readScalar(FieldType type, const uint8_t* src) {
+    switch (type) {
+        case FieldType::Bool: case FieldType::U8: return src[0];
+        case FieldType::U16: { uint16_t v; std::memcpy(&v, src, 2); return v; }
+        case FieldType::U32: case FieldType::Entity: { uint32_t v; std::memcpy(&v, src, 4); return v; }
+        case FieldType::I32: { int32_t v; std::memcpy(&v, src, 4); return v; }
+        case FieldType::F32: { float v; std::memcpy(&v, src, 4); return v; }
+        default: return 0.0;
+    }
+}
+
+inline void writeScalar(FieldType type, uint8_t* dst, double value) {
+    switch (type) {
+        case FieldType::Bool: dst[0] = value != 0.0; break;
+        case FieldType::U8: dst[0] = static_cast<uint8_t>(value); break;
+        case FieldType::U16: { uint16_t v = static_cast<uint16_t>(value); std::memcpy(dst, &v, 2); break; }
+        case FieldType::U32: case FieldType::Entity: { uint32_t v = static_cast<uint32_t>(value); std::memcpy(dst, &v, 4); break; }
+        case FieldType::I32: { int32_t v = static_cast<int32_t>(value); std::memcpy(dst, &v, 4); break; }
+        case FieldType::F32: { float v = static_cast<float>(value); std::memcpy(dst, &v, 4); break; }
+        default: break;
+    }
+}
+
+struct FieldInfo {
+    std::string name;
+    std::string formerName;     // Matched on load when name isn't found
+    FieldType type;
+    uint32_t offset = 0;        // In the component
+    uint32_t recordOffset = 0;  // In the packed record (not used for strings)
+};
+
+// Decoded components of one type, waiting to be added to an ECS
+struct ComponentColumn {
+    std::vector<uint32_t> rows;
+    bool present = false;
+
+    virtual ~ComponentColumn() = default;
+    virtual void resize(size_t count) = 0;
+    virtual void* at(size_t index) = 0;
+    virtual void addTo(ECS* ecs, const std::vector<EntityID>& targets) = 0;
+};
+
+template<typename T>
+struct TypedColumn : ComponentColumn {
+    std::vector<T> components;
+
+    void resize(size_t count) override { components.resize(count); }
+    void* at(size_t index) override { return &components[index]; }
+    void addTo(ECS* ecs, const std::vector<EntityID>& targets) override { ecs->addComponents(targets, components); }
+};
+
+struct TypeInfo {
+    std::string name;
+    std::type_index type;
+    uint32_t version = 1;
+    uint32_t index = 0;             // Position in the registry
+    uint32_t size = 0;              // sizeof the component
+    std::vector<FieldInfo> fields;  // Sorted by offset
+
+    // Non-string fields back to back, sorted by offset. When they are also
+    // contiguous in the component (packed), a record is a straight copy of
+    // the bytes [spanOffset, spanOffset + recordSize).
+    uint32_t recordSize = 0;
+    uint32_t spanOffset = 0;
+    bool packed = true;
+
+    std::function<void(void*, uint32_t)> migrate;   // (component, saved version)
+    std::function<void(void*)> loaded;              // Rebuild unsaved state (cached IDs)
+    std::unique_ptr<ComponentColumn> (*makeColumn)() = nullptr;
+    // Every component of this type in the ECS: fn(entity, component)
+    void (*each)(ECS*, const std::function<void(EntityID, const void*)>&) = nullptr;
+    const void* (*find)(ECS*, EntityID) = nullptr;
+
+    explicit TypeInfo(std::type_index t) : type(t) {}
+
+    // Lay the records out again after a field was added
+    void layout() {
+        std::stable_sort(fields.begin(), fields.end(),
+                         [](const FieldInfo& a, const FieldInfo& b) { return a.offset < b.offset; });
+        recordSize = 0;
+        packed = true;
+        bool first = true;
+        for (FieldInfo& f : fields) {
+            if (f.type == FieldType::String) continue;
+            if (first) {
+                spanOffset = f.offset;
+                first = false;
+            }
+            if (f.offset != spanOffset + recordSize) packed = false;
+            f.recordOffset = recordSize;
+            recordSize += fieldSize(f.type);
+        }
+    }
+};
+
+// Fluent registration for one type
+template<typename T>
+class TypeBuilder {
+public:
+    explicit TypeBuilder(TypeInfo& info) : info(info) {}
+
+    template<typename F>
+    TypeBuilder& field(const std::string& name, F T::*member) {
+        return add(name, fieldTypeOf<F>(), offsetOf(member));
+    }
+
+    TypeBuilder& entity(const std::string& name, EntityID T::*member) {
+        return add(name, FieldType::Entity, offsetOf(member));
+    }
+
+    // The field was saved under another name by older versions
+    TypeBuilder& renamed(const std::string& formerName) {
+        if (last) last->formerName = formerName;
+        return *this;
+    }
+
+    // Called after loading a component saved with an older version
+    TypeBuilder& migrate(std::function<void(T&, uint32_t)> fn) {
+        info.migrate = [fn](void* component, uint32_t from) { fn(*static_cast<T*>(component), from); };
+        return *this;
+    }
+
+    // Called after loading every component, for state derived from the
+    // saved fields rather than saved itself
+    TypeBuilder& loaded(std::function<void(T&)> fn) {
+        info.loaded = [fn](void* component) { fn(*static_cast<T*>(component)); };
+        return *this;
+    }
+
+private:
+    TypeInfo& info;
+    FieldInfo* last = nullptr;
+
+    template<typename F>
+    static uint32_t offsetOf(F T::*member) {
+        static const T probe{};
+        return static_cast<uint32_t>(reinterpret_cast<const uint8_t*>(&(probe.*member)) -
+                                     reinterpret_cast<const uint8_t*>(&probe));
+    }
+
+    TypeBuilder& add(const std::string& name, FieldType type, uint32_t offset) {
+        info.fields.push_back({name, "", type, offset, 0});
+        info.layout();
+        for (FieldInfo& f : info.fields) {
+            if (f.name == name) last = &f;
+        }
+        return *this;
+    }
+};
+
+// Global table of serializable component types. Register everything at
+// startup: the table is read without locks while scenes load.
+class Registry {
+public:
+    static Registry& get() {
+        static Registry instance;
+        return instance;
+    }
+
+    // Registering a name again replaces its fields
+    template<typename T>
+    TypeBuilder<T> add(const std::string& name, uint32_t version = 1) {
+        TypeInfo* info = nullptr;
+        auto it = byName.find(name);
+        if (it != byName.end()) {
+            info = types[it->second].get();
+            byType.erase(info->type);
+            info->type = std::type_index(typeid(T));
+            info->fields.clear();
+            info->migrate = nullptr;
+        } else {
+            types.push_back(std::make_unique<TypeInfo>(std::type_index(typeid(T))));
+            info = types.back().get();
+            info->index = static_cast<uint32_t>(types.size() - 1);
+            byName[name] = info->index;
+        }
+
+        info->name = name;
+        info->version = version;
+        info->size = static_cast<uint32_t>(sizeof(T));
+        info->makeColumn = []() -> std::unique_ptr<ComponentColumn> { return std::make_unique<TypedColumn<T>>(); };
+        info->each = [](ECS* ecs, const std::function<void(EntityID, const void*)>& fn) {
+            ecs->each<T>([&](EntityID e, T& component) { fn(e, &component); });
+        };
+        info->find = [](ECS* ecs, EntityID e) -> const void* { return ecs->getComponent<T>(e); };
+        info->layout();
+        byType[info->type] = info->index;
+        return TypeBuilder<T>(*info);
+    }
+
+    const TypeInfo* find(const std::string& name) const {
+        auto it = byName.find(name);
+        return it != byName.end() ? types[it->second].get() : nullptr;
+    }
+
+    template<typename T>
+    const TypeInfo* find() const {
+        auto it = byType.find(std::type_index(typeid(T)));
+        return it != byType.end() ? types[it->second].get() : nullptr;
+    }
+
+    size_t size() const { return types.size(); }
+    const TypeInfo& operator[](size_t i) const { return *types[i]; }
+
+private:
+    std::vector<std::unique_ptr<TypeInfo>> types;
+    std::unordered_map<std::string, uint32_t> byName;
+    std::unordered_map<std::type_index, uint32_t> byType;
+};
+
+} // namespace Reflection
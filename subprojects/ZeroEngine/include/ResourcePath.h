@@ -5,11 +5,21 @@
 #include <unistd.h>
 #include "iostream"
 #include <linux/limits.h>
+#include "VirtualFileSystem.h"
 
 class ResourcePath {
   static inline std::string projectRoot;    
+  static inline std::vector<VFS::MountID> assetMounts;
 public:
-    static void init() {
+    // root empty = find it from the executable's location
+    static void init(const std::string& root = "") {
+        if (!root.empty()) {
+            projectRoot = root;
+            std::cout << "✓ Resource root: " << projectRoot << std::endl;
+            mountAssets();
+            return;
+        }
+        
         // Try to find project root from executable location
         char result[PATH_MAX];
         ssize_t count = readlink("/proc/self/exe", result, PATH_MAX);
@@ -29,6 +39,24 @@ public:
         }
         
         std::cout << "✓ Resource root: " << projectRoot << std::endl;
+        mountAssets();
+    }
+    
+    // Index the asset folders once so loaders find files without probing
+    // the disk; packages mounted later (VFS::FileSystem::mountPackage) can
+    // override them
+    static void mountAssets() {
+        for (VFS::MountID id : assetMounts) VFS::FileSystem::get().unmount(id);
+        assetMounts.clear();
+        
+        static const char* folders[] = {"models", "textures", "shaders", "scenes", "prefabs", "audio"};
+        for (const char* folder : folders) {
+            std::error_code ec;
+            std::string dir = get(folder);
+            if (!std::filesystem::is_directory(dir, ec)) continue;
+            VFS::MountID id = VFS::FileSystem::get().mountDirectory(dir, folder);
+            if (id != VFS::INVALID_MOUNT) assetMounts.push_back(id);
+        }
     }
     
     static std::string get(const std::string& relativePath) {
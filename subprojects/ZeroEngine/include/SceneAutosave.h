@@ -0,0 +1,112 @@
+#pragma once
+#include "ScenePackager.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+// Background scene saving for editor autosave
+//
+// save() takes a snapshot on the calling thread - a pass over the component
+// arrays - and hands it to a worker that compresses and writes it, so the
+// frame only pays for the copy. Chunk caches persist between saves, so
+// chunks whose bytes didn't change are reused instead of re-encoded, and the
+// package is replaced atomically (see PackageWriter::write).
+class SceneAutosaver {
+public:
+    ~SceneAutosaver() { wait(); }
+
+    // Start a background save. False if the previous one is still running.
+    bool save(ECS* ecs, const std::string& path, const std::string& sceneName = "Untitled") {
+        if (saving) return false;
+        if (worker.joinable()) worker.join();
+
+        auto start = std::chrono::steady_clock::now();
+        ScenePackaging::SceneSnapshot snapshot = ScenePackaging::ScenePackager::snapshotScene(ecs, sceneName);
+        float snapshotMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // Caches belong to one file; start over when the target changes
+        if (path != cachePath) {
+            caches.clear();
+            cachePath = path;
+        }
+
+        saving = true;
+        worker = std::thread([this, snapshot = std::move(snapshot), path, snapshotMs]() mutable {
+            auto start = std::chrono::steady_clock::now();
+            ScenePackaging::SaveStats stats;
+            bool ok = ScenePackaging::ScenePackager::writeSnapshot(std::move(snapshot), path, compression,
+                                                                   &caches, &stats);
+            float writeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                last = {ok, snapshotMs, writeMs, stats};
+            }
+            if (!ok) caches.clear();
+            saving = false;
+        });
+        return true;
+    }
+
+    bool isSaving() const { return saving; }
+
+    // Block until the running save (if any) has finished
+    void wait() {
+        if (worker.joinable()) worker.join();
+    }
+
+    struct Result {
+        bool ok = false;
+        float snapshotMs = 0.0f;    // Main-thread cost
+        float writeMs = 0.0f;       // Worker: compress + write
+        ScenePackaging::SaveStats stats;
+    };
+
+    Result lastResult() const {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        return last;
+    }
+
+    // LZ4 by default: fast to encode, and fast for the editor to reload
+    void setCompression(ScenePackage::CompressionType type) {
+        if (type != compression) {
+            wait();
+            caches.clear();
+            compression = type;
+        }
+    }
+
+    // Save to path every interval seconds of update() time; 0 disables
+    void enableAutosave(const std::string& path, float intervalSeconds, const std::string& sceneName = "Untitled") {
+        autosavePath = path;
+        autosaveName = sceneName;
+        interval = intervalSeconds;
+        elapsed = 0.0f;
+    }
+
+    void disableAutosave() { interval = 0.0f; }
+
+    // Call once per frame; starts a save when the interval has passed. A save
+    // still in flight pushes the next one back rather than queueing it.
+    void update(ECS* ecs, float dt) {
+        if (interval <= 0.0f || autosavePath.empty()) return;
+        elapsed += dt;
+        if (elapsed < interval) return;
+        if (save(ecs, autosavePath, autosaveName)) elapsed = 0.0f;
+    }
+
+private:
+    std::thread worker;
+    std::atomic<bool> saving{false};
+    ScenePackage::CompressionType compression = ScenePackage::CompressionType::LZ4;
+    ScenePackaging::SaveCache caches;   // Only touched by the worker while saving
+    std::string cachePath;
+
+    mutable std::mutex statsMutex;
+    Result last;
+
+    std::string autosavePath;
+    std::string autosaveName;
+    float interval = 0.0f;
+    float elapsed = 0.0f;
+};
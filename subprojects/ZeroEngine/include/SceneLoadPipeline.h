@@ -0,0 +1,378 @@
+#pragma once
+#include "ScenePackager.h"
+#include "ModelLoader.h"
+#include "AssetBundle.h"
+#include "AssetPreloader.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+
+// Blocking FIFO with a capacity: push waits while full, pop while empty.
+// close() wakes everyone; push then fails and pop drains what is left.
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(std::max<size_t>(capacity, 1)) {}
+
+    bool push(T value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(value));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&] { return closed || !items.empty(); });
+        return take(out);
+    }
+
+    bool tryPop(T& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return take(out);
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed = false;
+
+    bool take(T& out) {
+        if (items.empty()) return false;
+        out = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+};
+
+struct SceneLoadProgress {
+    size_t columnsRead = 0;
+    size_t columnCount = 0;
+    size_t modelsImported = 0;      // Distinct model files
+    size_t modelCount = 0;
+    size_t instancesUploaded = 0;   // Entities with a model
+    size_t instanceCount = 0;
+    bool entitiesReady = false;     // Components are in the ECS
+
+    float fraction() const {
+        size_t total = columnCount + modelCount + instanceCount;
+        size_t done = columnsRead + modelsImported + instancesUploaded;
+        return total ? float(done) / float(total) : (entitiesReady ? 1.0f : 0.0f);
+    }
+};
+
+struct SceneLoadOptions {
+    unsigned decodeThreads = 2;
+    unsigned importThreads = 0;     // 0 = hardware concurrency
+    size_t maxQueuedColumns = 4;    // Read-ahead between the I/O thread and decoders
+    size_t maxQueuedImports = 8;    // Imported models waiting for upload (bounds CPU memory)
+    size_t uploadBatchSize = 32;    // Model instances per GPU submit
+    ScenePackage::VerifyPolicy verify = ScenePackage::VerifyPolicy::Always;
+    glm::vec3 focus{0.0f};          // Models nearest this import first (packages with an asset graph)
+    AssetPreloader* preloader = nullptr; // Models it was asked for are taken from it, not re-imported
+};
+
+// Streaming scene loader
+//
+// Stages run at the same time, connected by bounded queues:
+//   I/O thread - checks and decompresses the package's columns
+//   decoders   - turn columns into component arrays; the model column queues
+//                each distinct model path for import as soon as it decodes
+//   importers  - ModelLoader::import (Assimp + texture decode), once per path,
+//                or the cooked copy when the package is an asset bundle, or
+//                the finished import from options.preloader
+//   caller     - applies components to the ECS, then uploads models in
+//                batches as imports finish, reporting progress as it goes
+// so load time tracks the slowest stage rather than the sum of them. When
+// the package has an asset graph every model is queued for import before
+// the first column is read, nearest options.focus first.
+// Packages in the per-entity v1 layout load through ScenePackager and only
+// the model stages overlap.
+class SceneLoadPipeline {
+public:
+    using ProgressFn = std::function<void(const SceneLoadProgress&)>;
+    using ModelReadyFn = std::function<void(EntityID, Model*)>;
+
+    // Callbacks run on the calling thread. onModelReady sees each model once
+    // it's in its entity's ModelComponent.
+    static bool load(ECS* ecs, ModelLoader& loader, const std::string& path,
+                     const SceneLoadOptions& options = {},
+                     const ProgressFn& onProgress = nullptr,
+                     const ModelReadyFn& onModelReady = nullptr) {
+        ScenePackage::MappedPackageReader reader;
+        reader.setVerifyPolicy(options.verify);
+        if (!reader.open(path, ScenePackage::PackageIO::Read)) {
+            std::cerr << "✗ Failed to open scene package: " << path << std::endl;
+            return false;
+        }
+
+        // Bundled scenes carry their models; others import from files
+        AssetBundle bundle;
+        if (reader.getHeader().version >= 2 && bundle.attach(reader)) {
+            std::cout << "  Asset bundle: " << bundle.modelCount() << " models" << std::endl;
+        }
+
+        ModelImports imports(loader, bundle, options.preloader, options.importThreads, options.maxQueuedImports);
+        SceneLoadProgress progress;
+
+        AssetGraph graph;
+        if (ScenePackaging::ScenePackager::loadAssetGraph(reader, graph)) {
+            for (const AssetGraph::PlanEntry& entry : graph.plan("scene", options.focus)) {
+                imports.request(graph.asset(entry.asset).path);
+            }
+        }
+
+        if (reader.getHeader().version < 2) {
+            reader.close();
+            if (!ScenePackaging::ScenePackager::loadScene(ecs, path, options.verify)) return false;
+            ecs->each<ModelComponent>([&](EntityID, ModelComponent& mc) {
+                if (!mc.loadedModel) imports.request(mc.modelPath);
+            });
+            imports.finishRequests();
+        } else if (!loadColumns(ecs, reader, options, imports, progress)) {
+            return false;
+        }
+
+        progress.entitiesReady = true;
+        uploadModels(ecs, loader, options, imports, progress, onProgress, onModelReady);
+
+        std::cout << "✓ Scene streamed: " << path << " (" << progress.modelsImported << " models, "
+                  << progress.instancesUploaded << " instances)" << std::endl;
+        return true;
+    }
+
+private:
+    struct ColumnBlob {
+        int index = -1;
+        ScenePackage::DataView bytes;
+        std::vector<uint8_t> storage; // Decompressed copy, when needed
+    };
+
+    // Import workers fed with distinct model paths
+    class ModelImports {
+    public:
+        ModelImports(ModelLoader& loader, const AssetBundle& bundle, AssetPreloader* preloader,
+                     unsigned threads, size_t maxQueued)
+            : loader(loader), bundle(bundle), preloader(preloader), paths(SIZE_MAX), ready(maxQueued) {
+            if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+            live = threads;
+            for (unsigned i = 0; i < threads; i++) workers.emplace_back([this] { run(); });
+        }
+
+        ~ModelImports() {
+            cancel();
+            for (auto& worker : workers) worker.join();
+        }
+
+        // Queue a model file for import unless it already was (any thread)
+        void request(const std::string& path) {
+            if (path.empty()) return;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!requested.insert(path).second) return;
+            }
+            paths.push(path);
+        }
+
+        // No more requests; workers exit once the queue is empty
+        void finishRequests() { paths.close(); }
+
+        void cancel() {
+            paths.close();
+            ready.close();
+        }
+
+        bool next(std::shared_ptr<ModelImport>& out) { return ready.pop(out); }
+        bool tryNext(std::shared_ptr<ModelImport>& out) { return ready.tryPop(out); }
+
+        size_t requestedCount() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return requested.size();
+        }
+
+    private:
+        ModelLoader& loader;
+        const AssetBundle& bundle;
+        AssetPreloader* preloader;
+        BoundedQueue<std::string> paths;
+        BoundedQueue<std::shared_ptr<ModelImport>> ready;
+        std::vector<std::thread> workers;
+        std::atomic<unsigned> live{0};
+        std::mutex mutex;
+        std::unordered_set<std::string> requested;
+
+        void run() {
+            std::string path;
+            while (paths.pop(path)) {
+                std::shared_ptr<ModelImport> imported = preloader ? preloader->acquire(path) : nullptr;
+                if (!imported) {
+                    imported = std::make_shared<ModelImport>();
+                    if (!bundle.importModel(path, *imported)) {
+                        loader.import(path, *imported); // Failures come through as !valid()
+                    }
+                }
+                if (!ready.push(std::move(imported))) break;
+            }
+            if (--live == 0) ready.close();
+        }
+    };
+
+    // Read, decode and apply a v2 package. Model imports start while the
+    // other columns are still being decoded.
+    static bool loadColumns(ECS* ecs, const ScenePackage::MappedPackageReader& reader,
+                            const SceneLoadOptions& options, ModelImports& imports,
+                            SceneLoadProgress& progress) {
+        const auto& entries = reader.getResourceEntries();
+        int tableIndex = reader.findResource("entities");
+        std::vector<int> columns;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].type == ScenePackage::ResourceType::ComponentColumn) columns.push_back(static_cast<int>(i));
+        }
+        progress.columnCount = columns.size();
+
+        ScenePackaging::SceneData scene;
+        BoundedQueue<std::unique_ptr<ColumnBlob>> blobs(options.maxQueuedColumns);
+        std::atomic<bool> tableOk{false};
+        std::atomic<bool> columnsOk{true};
+        std::atomic<size_t> columnsRead{0};
+
+        std::thread io([&] {
+            if (tableIndex >= 0) reader.prefetch(tableIndex);
+            for (int index : columns) reader.prefetch(index);
+
+            std::vector<uint8_t> storage;
+            auto table = ScenePackaging::ScenePackager::resourceBytes(reader, tableIndex, storage);
+            tableOk = ScenePackaging::ScenePackager::decodeEntityTable(table, scene, reader.getHeader().version);
+
+            for (int index : columns) {
+                if (!tableOk || !columnsOk) break;
+                auto blob = std::make_unique<ColumnBlob>();
+                blob->index = index;
+                blob->bytes = ScenePackaging::ScenePackager::resourceBytes(reader, index, blob->storage);
+                columnsRead++;
+                if (!blobs.push(std::move(blob))) break;
+            }
+            blobs.close();
+        });
+
+        unsigned decoderCount = std::max(1u, options.decodeThreads);
+        std::vector<std::thread> decoders;
+        std::atomic<unsigned> liveDecoders{decoderCount};
+        for (unsigned i = 0; i < decoderCount; i++) {
+            decoders.emplace_back([&] {
+                std::unique_ptr<ColumnBlob> blob;
+                while (blobs.pop(blob)) {
+                    const std::string& name = entries[blob->index].name;
+                    if (!columnsOk) continue; // Drain so the reader can finish
+                    if (!ScenePackaging::ScenePackager::decodeColumn(name, blob->bytes, scene)) {
+                        columnsOk = false;
+                        continue;
+                    }
+                    if (name == "ModelComponent") {
+                        for (const auto& mc : scene.column<ModelComponent>()->components) imports.request(mc.modelPath);
+                    }
+                }
+                if (--liveDecoders == 0) imports.finishRequests();
+            });
+        }
+
+        io.join();
+        for (auto& decoder : decoders) decoder.join();
+        progress.columnsRead = columnsRead;
+
+        if (!tableOk || !columnsOk) {
+            imports.cancel();
+            return false;
+        }
+
+        ScenePackaging::ScenePackager::applyScene(ecs, scene);
+        std::cout << "✓ Loaded " << scene.savedIds.size() << " entities from scene package" << std::endl;
+        return true;
+    }
+
+    // Caller-thread stage: bind finished imports to their entities and upload
+    // them in batches until every requested model has come through
+    static void uploadModels(ECS* ecs, ModelLoader& loader, const SceneLoadOptions& options,
+                             ModelImports& imports, SceneLoadProgress& progress,
+                             const ProgressFn& onProgress, const ModelReadyFn& onModelReady) {
+        std::unordered_map<std::string, std::vector<EntityID>> pathEntities;
+        ecs->each<ModelComponent>([&](EntityID e, ModelComponent& mc) {
+            if (mc.loadedModel || mc.modelPath.empty()) return;
+            pathEntities[mc.modelPath].push_back(e);
+            progress.instanceCount++;
+        });
+        progress.modelCount = imports.requestedCount();
+        if (onProgress) onProgress(progress);
+
+        size_t batchSize = std::max<size_t>(options.uploadBatchSize, 1);
+        std::vector<std::shared_ptr<ModelImport>> held; // Keeps batch sources alive
+        std::vector<const ModelImport*> sources;
+        std::vector<EntityID> targets;
+
+        auto flush = [&] {
+            if (!sources.empty()) {
+                std::vector<Model> models = loader.upload(sources);
+                for (size_t i = 0; i < models.size(); i++) {
+                    auto* mc = ecs->getComponent<ModelComponent>(targets[i]);
+                    if (!mc || mc->loadedModel) {
+                        loader.cleanup(models[i]);
+                        continue;
+                    }
+                    mc->loadedModel = new Model(std::move(models[i]));
+                    if (onModelReady) onModelReady(targets[i], mc->loadedModel);
+                }
+                progress.instancesUploaded += sources.size();
+            }
+            held.clear();
+            sources.clear();
+            targets.clear();
+            if (onProgress) onProgress(progress);
+        };
+
+        std::shared_ptr<ModelImport> imported;
+        while (imports.next(imported)) {
+            do {
+                progress.modelsImported++;
+                auto found = pathEntities.find(imported->path);
+                if (found == pathEntities.end()) continue;
+
+                if (!imported->valid()) {
+                    std::cerr << "  ✗ Model load failed: " << imported->path << std::endl;
+                    progress.instancesUploaded += found->second.size();
+                    continue;
+                }
+
+                held.push_back(imported);
+                for (EntityID e : found->second) {
+                    sources.push_back(imported.get());
+                    targets.push_back(e);
+                    if (sources.size() >= batchSize) {
+                        flush();
+                        held.push_back(imported);
+                    }
+                }
+            } while (sources.size() < batchSize && imports.tryNext(imported));
+            flush();
+        }
+    }
+};
@@ -3,6 +3,8 @@
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <thread>
+#include <atomic>
 
 class Scene {
 public:
@@ -10,6 +12,10 @@ public:
     ECS ecs;
     
     virtual ~Scene() = default;
+    // Runs on a worker thread for loadSceneAsync, before onLoad. ecs starts
+    // out empty (register the components you use here); fill it and don't
+    // touch other scenes or the GPU.
+    virtual void onBuild() {}
     virtual void onLoad() {}
     virtual void onUnload() {}
     virtual void update(float /*dt*/) {}
@@ -21,9 +27,21 @@ class SceneManager {
     Scene* nextScene = nullptr;
     bool transitioning = false;
     
+    // loadSceneAsync: scene whose onBuild is running
+    Scene* buildingScene = nullptr;
+    std::thread buildThread;
+    std::atomic<bool> buildDone{false};
+    
 public:
+    ~SceneManager();
+    
     void registerScene(const std::string& name, Scene* scene);
     void loadScene(const std::string& name);
+    // Build the scene on a worker while the current one keeps updating;
+    // the switch happens in update() once onBuild has returned. Not for the
+    // current or already pending scene, whose ecs is in use.
+    bool loadSceneAsync(const std::string& name);
+    bool isLoading() const { return buildingScene != nullptr; }
     void update(float dt);
     Scene* getCurrentScene() { return currentScene; }
     void cleanup();
@@ -7,12 +7,23 @@
 #include <fstream>
 #include <filesystem>
 #include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <array>
+#include <thread>
+#include <atomic>
 
-// Simple compression using zlib (optional - can use miniz for header-only)
-#ifdef USE_COMPRESSION
-#include <zlib.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
+// Codecs: zlib (USE_COMPRESSION), LZ4 (USE_LZ4), Zstd (USE_ZSTD)
+#include "PackageCompression.h"
+#include "AsyncIO.h"
+
 /*
  * ScenePackage Format (.zscene - Zero Scene)
  * 
@@ -38,6 +49,21 @@
  *   - DataSize: uint64 (8 bytes)
  *   - CompressedSize: uint64 (8 bytes) - 0 if uncompressed
  *   - Checksum: uint32 (4 bytes) - CRC32
+ * 
+ * Name Index (when flags has FLAG_NAME_INDEX, right after the table):
+ *   - SlotCount: uint32 (power of two, or 0)
+ *   - NameSlots: {hash: uint32, entry + 1: uint32}[SlotCount] - by name
+ *   - PathSlots: {hash: uint32, entry + 1: uint32}[SlotCount] - by virtual path
+ *   Open addressing with linear probing on hashName(); entry 0 = empty slot.
+ *   Readers that don't know the flag skip it, since all offsets are absolute.
+ * 
+ * Scene layout by header version:
+ *   - 1: one Prefab resource per entity (ScenePackager v1)
+ *   - 2: columnar - one EntityTable resource plus one ComponentColumn
+ *        resource per component type (see ScenePackager.h)
+ *   - 3: as 2, but each column carries its field schema (Reflection.h)
+ *        A partitioned world is version 2+ with a set of these per cell,
+ *        named "cell/<x>_<z>/...", plus a WorldCellIndex (WorldPartition.h)
  */
 
 namespace ScenePackage {
@@ -53,15 +79,18 @@ enum class ResourceType : uint8_t {
     Animation = 7,    // Animation clips
     Prefab = 8,       // Prefab data
     NavMesh = 9,      // Navigation mesh
+    CollisionMesh = 10, // Cooked TriangleMeshShape (serialize()); scenes don't write it yet
+    EntityTable = 11,     // Columnar scene: saved entity IDs
+    ComponentColumn = 12, // Columnar scene: one component type for all entities
+    WorldCellIndex = 13,  // Partitioned world: cell grid and where each cell's columns are
+    CookedModel = 14,     // Bundled ModelImport, named by content key (AssetBundle.h)
+    CookedTexture = 15,   // Bundled RGBA8 image, named by content key
+    AssetManifest = 16,   // Bundle: source path -> content key
+    AssetGraph = 17,      // Scenes/cells -> models -> textures (AssetGraph.h)
     Custom = 255      // User-defined
 };
 
-enum class CompressionType : uint8_t {
-    None = 0,
-    Deflate = 1,    // zlib/deflate
-    LZ4 = 2,        // Fast compression
-    Zstd = 3        // Best ratio
-};
+constexpr uint32_t FLAG_NAME_INDEX = 1u << 0;
 
 struct PackageHeader {
     char magic[4] = {'Z', 'S', 'C', 'N'};
@@ -105,8 +134,29 @@ struct Resource {
     }
 };
 
-// CRC32 checksum
-inline uint32_t calculateCRC32(const uint8_t* data, size_t size) {
+// Non-owning view of bytes inside a package (std::span stand-in for C++17)
+struct DataView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    
+    bool empty() const { return size == 0; }
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+    std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+};
+
+// FNV-1a, used by the stored name index
+inline uint32_t hashName(const std::string& name) {
+    uint32_t h = 2166136261u;
+    for (unsigned char c : name) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// CRC32 checksum (byte table; the package format's checksum is defined by it)
+inline const uint32_t* crc32Table() {
     static const uint32_t crcTable[256] ={
 
    /*-- Ugly, innit? --*/
@@ -176,13 +226,115 @@ inline uint32_t calculateCRC32(const uint8_t* data, size_t size) {
    0xafb010b1L, 0xab710d06L, 0xa6322bdfL, 0xa2f33668L,
    0xbcb4666dL, 0xb8757bdaL, 0xb5365d03L, 0xb1f740b4L
 };    
-    uint32_t crc = 0xFFFFFFFF;
-    for (size_t i = 0; i < size; i++) {
-        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crcTable;
+}
+
+// Slice-by-8 tables derived from the byte table: slice[k][i] is byte i
+// followed by k zero bytes, so eight bytes fold in per step with the
+// same result as the byte loop.
+struct CRC32Slices {
+    uint32_t table[8][256];
+    
+    CRC32Slices() {
+        const uint32_t* base = crc32Table();
+        for (int i = 0; i < 256; i++) table[0][i] = base[i];
+        for (int k = 1; k < 8; k++) {
+            for (int i = 0; i < 256; i++) {
+                uint32_t prev = table[k - 1][i];
+                table[k][i] = base[prev & 0xFF] ^ (prev >> 8);
+            }
+        }
     }
-    return crc ^ 0xFFFFFFFF;
+};
+
+// Raw CRC register update (no pre/post inversion)
+inline uint32_t updateCRC32(uint32_t crc, const uint8_t* data, size_t size) {
+    static const CRC32Slices slices;
+    const auto& t = slices.table;
+    
+    while (size >= 8) {
+        uint32_t lo = crc ^ (uint32_t(data[0]) | uint32_t(data[1]) << 8 |
+                             uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        data += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
 }
 
+inline uint32_t calculateCRC32(const uint8_t* data, size_t size) {
+    return updateCRC32(0xFFFFFFFF, data, size) ^ 0xFFFFFFFF;
+}
+
+// CRC of A followed by B from crc(A), crc(B) and B's length, by applying
+// the "shift in one zero byte" operator lengthB times (squared up in GF(2))
+inline uint32_t combineCRC32(uint32_t crcA, uint32_t crcB, uint64_t lengthB) {
+    // 32x32 bit matrices; column j is the image of bit j
+    using Matrix = std::array<uint32_t, 32>;
+    auto apply = [](const Matrix& m, uint32_t v) {
+        uint32_t out = 0;
+        for (int j = 0; v; j++, v >>= 1) {
+            if (v & 1) out ^= m[j];
+        }
+        return out;
+    };
+    auto multiply = [&](const Matrix& a, const Matrix& b) {
+        Matrix out;
+        for (int j = 0; j < 32; j++) out[j] = apply(a, b[j]);
+        return out;
+    };
+    
+    static const Matrix zeroByte = [] {
+        Matrix m;
+        const uint32_t* base = crc32Table();
+        for (int j = 0; j < 32; j++) {
+            uint32_t bit = 1u << j;
+            m[j] = base[bit & 0xFF] ^ (bit >> 8);
+        }
+        return m;
+    }();
+    
+    Matrix power = zeroByte;
+    while (lengthB) {
+        if (lengthB & 1) crcA = apply(power, crcA);
+        lengthB >>= 1;
+        if (lengthB) power = multiply(power, power);
+    }
+    return crcA ^ crcB;
+}
+
+// CRC32 over large buffers, split into slices checked on worker threads
+// and combined. Small buffers stay on the calling thread.
+inline uint32_t calculateCRC32Parallel(const uint8_t* data, size_t size, unsigned threads = 0) {
+    constexpr size_t SLICE = 1 << 20;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == 1 || size < SLICE * 2) return calculateCRC32(data, size);
+    
+    size_t count = (size + SLICE - 1) / SLICE;
+    std::vector<uint32_t> partial(count);
+    ChunkedCodec::parallelFor(count, threads, [&](size_t i) {
+        size_t begin = i * SLICE;
+        partial[i] = calculateCRC32(data + begin, std::min(SLICE, size - begin));
+    });
+    
+    uint32_t crc = partial[0];
+    for (size_t i = 1; i < count; i++) {
+        crc = combineCRC32(crc, partial[i], std::min(SLICE, size - i * SLICE));
+    }
+    return crc;
+}
+
+// When readers check resource checksums
+enum class VerifyPolicy : uint8_t {
+    Always,     // Every read
+    Once,       // First read of each resource per open package
+    Never       // Trust the file (e.g. shipped builds with their own signing)
+};
+
 // Scene Package Writer
 class PackageWriter {
 public:
@@ -193,14 +345,8 @@ public:
                             ResourceType type,
                             const std::string& virtualPath = "",
                             CompressionType compression = CompressionType::None) {
-        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
-        if (!file) return false;
-        
-        size_t size = file.tellg();
-        file.seekg(0);
-        
-        std::vector<uint8_t> data(size);
-        file.read(reinterpret_cast<char*>(data.data()), size);
+        std::vector<uint8_t> data;
+        if (!AsyncIO::readFile(filepath, data)) return false;
         
         std::string vpath = virtualPath.empty() ? 
             std::filesystem::path(filepath).filename().string() : virtualPath;
@@ -214,7 +360,8 @@ public:
                     const std::string& virtualPath,
                     ResourceType type,
                     std::vector<uint8_t> data,
-                    CompressionType compression = CompressionType::None) {
+                    CompressionType compression = CompressionType::None,
+                    ChunkCache* cache = nullptr) {
         Resource res;
         res.entry.name = name;
         res.entry.virtualPath = virtualPath;
@@ -225,7 +372,7 @@ public:
         
         if (compression != CompressionType::None) {
             // Compress data
-            auto compressed = compressData(data, compression);
+            auto compressed = compressData(data, compression, cache);
             if (!compressed.empty()) {
                 res.entry.compressedSize = compressed.size();
                 res.data = std::move(compressed);
@@ -254,13 +401,111 @@ void setSceneData(const T& sceneStruct) {
     std::memcpy(sceneData.data(), &sceneStruct, sizeof(T));
 }
     
-    // Write package to file
+    // Scene layout version written to the header (see format notes above)
+    void setVersion(uint32_t v) {
+        version = v;
+    }
+    
+    // Codec tuning for resources added after the call. Level -1 picks the
+    // fast codec default; ChunkedCodec::highLevel() suits offline packaging.
+    // threads 0 compresses chunks on every core.
+    void setCompressionLevel(int level) {
+        compressionLevel = level;
+    }
+    
+    void setChunkSize(uint32_t bytes) {
+        chunkSize = bytes;
+    }
+    
+    void setCompressionThreads(unsigned threads) {
+        compressionThreads = threads;
+    }
+    
+    // Write package to file. The package goes to a uniquely named temp file
+    // next to filepath, is flushed to disk and then renamed over filepath,
+    // so a crash mid-write leaves the previous file intact (and readers that
+    // mapped it keep their view). Concurrent writes to one path each get
+    // their own temp file; the last rename wins.
     bool write(const std::string& filepath) {
+        std::string tempPath = makeTempPath(filepath);
+        if (tempPath.empty()) return false;
+        if (!writeTo(tempPath) || !syncFile(tempPath)) {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        
+        std::error_code ec;
+        std::filesystem::rename(tempPath, filepath, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+    
+    // Get resource count
+    size_t getResourceCount() const { return resources.size(); }
+    
+    // Get total package size estimate
+    size_t estimateSize() const {
+        size_t total = sizeof(PackageHeader) + sceneData.size();
+        total += sizeof(uint32_t) + indexSlotCount() * 4 * sizeof(uint32_t);
+        for (const auto& res : resources) {
+            total += 1 + 2 + res.entry.name.size() + 
+                    2 + res.entry.virtualPath.size() + 8 + 8 + 8 + 4 + 1;
+            total += res.data.size();
+        }
+        return total;
+    }
+    
+private:
+    std::vector<Resource> resources;
+    std::vector<uint8_t> sceneData;
+    uint32_t version = 1;
+    int compressionLevel = -1;
+    uint32_t chunkSize = ChunkedCodec::DEFAULT_CHUNK_SIZE;
+    unsigned compressionThreads = 0;
+    
+    // Create an empty "<filepath>.tmp.XXXXXX" in filepath's directory
+    static std::string makeTempPath(const std::string& filepath) {
+#ifndef _WIN32
+        std::string pattern = filepath + ".tmp.XXXXXX";
+        int fd = ::mkstemp(pattern.data());
+        if (fd < 0) return {};
+        ::fchmod(fd, 0644); // mkstemp creates 0600; packages are shared files
+        ::close(fd);
+        return pattern;
+#else
+        static std::atomic<uint32_t> counter{0};
+        size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+        return filepath + ".tmp." + std::to_string(thread) + "." + std::to_string(counter++);
+#endif
+    }
+    
+    // Flush a written file to disk so the rename can't expose a torn file
+    static bool syncFile(const std::string& filepath) {
+#ifndef _WIN32
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        bool ok = ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+#else
+        (void)filepath;
+        return true;
+#endif
+    }
+    
+    // Serialize the whole package to filepath
+    bool writeTo(const std::string& filepath) {
         std::ofstream out(filepath, std::ios::binary);
         if (!out) return false;
         
         // Calculate offsets
         PackageHeader header;
+        header.version = version;
+        header.flags |= FLAG_NAME_INDEX;
         header.resourceCount = static_cast<uint32_t>(resources.size());
         
         size_t offset = sizeof(PackageHeader);
@@ -272,6 +517,10 @@ void setSceneData(const T& sceneStruct) {
                      8 + 8 + 8 + 4 + 1; // offsets, sizes, checksum, compression
         }
         
+        // Name index follows the table
+        std::vector<uint32_t> index = buildNameIndex();
+        offset += index.size() * sizeof(uint32_t);
+        
         // Scene data comes after resource table
         header.sceneDataOffset = offset;
         header.sceneDataSize = sceneData.size();
@@ -305,6 +554,9 @@ void setSceneData(const T& sceneStruct) {
             out.write(reinterpret_cast<const char*>(&res.entry.compression), 1);
         }
         
+        // Write name index
+        out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(uint32_t));
+        
         // Write scene data
         out.write(reinterpret_cast<const char*>(sceneData.data()), sceneData.size());
         
@@ -313,48 +565,55 @@ void setSceneData(const T& sceneStruct) {
             out.write(reinterpret_cast<const char*>(res.data.data()), res.data.size());
         }
         
+        out.close();
         return out.good();
     }
     
-    // Get resource count
-    size_t getResourceCount() const { return resources.size(); }
+    // Twice as many slots as resources keeps probe chains short
+    size_t indexSlotCount() const {
+        if (resources.empty()) return 0;
+        size_t slots = 1;
+        while (slots < resources.size() * 2) slots <<= 1;
+        return slots;
+    }
     
-    // Get total package size estimate
-    size_t estimateSize() const {
-        size_t total = sizeof(PackageHeader) + sceneData.size();
-        for (const auto& res : resources) {
-            total += 1 + 2 + res.entry.name.size() + 
-                    2 + res.entry.virtualPath.size() + 8 + 8 + 8 + 4 + 1;
-            total += res.data.size();
+    // [slotCount][name slots][path slots], each slot {hash, entry + 1}
+    std::vector<uint32_t> buildNameIndex() const {
+        size_t slotCount = indexSlotCount();
+        std::vector<uint32_t> index(1 + slotCount * 4, 0);
+        index[0] = static_cast<uint32_t>(slotCount);
+        
+        auto insert = [&](uint32_t* slots, const std::string& key, uint32_t entry) {
+            uint32_t hash = hashName(key);
+            size_t mask = slotCount - 1;
+            size_t i = hash & mask;
+            while (slots[i * 2 + 1] != 0) i = (i + 1) & mask;
+            slots[i * 2] = hash;
+            slots[i * 2 + 1] = entry + 1;
+        };
+        
+        for (size_t i = 0; i < resources.size(); i++) {
+            insert(index.data() + 1, resources[i].entry.name, static_cast<uint32_t>(i));
+            insert(index.data() + 1 + slotCount * 2, resources[i].entry.virtualPath, static_cast<uint32_t>(i));
         }
-        return total;
+        return index;
     }
     
-private:
-    std::vector<Resource> resources;
-    std::vector<uint8_t> sceneData;
-    
     std::vector<uint8_t> compressData(const std::vector<uint8_t>& data, 
-                                     CompressionType type) {
-        #ifdef USE_COMPRESSION
-        if (type == CompressionType::Deflate) {
-            uLongf compressedSize = compressBound(data.size());
-            std::vector<uint8_t> compressed(compressedSize);
-            
-            int result = compress(compressed.data(), &compressedSize,
-                                 data.data(), data.size());
-            
-            if (result == Z_OK) {
-                compressed.resize(compressedSize);
-                return compressed;
-            }
-        }
-        #endif
-        // Compression not available or failed
-        return {};
+                                     CompressionType type, ChunkCache* cache) {
+        // Empty when the codec isn't built in or the data doesn't shrink
+        return ChunkedCodec::compress(data.data(), data.size(), type,
+                                      compressionLevel, chunkSize, compressionThreads, cache);
     }
 };
 
+// Decode a stored resource; empty on failure or when the codec isn't built in
+inline std::vector<uint8_t> decompressBytes(const uint8_t* compressed, size_t compressedSize,
+                                            CompressionType type, size_t originalSize,
+                                            unsigned threads = 0) {
+    return ChunkedCodec::decompress(compressed, compressedSize, type, originalSize, threads);
+}
+
 // Scene Package Reader
 class PackageReader {
 public:
@@ -363,6 +622,7 @@ public:
     bool open(const std::string& filepath) {
         file.open(filepath, std::ios::binary);
         if (!file) return false;
+        path = filepath;
         
         // Read header
         file.read(reinterpret_cast<char*>(&header), sizeof(header));
@@ -399,6 +659,7 @@ public:
             resourceEntries.push_back(entry);
         }
         
+        verified.assign(resourceEntries.size(), false);
         return true;
     }
     
@@ -408,14 +669,17 @@ public:
         }
     }
     
+    // Checksum policy for readResource (default: every read)
+    void setVerifyPolicy(VerifyPolicy policy) {
+        verifyPolicy = policy;
+    }
+    
     // Read scene data
     std::vector<uint8_t> readSceneData() {
         if (!file.is_open()) return {};
         
-        file.seekg(header.sceneDataOffset);
-        std::vector<uint8_t> data(header.sceneDataSize);
-        file.read(reinterpret_cast<char*>(data.data()), header.sceneDataSize);
-        
+        std::vector<uint8_t> data;
+        readRange(header.sceneDataOffset, header.sceneDataSize, data);
         return data;
     }
     
@@ -426,10 +690,10 @@ public:
         
         if (header.sceneDataSize != sizeof(T)) return false;
         
-        file.seekg(header.sceneDataOffset);
-        file.read(reinterpret_cast<char*>(&sceneStruct), sizeof(T));
-        
-        return file.good();
+        std::vector<uint8_t> data;
+        if (!readRange(header.sceneDataOffset, sizeof(T), data)) return false;
+        std::memcpy(&sceneStruct, data.data(), sizeof(T));
+        return true;
     }
     
     // Get resource list
@@ -461,10 +725,9 @@ public:
         
         const auto& entry = resourceEntries[index];
         
-        file.seekg(entry.dataOffset);
         size_t readSize = entry.isCompressed() ? entry.compressedSize : entry.dataSize;
-        std::vector<uint8_t> data(readSize);
-        file.read(reinterpret_cast<char*>(data.data()), readSize);
+        std::vector<uint8_t> data;
+        if (!readRange(entry.dataOffset, readSize, data)) return {};
         
         // Decompress if needed
         if (entry.isCompressed()) {
@@ -474,10 +737,14 @@ public:
         }
         
         // Verify checksum
-        uint32_t checksum = calculateCRC32(data.data(), data.size());
-        if (checksum != entry.checksum) {
-            // Checksum mismatch!
-            return {};
+        if (verifyPolicy == VerifyPolicy::Always ||
+            (verifyPolicy == VerifyPolicy::Once && !verified[index])) {
+            uint32_t checksum = calculateCRC32Parallel(data.data(), data.size());
+            if (checksum != entry.checksum) {
+                // Checksum mismatch!
+                return {};
+            }
+            verified[index] = true;
         }
         
         return data;
@@ -522,27 +789,447 @@ public:
     size_t getResourceCount() const { return resourceEntries.size(); }
     
 private:
-    std::ifstream file;
+    std::ifstream file;     // Header and table; resource data goes through AsyncIO
+    std::string path;
     PackageHeader header;
     std::vector<ResourceEntry> resourceEntries;
+    VerifyPolicy verifyPolicy = VerifyPolicy::Always;
+    std::vector<bool> verified;
     
     std::vector<uint8_t> decompressData(const std::vector<uint8_t>& compressed,
                                        CompressionType type,
                                        size_t originalSize) {
-        #ifdef USE_COMPRESSION
-        if (type == CompressionType::Deflate) {
-            std::vector<uint8_t> decompressed(originalSize);
-            uLongf destLen = originalSize;
+        return decompressBytes(compressed.data(), compressed.size(), type, originalSize);
+    }
+    
+    bool readRange(uint64_t offset, uint64_t bytes, std::vector<uint8_t>& out) {
+        if (bytes == 0) {
+            out.clear();
+            return true;
+        }
+        AsyncIO::ReadRequest request;
+        request.path = path;
+        request.offset = offset;
+        request.size = bytes;
+        request.priority = AsyncIO::Priority::High;
+        AsyncIO::Ticket ticket = AsyncIO::Service::get().submit(request);
+        AsyncIO::ReadResult& result = ticket.wait();
+        if (!result.ok()) return false;
+        out = result.buffer.toVector();
+        return true;
+    }
+};
+
+// How MappedPackageReader gets a package into memory
+enum class PackageIO {
+    Map,    // mmap; pages fault in when touched (random access, streaming)
+    Read    // Read it all on open with parallel direct I/O (whole-scene loads)
+};
+
+// Memory-mapped package reader
+//
+// open() maps the file and parses only the header and resource table, so
+// it costs the same for a 10 MB and a 10 GB package; resource pages are
+// faulted in by the OS when first touched. view() returns zero-copy views
+// into the mapping (valid until close()). Name lookups use the hashed
+// index stored in the package, or an in-memory one for older packages.
+//
+// Loads that will touch every resource anyway can open with
+// PackageIO::Read instead: the file is read through AsyncIO in large
+// parallel chunks, bypassing the page cache, which keeps a fast drive
+// busy where page faults would trickle in readahead-sized pieces.
+class MappedPackageReader {
+public:
+    MappedPackageReader() = default;
+    MappedPackageReader(const MappedPackageReader&) = delete;
+    MappedPackageReader& operator=(const MappedPackageReader&) = delete;
+    ~MappedPackageReader() { close(); }
+    
+    bool open(const std::string& filepath, PackageIO io = PackageIO::Map) {
+        close();
+        if (!map(filepath, io)) return false;
+        
+        if (size < sizeof(PackageHeader)) {
+            close();
+            return false;
+        }
+        std::memcpy(&header, base, sizeof(PackageHeader));
+        if (!header.isValid()) {
+            close();
+            return false;
+        }
+        
+        // Resources are read in whatever order the game asks for them
+        advise(0, size, Access::Random);
+        
+        size_t offset = sizeof(PackageHeader);
+        resourceEntries.clear();
+        resourceEntries.reserve(header.resourceCount);
+        
+        for (uint32_t i = 0; i < header.resourceCount; i++) {
+            ResourceEntry entry;
+            uint16_t nameLen = 0, vpathLen = 0;
             
-            int result = uncompress(decompressed.data(), &destLen,
-                                   compressed.data(), compressed.size());
+            if (!read(offset, &entry.type, 1) || !read(offset, &nameLen, 2) ||
+                !readString(offset, entry.name, nameLen) || !read(offset, &vpathLen, 2) ||
+                !readString(offset, entry.virtualPath, vpathLen) ||
+                !read(offset, &entry.dataOffset, 8) || !read(offset, &entry.dataSize, 8) ||
+                !read(offset, &entry.compressedSize, 8) || !read(offset, &entry.checksum, 4) ||
+                !read(offset, &entry.compression, 1)) {
+                close();
+                return false;
+            }
             
-            if (result == Z_OK) {
-                return decompressed;
+            uint64_t stored = entry.isCompressed() ? entry.compressedSize : entry.dataSize;
+            if (entry.dataOffset > size || stored > size - entry.dataOffset) {
+                close();
+                return false;
+            }
+            resourceEntries.push_back(std::move(entry));
+        }
+        
+        if (!loadNameIndex(offset)) {
+            close();
+            return false;
+        }
+        verified.reset(new std::atomic<bool>[resourceEntries.size()]());
+        return true;
+    }
+    
+    void close() {
+        #ifndef _WIN32
+        if (base && mapped) munmap(const_cast<uint8_t*>(base), size);
+        #endif
+        base = nullptr;
+        size = 0;
+        mapped = false;
+        fileData = AsyncIO::Buffer{};
+        resourceEntries.clear();
+        nameSlots = pathSlots = nullptr;
+        slotCount = 0;
+        nameLookup.clear();
+        pathLookup.clear();
+        verified.reset();
+    }
+    
+    // Checksum policy for reads (default: every read). verify() and
+    // verifyAll() always check. threads 0 checksums large resources on
+    // every core.
+    void setVerifyPolicy(VerifyPolicy policy, unsigned threads = 0) {
+        verifyPolicy = policy;
+        verifyThreads = threads;
+    }
+    
+    bool isOpen() const { return base != nullptr; }
+    
+    // Scene data as a view
+    DataView sceneData() const {
+        if (!base || header.sceneDataOffset > size || header.sceneDataSize > size - header.sceneDataOffset) {
+            return {};
+        }
+        return {base + header.sceneDataOffset, static_cast<size_t>(header.sceneDataSize)};
+    }
+    
+    template<typename T>
+    bool readSceneData(T& sceneStruct) const {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "Scene struct must be trivially copyable");
+        
+        DataView view = sceneData();
+        if (view.size != sizeof(T)) return false;
+        std::memcpy(&sceneStruct, view.data, sizeof(T));
+        return true;
+    }
+    
+    const std::vector<ResourceEntry>& getResourceEntries() const {
+        return resourceEntries;
+    }
+    
+    int findResource(const std::string& name) const {
+        return find(nameSlots, nameLookup, name, false);
+    }
+    
+    int findResourceByPath(const std::string& virtualPath) const {
+        return find(pathSlots, pathLookup, virtualPath, true);
+    }
+    
+    // Zero-copy view of a resource's stored bytes. Empty for compressed
+    // resources (use readResource()); the checksum is not verified here.
+    DataView view(int index) const {
+        if (index < 0 || index >= static_cast<int>(resourceEntries.size())) return {};
+        const auto& entry = resourceEntries[index];
+        if (entry.isCompressed()) return {};
+        return {base + entry.dataOffset, static_cast<size_t>(entry.dataSize)};
+    }
+    
+    DataView view(const std::string& name) const {
+        return view(findResource(name));
+    }
+    
+    // CRC32 of the resource's bytes against the table (touches every page)
+    bool verify(int index) const {
+        if (index < 0 || index >= static_cast<int>(resourceEntries.size())) return false;
+        const auto& entry = resourceEntries[index];
+        if (entry.isCompressed()) {
+            std::vector<uint8_t> data(entry.dataSize);
+            const uint8_t* stored = base + entry.dataOffset;
+            if (!ChunkedCodec::decompressInto(stored, entry.compressedSize, entry.compression,
+                                              data.data(), data.size(), verifyThreads)) {
+                return false;
             }
+            return checksum(index, data.data(), data.size(), true);
+        }
+        return checksum(index, base + entry.dataOffset, entry.dataSize, true);
+    }
+    
+    // Verify every resource, spread across threads (0 = every core);
+    // under VerifyPolicy::Once this front-loads all checks to open time
+    bool verifyAll(unsigned threads = 0) const {
+        std::atomic<bool> ok{true};
+        ChunkedCodec::parallelFor(resourceEntries.size(), threads, [&](size_t i) {
+            if (!verify(static_cast<int>(i))) ok = false;
+        });
+        return ok;
+    }
+    
+    // verify() subject to the policy: what loaders call before using view()
+    bool check(int index) const {
+        if (index < 0 || index >= static_cast<int>(resourceEntries.size())) return false;
+        return !needsCheck(index) || verify(index);
+    }
+    
+    // Copying read with decompression and checksum, like PackageReader
+    std::vector<uint8_t> readResource(int index) const {
+        if (index < 0 || index >= static_cast<int>(resourceEntries.size())) return {};
+        const auto& entry = resourceEntries[index];
+        const uint8_t* stored = base + entry.dataOffset;
+        
+        std::vector<uint8_t> data;
+        if (entry.isCompressed()) {
+            data = decompressBytes(stored, entry.compressedSize, entry.compression, entry.dataSize);
+            if (data.empty()) return {};
+        } else {
+            data.assign(stored, stored + entry.dataSize);
+        }
+        
+        if (!checksum(index, data.data(), data.size(), false)) return {};
+        return data;
+    }
+    
+    std::vector<uint8_t> readResource(const std::string& name) const {
+        return readResource(findResource(name));
+    }
+    
+    // Decode a resource straight into caller memory (e.g. a mapped staging
+    // buffer) with no intermediate copy. dstSize must equal the resource's
+    // uncompressed size; chunks decode in parallel (threads 0 = every core).
+    bool readInto(int index, uint8_t* dst, size_t dstSize, unsigned threads = 0) const {
+        if (index < 0 || index >= static_cast<int>(resourceEntries.size())) return false;
+        const auto& entry = resourceEntries[index];
+        if (entry.dataSize != dstSize) return false;
+        
+        const uint8_t* stored = base + entry.dataOffset;
+        CompressionType type = entry.isCompressed() ? entry.compression : CompressionType::None;
+        size_t storedSize = entry.isCompressed() ? entry.compressedSize : entry.dataSize;
+        if (!ChunkedCodec::decompressInto(stored, storedSize, type, dst, dstSize, threads)) return false;
+        
+        return checksum(index, dst, dstSize, false);
+    }
+    
+    // Decode a resource one chunk at a time for bounded-memory streaming:
+    // fn(uint64_t offset, const uint8_t* bytes, size_t size) -> bool (false stops).
+    // The CRC is folded in as chunks pass, so a mismatch is only reported
+    // (as false) after the last chunk has been handed out.
+    template<typename Fn>
+    bool readChunks(int index, Fn&& fn) const {
+        if (index < 0 || index >= static_cast<int>(resourceEntries.size())) return false;
+        const auto& entry = resourceEntries[index];
+        
+        const uint8_t* stored = base + entry.dataOffset;
+        CompressionType type = entry.isCompressed() ? entry.compression : CompressionType::None;
+        size_t storedSize = entry.isCompressed() ? entry.compressedSize : entry.dataSize;
+        
+        bool checking = needsCheck(index);
+        uint32_t crc = 0xFFFFFFFF;
+        bool ok = ChunkedCodec::decompressChunks(stored, storedSize, type, entry.dataSize,
+            [&](uint64_t offset, const uint8_t* bytes, size_t count) {
+                if (checking) crc = updateCRC32(crc, bytes, count);
+                return fn(offset, bytes, count);
+            });
+        if (!ok || !checking) return ok;
+        
+        if ((crc ^ 0xFFFFFFFF) != entry.checksum) return false;
+        verified[index] = true;
+        return true;
+    }
+    
+    // Hint that a resource will be read front to back soon (read-ahead)
+    void prefetch(int index) const {
+        if (index < 0 || index >= static_cast<int>(resourceEntries.size())) return;
+        const auto& entry = resourceEntries[index];
+        size_t stored = entry.isCompressed() ? entry.compressedSize : entry.dataSize;
+        advise(entry.dataOffset, stored, Access::Sequential);
+        advise(entry.dataOffset, stored, Access::WillNeed);
+    }
+    
+    // Hint that a resource won't be needed again (lets the OS drop its pages)
+    void release(int index) const {
+        if (index < 0 || index >= static_cast<int>(resourceEntries.size())) return;
+        const auto& entry = resourceEntries[index];
+        advise(entry.dataOffset, entry.isCompressed() ? entry.compressedSize : entry.dataSize, Access::DontNeed);
+    }
+    
+    const PackageHeader& getHeader() const { return header; }
+    size_t getResourceCount() const { return resourceEntries.size(); }
+    size_t getMappedSize() const { return size; }
+    
+private:
+    enum class Access { Random, Sequential, WillNeed, DontNeed };
+    
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    AsyncIO::Buffer fileData; // Whole file for PackageIO::Read, or where mmap is unavailable
+    PackageHeader header;
+    std::vector<ResourceEntry> resourceEntries;
+    VerifyPolicy verifyPolicy = VerifyPolicy::Always;
+    unsigned verifyThreads = 0;
+    mutable std::unique_ptr<std::atomic<bool>[]> verified; // Passed a check (for VerifyPolicy::Once)
+    
+    // Stored index (points into the mapping) ...
+    const uint8_t* nameSlots = nullptr;
+    const uint8_t* pathSlots = nullptr;
+    uint32_t slotCount = 0;
+    // ... or one built on open for packages written without it
+    std::unordered_map<std::string, int> nameLookup;
+    std::unordered_map<std::string, int> pathLookup;
+    
+    bool needsCheck(int index) const {
+        if (verifyPolicy == VerifyPolicy::Never) return false;
+        return verifyPolicy == VerifyPolicy::Always || !verified[index];
+    }
+    
+    // CRC against the table; skipped when the policy allows unless forced
+    bool checksum(int index, const uint8_t* data, size_t count, bool force) const {
+        if (!force && !needsCheck(index)) return true;
+        if (calculateCRC32Parallel(data, count, verifyThreads) != resourceEntries[index].checksum) return false;
+        verified[index] = true;
+        return true;
+    }
+    
+    bool map(const std::string& filepath, PackageIO io) {
+        #ifndef _WIN32
+        if (io == PackageIO::Read) return readAll(filepath);
+        
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
         }
+        
+        void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps the file alive
+        if (addr == MAP_FAILED) return false;
+        
+        base = static_cast<const uint8_t*>(addr);
+        size = static_cast<size_t>(st.st_size);
+        mapped = true;
+        return true;
+        #else
+        (void)io;
+        return readAll(filepath);
         #endif
-        return {};
+    }
+    
+    bool readAll(const std::string& filepath) {
+        AsyncIO::ReadRequest request;
+        request.path = filepath;
+        request.priority = AsyncIO::Priority::High;
+        request.direct = true;
+        AsyncIO::Ticket ticket = AsyncIO::Service::get().submit(request);
+        AsyncIO::ReadResult& result = ticket.wait();
+        if (!result.ok() || result.buffer.empty()) return false;
+        fileData = std::move(result.buffer);
+        base = fileData.data();
+        size = fileData.size();
+        return true;
+    }
+    
+    // madvise() on the page-aligned range covering [offset, offset + length)
+    void advise(uint64_t offset, uint64_t length, Access access) const {
+        #ifndef _WIN32
+        if (!mapped || length == 0 || offset >= size) return;
+        static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t begin = static_cast<size_t>(offset) & ~(pageSize - 1);
+        size_t end = static_cast<size_t>(std::min<uint64_t>(offset + length, size));
+        
+        int advice = MADV_NORMAL;
+        switch (access) {
+            case Access::Random: advice = MADV_RANDOM; break;
+            case Access::Sequential: advice = MADV_SEQUENTIAL; break;
+            case Access::WillNeed: advice = MADV_WILLNEED; break;
+            case Access::DontNeed: advice = MADV_DONTNEED; break;
+        }
+        madvise(const_cast<uint8_t*>(base) + begin, end - begin, advice);
+        #else
+        (void)offset; (void)length; (void)access;
+        #endif
+    }
+    
+    bool read(size_t& offset, void* out, size_t bytes) const {
+        if (bytes > size - offset) return false;
+        std::memcpy(out, base + offset, bytes);
+        offset += bytes;
+        return true;
+    }
+    
+    bool readString(size_t& offset, std::string& out, size_t bytes) const {
+        if (bytes > size - offset) return false;
+        out.assign(reinterpret_cast<const char*>(base + offset), bytes);
+        offset += bytes;
+        return true;
+    }
+    
+    bool loadNameIndex(size_t offset) {
+        if (header.flags & FLAG_NAME_INDEX) {
+            if (!read(offset, &slotCount, 4)) return false;
+            size_t slotBytes = size_t(slotCount) * 2 * sizeof(uint32_t);
+            if ((slotCount & (slotCount - 1)) != 0 || slotBytes * 2 > size - offset) return false;
+            nameSlots = base + offset;
+            pathSlots = base + offset + slotBytes;
+            return true;
+        }
+        
+        for (size_t i = 0; i < resourceEntries.size(); i++) {
+            nameLookup.emplace(resourceEntries[i].name, static_cast<int>(i));
+            pathLookup.emplace(resourceEntries[i].virtualPath, static_cast<int>(i));
+        }
+        return true;
+    }
+    
+    int find(const uint8_t* slots, const std::unordered_map<std::string, int>& lookup,
+             const std::string& key, bool byPath) const {
+        if (!slots) {
+            auto it = lookup.find(key);
+            return it != lookup.end() ? it->second : -1;
+        }
+        if (slotCount == 0) return -1;
+        
+        uint32_t hash = hashName(key);
+        uint32_t mask = slotCount - 1;
+        for (uint32_t i = hash & mask, probes = 0; probes < slotCount; i = (i + 1) & mask, probes++) {
+            uint32_t slot[2];
+            std::memcpy(slot, slots + i * sizeof(slot), sizeof(slot));
+            if (slot[1] == 0) return -1;
+            if (slot[0] != hash || slot[1] > resourceEntries.size()) continue;
+            
+            const auto& entry = resourceEntries[slot[1] - 1];
+            if ((byPath ? entry.virtualPath : entry.name) == key) return static_cast<int>(slot[1] - 1);
+        }
+        return -1;
     }
 };
 
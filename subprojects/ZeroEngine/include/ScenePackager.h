@@ -6,7 +6,12 @@
 #include "PhysicsSystem.h"
 #include "ModelComponent.h"
 #include "CameraComponent.h"
+#include "Reflection.h"
+#include "AssetGraph.h"
 #include <iostream>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
 
 namespace ScenePackaging {
 
@@ -19,62 +24,272 @@ struct SceneMetadata {
     char sceneVersion[16] = {0};
 };
 
+// Engine components as seen by the serializer, registered on first use.
+// Game components registered with Reflection::Registry::get() at startup
+// are saved and loaded the same way.
+inline const Reflection::Registry& componentTypes() {
+    static const bool registered = [] {
+        auto& registry = Reflection::Registry::get();
+        registry.add<Transform>("Transform")
+            .field("position", &Transform::position)
+            .field("rotation", &Transform::rotation)
+            .field("scale", &Transform::scale)
+            .entity("parent", &Transform::parent);
+        registry.add<Tag>("Tag").field("name", &Tag::name).loaded([](Tag& tag) { tag.set(tag.name); });
+        registry.add<Layer>("Layer").field("mask", &Layer::mask);
+        registry.add<RigidBody>("RigidBody")
+            .field("velocity", &RigidBody::velocity)
+            .field("angularVelocity", &RigidBody::angularVelocity)
+            .field("mass", &RigidBody::mass)
+            .field("drag", &RigidBody::drag)
+            .field("useGravity", &RigidBody::useGravity)
+            .field("isKinematic", &RigidBody::isKinematic)
+            .field("continuousCollision", &RigidBody::continuousCollision);
+        // Mesh collider geometry is not stored; re-attach it after loading
+        registry.add<Collider>("Collider")
+            .field("type", &Collider::type)
+            .field("size", &Collider::size)
+            .field("radius", &Collider::radius)
+            .field("isTrigger", &Collider::isTrigger);
+        // Just the path, not the loaded model
+        registry.add<ModelComponent>("ModelComponent").field("modelPath", &ModelComponent::modelPath);
+        // Camera properties live in the Camera class
+        registry.add<CameraComponent>("CameraComponent").field("isActive", &CameraComponent::isActive);
+        return true;
+    }();
+    (void)registered;
+    return Reflection::Registry::get();
+}
+
+// Every component column starts with this. Format v3 follows it with the
+// column's schema: ColumnSchema, then per field a FieldRecord and its name.
+// Then come uint32 rows[count] (indices into the entity table), count *
+// stride bytes of packed records, and for each string field uint32
+// offsets[count + 1] and the concatenated characters.
+// v2 columns have no schema; their fixed layouts are in legacySchema().
+struct ColumnHeader {
+    uint32_t count = 0;
+    uint32_t stride = 0;
+};
+
+struct ColumnSchema {
+    uint32_t version = 1;
+    uint32_t fieldCount = 0;
+};
+
+struct FieldRecord {
+    uint8_t type = 0;
+    uint8_t reserved = 0;
+    uint16_t nameLength = 0;
+    uint32_t recordOffset = 0;
+};
+
+// A scene decoded into component arrays but not yet in an ECS. Columns
+// are independent, so each can be decoded on its own thread.
+template<typename T>
+using DecodedColumn = Reflection::TypedColumn<T>;
+
+struct SceneData {
+    std::vector<EntityID> savedIds;         // Sorted
+    uint32_t format = 0;                    // Package version the columns were written with
+    // One slot per registered component type. Entity fields (Transform
+    // parent) still hold saved IDs.
+    std::vector<std::unique_ptr<Reflection::ComponentColumn>> columns;
+
+    SceneData() : columns(componentTypes().size()) {}
+
+    // Decoded column of T, or nullptr if the scene has none
+    template<typename T>
+    DecodedColumn<T>* column() {
+        const Reflection::TypeInfo* type = componentTypes().find<T>();
+        if (!type || type->index >= columns.size() || !columns[type->index]) return nullptr;
+        return static_cast<DecodedColumn<T>*>(columns[type->index].get());
+    }
+};
+
+// Everything a save needs, copied out of the ECS. Once taken it no longer
+// touches the ECS, so it can be compressed and written on another thread.
+struct SceneSnapshot {
+    struct Resource {
+        std::string name;
+        std::string virtualPath;
+        ScenePackage::ResourceType type;
+        std::vector<uint8_t> data;
+    };
+    std::vector<Resource> resources;
+    SceneMetadata metadata;
+};
+
+// Per-resource chunk caches kept between saves of the same scene
+using SaveCache = std::unordered_map<std::string, ScenePackage::ChunkCache>;
+
+struct SaveStats {
+    size_t packageBytes = 0;
+    size_t chunksReused = 0;    // Taken from the cache unchanged
+    size_t chunksEncoded = 0;
+};
+
 // Helper to save ECS scene as a package
+//
+// Scenes are written as format v3: a sorted table of saved entity IDs and
+// one contiguous column per reflected component type, so loading is a
+// handful of bulk reads. v2 packages (fixed column layouts) and the
+// per-entity v1 layout still load.
 class ScenePackager {
 public:
-    static bool saveScene(ECS* ecs, const std::string& filepath, const std::string& sceneName = "Untitled") {
-        ScenePackage::PackageWriter writer;
-        
-        // === 1. Prepare scene metadata ===
-        SceneMetadata metadata;
-        
-        // Count active entities
-        uint32_t entityCount = 0;
-        for (size_t i = 0; i < 10000; ++i) {
-            if (ecs->getComponent<Transform>(i) || ecs->getComponent<Tag>(i)) {
-                entityCount++;
-            }
-        }
-        
-        metadata.entityCount = entityCount;
-        metadata.componentTypeCount = 7; // Transform, Tag, Layer, RigidBody, Collider, ModelComponent, CameraComponent
+    static constexpr uint32_t FORMAT_VERSION = 3;
+    
+    // compression applies to the entity table and columns; LZ4 keeps loads fast
+    static bool saveScene(ECS* ecs, const std::string& filepath, const std::string& sceneName = "Untitled",
+                          ScenePackage::CompressionType compression = ScenePackage::CompressionType::None) {
+        return writeSnapshot(snapshotScene(ecs, sceneName), filepath, compression);
+    }
+    
+    // Copy the scene out of the ECS: the entity table and packed columns,
+    // uncompressed. This is the only part of a save that needs the ECS.
+    static SceneSnapshot snapshotScene(ECS* ecs, const std::string& sceneName = "Untitled") {
+        SceneSnapshot snapshot;
+        
+        // === 1. Entity table (entities with a Transform or Tag) ===
+        std::vector<EntityID> ids;
+        ids.reserve(ecs->componentCount<Transform>() + ecs->componentCount<Tag>());
+        ecs->each<Transform>([&](EntityID e, Transform&) { ids.push_back(e); });
+        ecs->each<Tag>([&](EntityID e, Tag&) { ids.push_back(e); });
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        
+        // === 2. One column per component type ===
+        uint32_t columnCount = snapshotEntities(ecs, ids, false, "", snapshot.resources);
+        
+        // === 3. What the entities load (models; bundles add textures) ===
+        AssetGraph graph;
+        graph.addRoot("scene", ecs, ids);
+        storeAssetGraph(snapshot, graph);
+        
+        // === 4. Scene metadata ===
+        SceneMetadata& metadata = snapshot.metadata;
+        metadata.entityCount = static_cast<uint32_t>(ids.size());
+        metadata.componentTypeCount = columnCount;
         strncpy(metadata.sceneName, sceneName.c_str(), sizeof(metadata.sceneName) - 1);
-        strncpy(metadata.sceneVersion, "1.0.0", sizeof(metadata.sceneVersion) - 1);
-        
-        writer.setSceneData(metadata);
-        
-        // === 2. Serialize entity data as resources ===
-        for (size_t i = 0; i < 10000; ++i) {
-            auto* transform = ecs->getComponent<Transform>(i);
-            auto* tag = ecs->getComponent<Tag>(i);
-            
-            if (!transform && !tag) continue; // Skip inactive entities
-            
-            // Serialize entity to binary data
-            std::vector<uint8_t> entityData = serializeEntity(ecs, i);
-            if (entityData.empty()) continue;
+        strncpy(metadata.sceneVersion, "3.0.0", sizeof(metadata.sceneVersion) - 1);
+        return snapshot;
+    }
+    
+    // Entity table and columns for ids (sorted), named "<prefix>entities",
+    // "<prefix>Transform", ... Returns the number of columns written. When
+    // subset is false ids must be every entity with a Transform or Tag.
+    static uint32_t snapshotEntities(ECS* ecs, const std::vector<EntityID>& ids, bool subset,
+                                     const std::string& prefix, std::vector<SceneSnapshot::Resource>& out) {
+        // A dense lookup for whole scenes; subsets are small, so binary search
+        std::vector<uint32_t> rowOf;
+        if (!subset && !ids.empty()) {
+            rowOf.assign(ids.back() + 1, NO_ROW);
+            for (size_t i = 0; i < ids.size(); ++i) rowOf[ids[i]] = static_cast<uint32_t>(i);
+        }
+        auto rowFor = [&](EntityID e) {
+            if (!subset) return e < rowOf.size() ? rowOf[e] : NO_ROW;
+            auto it = std::lower_bound(ids.begin(), ids.end(), e);
+            return it != ids.end() && *it == e ? static_cast<uint32_t>(it - ids.begin()) : NO_ROW;
+        };
+        
+        std::vector<uint8_t> table;
+        writeBytes(table, static_cast<uint32_t>(ids.size()));
+        writeArray(table, ids.data(), ids.size());
+        out.push_back({prefix + "entities", "scene/" + prefix + "entities.bin",
+                       ScenePackage::ResourceType::EntityTable, std::move(table)});
+        
+        uint32_t columnCount = 0;
+        std::vector<uint32_t> rows;
+        std::vector<const void*> components;
+        const Reflection::Registry& types = componentTypes();
+        for (size_t t = 0; t < types.size(); ++t) {
+            const Reflection::TypeInfo& type = types[t];
+            rows.clear();
+            components.clear();
             
-            // Add as resource
-            std::string entityName = "entity_" + std::to_string(i);
-            if (tag) {
-                entityName = tag->name + "_" + std::to_string(i);
+            auto gather = [&](EntityID e, const void* component) {
+                uint32_t row = rowFor(e);
+                if (row == NO_ROW) return;
+                rows.push_back(row);
+                components.push_back(component);
+            };
+            if (subset) {
+                for (EntityID e : ids) {
+                    if (const void* component = type.find(ecs, e)) gather(e, component);
+                }
+            } else {
+                type.each(ecs, gather);
             }
             
-            writer.addResource(
-                entityName,
-                "entities/" + entityName + ".bin",
-                ScenePackage::ResourceType::Prefab,
-                std::move(entityData),
-                ScenePackage::CompressionType::None
-            );
+            if (rows.empty()) continue;
+            out.push_back({prefix + type.name, "scene/" + prefix + type.name + ".col",
+                           ScenePackage::ResourceType::ComponentColumn, packColumn(type, rows, components)});
+            columnCount++;
+        }
+        return columnCount;
+    }
+    
+    // Put graph in the snapshot, replacing the one already there
+    static void storeAssetGraph(SceneSnapshot& snapshot, const AssetGraph& graph) {
+        std::vector<uint8_t> data = graph.serialize();
+        for (auto& res : snapshot.resources) {
+            if (res.name == AssetGraph::RESOURCE_NAME) {
+                res.data = std::move(data);
+                return;
+            }
+        }
+        snapshot.resources.push_back({AssetGraph::RESOURCE_NAME, "scene/assets/graph.bin",
+                                      ScenePackage::ResourceType::AssetGraph, std::move(data)});
+    }
+    
+    static bool loadAssetGraph(const SceneSnapshot& snapshot, AssetGraph& graph) {
+        for (const auto& res : snapshot.resources) {
+            if (res.name == AssetGraph::RESOURCE_NAME) return graph.deserialize({res.data.data(), res.data.size()});
+        }
+        return false;
+    }
+    
+    // False when the package predates asset graphs (or its graph is corrupt)
+    static bool loadAssetGraph(const ScenePackage::MappedPackageReader& reader, AssetGraph& graph) {
+        int index = reader.findResource(AssetGraph::RESOURCE_NAME);
+        if (index < 0) return false;
+        std::vector<uint8_t> storage;
+        return graph.deserialize(resourceBytes(reader, index, storage));
+    }
+    
+    // Compress and write a snapshot; safe to call off the main thread. With
+    // caches from earlier saves of the same scene only changed chunks are
+    // re-encoded, so saving a mostly unchanged scene is mostly I/O.
+    static bool writeSnapshot(SceneSnapshot snapshot, const std::string& filepath,
+                              ScenePackage::CompressionType compression = ScenePackage::CompressionType::None,
+                              SaveCache* caches = nullptr, SaveStats* stats = nullptr) {
+        ScenePackage::PackageWriter writer;
+        writer.setVersion(FORMAT_VERSION);
+        
+        SaveStats totals;
+        for (auto& res : snapshot.resources) {
+            bool cached = caches && compression != ScenePackage::CompressionType::None;
+            ScenePackage::ChunkCache* cache = cached ? &(*caches)[res.name] : nullptr;
+            writer.addResource(res.name, res.virtualPath, res.type, std::move(res.data), compression, cache);
+            if (cache) {
+                totals.chunksReused += cache->reused;
+                totals.chunksEncoded += cache->encoded;
+            }
         }
+        writer.setSceneData(snapshot.metadata);
+        totals.packageBytes = writer.estimateSize();
+        if (stats) *stats = totals;
         
-        // === 3. Write the package ===
+        // === 5. Write the package ===
         if (writer.write(filepath)) {
             std::cout << "✓ Saved scene package: " << filepath << std::endl;
-            std::cout << "  Entities: " << entityCount << std::endl;
-            std::cout << "  Resources: " << writer.getResourceCount() << std::endl;
-            std::cout << "  Package size: " << writer.estimateSize() / 1024.0f << " KB" << std::endl;
+            std::cout << "  Entities: " << snapshot.metadata.entityCount << std::endl;
+            std::cout << "  Component columns: " << snapshot.metadata.componentTypeCount << std::endl;
+            std::cout << "  Package size: " << totals.packageBytes / 1024.0f << " KB" << std::endl;
+            if (totals.chunksReused + totals.chunksEncoded > 0) {
+                std::cout << "  Chunks re-encoded: " << totals.chunksEncoded << "/"
+                          << totals.chunksReused + totals.chunksEncoded << std::endl;
+            }
             return true;
         }
         
@@ -82,10 +297,13 @@ public:
         return false;
     }
     
-    static bool loadScene(ECS* ecs, const std::string& filepath) {
-        ScenePackage::PackageReader reader;
+    // verify chooses how often resource checksums are checked
+    static bool loadScene(ECS* ecs, const std::string& filepath,
+                          ScenePackage::VerifyPolicy verify = ScenePackage::VerifyPolicy::Always) {
+        ScenePackage::MappedPackageReader reader;
+        reader.setVerifyPolicy(verify);
         
-        if (!reader.open(filepath)) {
+        if (!reader.open(filepath, ScenePackage::PackageIO::Read)) {
             std::cerr << "✗ Failed to open scene package: " << filepath << std::endl;
             return false;
         }
@@ -101,84 +319,439 @@ public:
         std::cout << "  Version: " << metadata.sceneVersion << std::endl;
         std::cout << "  Expected entities: " << metadata.entityCount << std::endl;
         
-        // === 2. Load all entity resources ===
+        if (reader.getHeader().version >= 2) {
+            bool ok = loadColumns(ecs, reader);
+            reader.close();
+            return ok;
+        }
+        
+        // === 2. Load all entity resources (v1) ===
         const auto& entries = reader.getResourceEntries();
         uint32_t loadedCount = 0;
+        uint32_t failedCount = 0;
         
         for (size_t i = 0; i < entries.size(); ++i) {
             if (entries[i].type != ScenePackage::ResourceType::Prefab) continue;
             
             auto data = reader.readResource(static_cast<int>(i));
-            if (data.empty()) {
+            if (data.empty() || !deserializeEntity(ecs, data)) {
                 std::cerr << "  ✗ Failed to load entity: " << entries[i].name << std::endl;
+                failedCount++;
                 continue;
             }
-            
-            // Deserialize entity
-            if (deserializeEntity(ecs, data)) {
-                loadedCount++;
-            }
+            loadedCount++;
         }
         
         reader.close();
         
+        if (failedCount > 0) {
+            std::cerr << "✗ Failed to load " << failedCount << " entities from scene package" << std::endl;
+            return false;
+        }
         std::cout << "✓ Loaded " << loadedCount << " entities from scene package" << std::endl;
         return true;
     }
 
-private:
-    // Serialize a single entity to binary format
-    static std::vector<uint8_t> serializeEntity(ECS* ecs, EntityID id) {
-        std::vector<uint8_t> data;
+    // === Building blocks for staged loaders (see SceneLoadPipeline.h) ===
+    // Reading and decoding touch no ECS state and may run on worker threads;
+    // applyScene() must run on the thread that owns the ECS.
+    
+    // Resource bytes straight from the mapping after a checksum pass (per the
+    // reader's verify policy), or a decompressed copy in storage. Empty when
+    // missing or corrupt.
+    static ScenePackage::DataView resourceBytes(const ScenePackage::MappedPackageReader& reader, int index,
+                                                std::vector<uint8_t>& storage) {
+        if (index < 0) return {};
+        
+        if (!reader.getResourceEntries()[index].isCompressed()) {
+            if (!reader.check(index)) return {};
+            return reader.view(index);
+        }
+        storage.resize(reader.getResourceEntries()[index].dataSize);
+        if (!reader.readInto(index, storage.data(), storage.size())) return {};
+        return {storage.data(), storage.size()};
+    }
+    
+    static bool decodeEntityTable(ScenePackage::DataView table, SceneData& scene, uint32_t format = FORMAT_VERSION) {
+        uint32_t entityCount = 0;
+        if (table.size < sizeof(uint32_t)) {
+            std::cerr << "✗ Scene package has no entity table" << std::endl;
+            return false;
+        }
+        std::memcpy(&entityCount, table.data, sizeof(uint32_t));
+        if (table.size != sizeof(uint32_t) * (size_t(entityCount) + 1)) {
+            std::cerr << "✗ Corrupt entity table" << std::endl;
+            return false;
+        }
         
-        // Check all components
-        auto* transform = ecs->getComponent<Transform>(id);
-        auto* tag = ecs->getComponent<Tag>(id);
-        auto* layer = ecs->getComponent<Layer>(id);
-        auto* modelComp = ecs->getComponent<ModelComponent>(id);
-        auto* cameraComp = ecs->getComponent<CameraComponent>(id);
+        scene.format = format;
+        scene.savedIds.resize(entityCount);
+        std::memcpy(scene.savedIds.data(), table.data + sizeof(uint32_t), entityCount * sizeof(uint32_t));
+        return true;
+    }
+    
+    // Decode one component column into scene (the entity table must be
+    // decoded first). Saved fields are matched to the registered ones by
+    // name; when the layouts agree every record is a single copy. Unknown
+    // columns are skipped; false means corrupt.
+    static bool decodeColumn(const std::string& name, ScenePackage::DataView blob, SceneData& scene) {
+        const Reflection::TypeInfo* type = componentTypes().find(name);
+        if (!type || type->index >= scene.columns.size()) return true;
+        
+        SavedColumn saved;
+        size_t offset = scene.format >= 3 ? readSchema(blob, saved) : legacySchema(name, blob, saved);
+        if (offset == 0 || !readPayload(blob, offset, static_cast<uint32_t>(scene.savedIds.size()), saved)) {
+            std::cerr << "  ✗ Corrupt component column: " << name << std::endl;
+            return false;
+        }
+        
+        // Saved field for each registered one, by name or former name
+        struct Copy {
+            const Reflection::FieldInfo* to;
+            const SavedField* from;
+        };
+        std::vector<Copy> copies;
+        bool sameLayout = type->packed && saved.stride == type->recordSize;
+        
+        for (const Reflection::FieldInfo& field : type->fields) {
+            const SavedField* match = nullptr;
+            for (const SavedField& f : saved.fields) {
+                if (f.name == field.name) match = &f;
+            }
+            if (!match && !field.formerName.empty()) {
+                for (const SavedField& f : saved.fields) {
+                    if (f.name == field.formerName) match = &f;
+                }
+            }
+            
+            bool compatible = match && (match->type == field.type ||
+                                        (Reflection::isScalar(match->type) && Reflection::isScalar(field.type)));
+            if (!compatible) {
+                if (field.type != Reflection::FieldType::String) sameLayout = false;
+                continue;
+            }
+            if (field.type != Reflection::FieldType::String &&
+                (match->type != field.type || match->recordOffset != field.recordOffset)) {
+                sameLayout = false;
+            }
+            copies.push_back({&field, match});
+        }
         
-        // Component presence flags (2 bytes now - need more bits)
-        uint16_t flags = 0;
-        if (transform) flags |= 0x01;
-        if (tag) flags |= 0x02;
-        if (layer) flags |= 0x04;
-        if (modelComp) flags |= 0x20;      // ModelComponent
-        if (cameraComp) flags |= 0x40;     // CameraComponent
-        // 0x08 and 0x10 reserved for RigidBody and Collider
+        // With the same layout only strings are copied field by field
+        if (sameLayout) {
+            copies.erase(std::remove_if(copies.begin(), copies.end(), [](const Copy& copy) {
+                return copy.to->type != Reflection::FieldType::String;
+            }), copies.end());
+        }
         
-        writeBytes(data, flags);
+        const uint32_t count = static_cast<uint32_t>(saved.rows.size());
+        std::unique_ptr<Reflection::ComponentColumn> column = type->makeColumn();
+        column->rows = std::move(saved.rows);
+        column->resize(count);
+        uint8_t* base = count ? static_cast<uint8_t*>(column->at(0)) : nullptr;
         
-        // Serialize Transform
-        if (transform) {
-            writeBytes(data, transform->position);
-            writeBytes(data, transform->rotation);
-            writeBytes(data, transform->scale);
-            writeBytes(data, transform->parent);
+        for (uint32_t i = 0; i < count; ++i) {
+            uint8_t* component = base + size_t(i) * type->size;
+            const uint8_t* record = saved.records + size_t(i) * saved.stride;
+            
+            if (sameLayout) {
+                std::memcpy(component + type->spanOffset, record, type->recordSize);
+            }
+            for (const Copy& copy : copies) {
+                const Reflection::FieldInfo& to = *copy.to;
+                const SavedField& from = *copy.from;
+                if (to.type == Reflection::FieldType::String) {
+                    const std::vector<uint32_t>& offsets = from.stringOffsets;
+                    reinterpret_cast<std::string*>(component + to.offset)->assign(
+                        from.chars + offsets[i], offsets[i + 1] - offsets[i]);
+                } else if (from.type == to.type) {
+                    std::memcpy(component + to.offset, record + from.recordOffset, Reflection::fieldSize(to.type));
+                } else {
+                    Reflection::writeScalar(to.type, component + to.offset,
+                                            Reflection::readScalar(from.type, record + from.recordOffset));
+                }
+            }
+            if (saved.version < type->version && type->migrate) type->migrate(component, saved.version);
+            if (type->loaded) type->loaded(component);
         }
         
-        // Serialize Tag
-        if (tag) {
-            writeString(data, tag->name);
+        column->present = true;
+        scene.columns[type->index] = std::move(column);
+        return true;
+    }
+    
+    // Create the entities and bulk-add every decoded column. Returns the new
+    // entity for each saved row (same order as scene.savedIds).
+    static std::vector<EntityID> applyScene(ECS* ecs, SceneData& scene) {
+        const std::vector<EntityID>& savedIds = scene.savedIds;
+        std::vector<EntityID> entities(savedIds.size());
+        for (size_t i = 0; i < savedIds.size(); ++i) entities[i] = ecs->createEntity();
+        
+        // Saved IDs are sorted, so entity fields are remapped with a binary search
+        auto remap = [&](uint32_t saved, EntityID& out) {
+            auto it = std::lower_bound(savedIds.begin(), savedIds.end(), saved);
+            if (it == savedIds.end() || *it != saved) return false;
+            out = entities[it - savedIds.begin()];
+            return true;
+        };
+        
+        const Reflection::Registry& types = componentTypes();
+        std::vector<EntityID> targets;
+        for (size_t t = 0; t < scene.columns.size(); ++t) {
+            Reflection::ComponentColumn* column = scene.columns[t].get();
+            if (!column || !column->present) continue;
+            const Reflection::TypeInfo& type = types[t];
+            
+            for (const Reflection::FieldInfo& field : type.fields) {
+                if (field.type != Reflection::FieldType::Entity) continue;
+                uint8_t* base = column->rows.empty() ? nullptr : static_cast<uint8_t*>(column->at(0));
+                for (size_t i = 0; i < column->rows.size(); ++i) {
+                    EntityID& id = *reinterpret_cast<EntityID*>(base + i * type.size + field.offset);
+                    if (id != 0 && !remap(id, id)) id = 0;
+                }
+            }
+            
+            bindRows(column->rows, entities, targets);
+            column->addTo(ecs, targets);
+        }
+        
+        // Children lists aren't stored; rebuild them from the parents
+        if (auto* transforms = scene.column<Transform>()) {
+            for (uint32_t row : transforms->rows) {
+                EntityID child = entities[row];
+                auto* t = ecs->getComponent<Transform>(child);
+                if (t->parent == 0) continue;
+                if (auto* parent = ecs->getComponent<Transform>(t->parent)) parent->children.push_back(child);
+            }
+        }
+        
+        // Collision meshes aren't saved with the scene, so a Mesh collider
+        // would come back with nothing to collide against; drop it instead
+        if (auto* colliders = scene.column<Collider>()) {
+            size_t dropped = 0;
+            for (uint32_t row : colliders->rows) {
+                EntityID entity = entities[row];
+                auto* collider = ecs->getComponent<Collider>(entity);
+                if (collider && collider->type == ColliderType::Mesh && !collider->mesh) {
+                    ecs->removeComponent<Collider>(entity);
+                    dropped++;
+                }
+            }
+            if (dropped > 0) {
+                std::cerr << "  ✗ Skipped " << dropped << " mesh colliders (collision meshes aren't saved)" << std::endl;
+            }
+        }
+        return entities;
+    }
+
+private:
+    static constexpr uint32_t NO_ROW = 0xFFFFFFFF;
+    
+    // Load a columnar package: decode every column, then bulk-add them
+    static bool loadColumns(ECS* ecs, ScenePackage::MappedPackageReader& reader) {
+        // The columns are read front to back; ask the OS to read ahead
+        const auto& entries = reader.getResourceEntries();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].type == ScenePackage::ResourceType::EntityTable ||
+                entries[i].type == ScenePackage::ResourceType::ComponentColumn) {
+                reader.prefetch(static_cast<int>(i));
+            }
         }
         
-        // Serialize Layer
-        if (layer) {
-            writeBytes(data, layer->mask);
+        SceneData scene;
+        std::vector<uint8_t> storage;
+        if (!decodeEntityTable(resourceBytes(reader, reader.findResource("entities"), storage), scene,
+                               reader.getHeader().version)) {
+            return false;
         }
         
-        // Serialize ModelComponent (just the path, not the loaded model)
-        if (modelComp) {
-            writeString(data, modelComp->modelPath);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].type != ScenePackage::ResourceType::ComponentColumn) continue;
+            if (!decodeColumn(entries[i].name, resourceBytes(reader, static_cast<int>(i), storage), scene)) {
+                return false;
+            }
         }
         
-        // Serialize CameraComponent
-        if (cameraComp) {
-            writeBytes(data, cameraComp->isActive);
-            // CameraComponent only has isActive - camera properties are in Camera class
+        applyScene(ecs, scene);
+        std::cout << "✓ Loaded " << scene.savedIds.size() << " entities from scene package" << std::endl;
+        return true;
+    }
+    
+    // A column's schema and payload as stored, pointing into the blob
+    struct SavedField {
+        std::string name;
+        Reflection::FieldType type;
+        uint32_t recordOffset = 0;
+        std::vector<uint32_t> stringOffsets;    // count + 1, strings only
+        const char* chars = nullptr;
+    };
+    
+    struct SavedColumn {
+        uint32_t version = 1;
+        uint32_t count = 0;
+        uint32_t stride = 0;
+        std::vector<SavedField> fields;
+        std::vector<uint32_t> rows;
+        const uint8_t* records = nullptr;
+    };
+    
+    // Header and schema of a v3 column; returns the offset of the rows or 0
+    static size_t readSchema(ScenePackage::DataView blob, SavedColumn& saved) {
+        ColumnHeader header;
+        ColumnSchema schema;
+        if (blob.size < sizeof(ColumnHeader) + sizeof(ColumnSchema)) return 0;
+        std::memcpy(&header, blob.data, sizeof(ColumnHeader));
+        std::memcpy(&schema, blob.data + sizeof(ColumnHeader), sizeof(ColumnSchema));
+        saved.count = header.count;
+        saved.stride = header.stride;
+        saved.version = schema.version;
+        
+        size_t offset = sizeof(ColumnHeader) + sizeof(ColumnSchema);
+        for (uint32_t i = 0; i < schema.fieldCount; ++i) {
+            FieldRecord record;
+            if (blob.size < offset + sizeof(FieldRecord)) return 0;
+            std::memcpy(&record, blob.data + offset, sizeof(FieldRecord));
+            offset += sizeof(FieldRecord);
+            if (blob.size < offset + record.nameLength || record.type > uint8_t(Reflection::FieldType::String)) return 0;
+            
+            SavedField field;
+            field.name.assign(reinterpret_cast<const char*>(blob.data + offset), record.nameLength);
+            field.type = static_cast<Reflection::FieldType>(record.type);
+            field.recordOffset = record.recordOffset;
+            offset += record.nameLength;
+            if (size_t(field.recordOffset) + Reflection::fieldSize(field.type) > saved.stride) return 0;
+            saved.fields.push_back(std::move(field));
+        }
+        return offset;
+    }
+    
+    // v2 columns: the fixed record layouts they were written with
+    static size_t legacySchema(const std::string& name, ScenePackage::DataView blob, SavedColumn& saved) {
+        using FT = Reflection::FieldType;
+        struct LegacyField {
+            const char* name;
+            FT type;
+            uint32_t offset;
+        };
+        static const std::unordered_map<std::string, std::pair<uint32_t, std::vector<LegacyField>>> layouts = {
+            {"Transform", {44, {{"position", FT::Vec3, 0}, {"rotation", FT::Quat, 12},
+                                {"scale", FT::Vec3, 28}, {"parent", FT::Entity, 40}}}},
+            {"Tag", {0, {{"name", FT::String, 0}}}},
+            {"Layer", {4, {{"mask", FT::U32, 0}}}},
+            {"RigidBody", {36, {{"velocity", FT::Vec3, 0}, {"angularVelocity", FT::Vec3, 12},
+                                {"mass", FT::F32, 24}, {"drag", FT::F32, 28}, {"useGravity", FT::U8, 32},
+                                {"isKinematic", FT::U8, 33}, {"continuousCollision", FT::U8, 34}}}},
+            {"Collider", {20, {{"type", FT::U8, 0}, {"isTrigger", FT::U8, 1},
+                               {"size", FT::Vec3, 4}, {"radius", FT::F32, 16}}}},
+            {"ModelComponent", {0, {{"modelPath", FT::String, 0}}}},
+            {"CameraComponent", {1, {{"isActive", FT::U8, 0}}}},
+        };
+        
+        auto it = layouts.find(name);
+        ColumnHeader header;
+        if (it == layouts.end() || blob.size < sizeof(ColumnHeader)) return 0;
+        std::memcpy(&header, blob.data, sizeof(ColumnHeader));
+        if (header.stride != it->second.first) return 0;
+        
+        saved.count = header.count;
+        saved.stride = header.stride;
+        for (const LegacyField& f : it->second.second) {
+            SavedField field;
+            field.name = f.name;
+            field.type = f.type;
+            field.recordOffset = f.offset;
+            saved.fields.push_back(std::move(field));
+        }
+        return sizeof(ColumnHeader);
+    }
+    
+    // Rows, records and strings after the schema; false if they don't fit
+    // the blob exactly or a row is out of range
+    static bool readPayload(ScenePackage::DataView blob, size_t offset, uint32_t entityCount, SavedColumn& saved) {
+        size_t rowBytes = size_t(saved.count) * sizeof(uint32_t);
+        size_t recordBytes = size_t(saved.count) * saved.stride;
+        if (blob.size < offset + rowBytes + recordBytes) return false;
+        
+        saved.rows.resize(saved.count);
+        std::memcpy(saved.rows.data(), blob.data + offset, rowBytes);
+        for (uint32_t row : saved.rows) {
+            if (row >= entityCount) return false;
+        }
+        offset += rowBytes;
+        saved.records = blob.data + offset;
+        offset += recordBytes;
+        
+        for (SavedField& field : saved.fields) {
+            if (field.type != Reflection::FieldType::String) continue;
+            size_t offsetBytes = (size_t(saved.count) + 1) * sizeof(uint32_t);
+            if (blob.size < offset + offsetBytes) return false;
+            field.stringOffsets.resize(saved.count + 1);
+            std::memcpy(field.stringOffsets.data(), blob.data + offset, offsetBytes);
+            offset += offsetBytes;
+            
+            for (uint32_t i = 0; i < saved.count; ++i) {
+                if (field.stringOffsets[i] > field.stringOffsets[i + 1]) return false;
+            }
+            if (blob.size - offset < field.stringOffsets[saved.count]) return false;
+            field.chars = reinterpret_cast<const char*>(blob.data + offset);
+            offset += field.stringOffsets[saved.count];
+        }
+        return offset == blob.size;
+    }
+    
+    // One v3 column: schema, rows, then the records. A packed type's record
+    // is copied out of each component in one piece.
+    static std::vector<uint8_t> packColumn(const Reflection::TypeInfo& type, const std::vector<uint32_t>& rows,
+                                           const std::vector<const void*>& components) {
+        const uint32_t count = static_cast<uint32_t>(rows.size());
+        std::vector<uint8_t> blob;
+        blob.reserve(sizeof(ColumnHeader) + sizeof(ColumnSchema) + type.fields.size() * 32 +
+                     size_t(count) * (sizeof(uint32_t) + type.recordSize));
+        writeBytes(blob, ColumnHeader{count, type.recordSize});
+        writeBytes(blob, ColumnSchema{type.version, static_cast<uint32_t>(type.fields.size())});
+        for (const Reflection::FieldInfo& field : type.fields) {
+            writeBytes(blob, FieldRecord{static_cast<uint8_t>(field.type), 0,
+                                         static_cast<uint16_t>(field.name.size()), field.recordOffset});
+            blob.insert(blob.end(), field.name.begin(), field.name.end());
+        }
+        writeArray(blob, rows.data(), rows.size());
+        
+        size_t recordsAt = blob.size();
+        blob.resize(recordsAt + size_t(count) * type.recordSize);
+        uint8_t* out = blob.data() + recordsAt;
+        for (const void* component : components) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(component);
+            if (type.packed) {
+                std::memcpy(out, bytes + type.spanOffset, type.recordSize);
+            } else {
+                for (const Reflection::FieldInfo& field : type.fields) {
+                    if (field.type == Reflection::FieldType::String) continue;
+                    std::memcpy(out + field.recordOffset, bytes + field.offset, Reflection::fieldSize(field.type));
+                }
+            }
+            out += type.recordSize;
         }
         
-        return data;
+        for (const Reflection::FieldInfo& field : type.fields) {
+            if (field.type != Reflection::FieldType::String) continue;
+            std::vector<uint32_t> offsets(count + 1, 0);
+            for (uint32_t i = 0; i < count; ++i) {
+                auto* str = reinterpret_cast<const std::string*>(static_cast<const uint8_t*>(components[i]) + field.offset);
+                offsets[i + 1] = offsets[i] + static_cast<uint32_t>(str->size());
+            }
+            writeArray(blob, offsets.data(), offsets.size());
+            for (uint32_t i = 0; i < count; ++i) {
+                auto* str = reinterpret_cast<const std::string*>(static_cast<const uint8_t*>(components[i]) + field.offset);
+                blob.insert(blob.end(), str->begin(), str->end());
+            }
+        }
+        return blob;
+    }
+    
+    static void bindRows(const std::vector<uint32_t>& rows, const std::vector<EntityID>& entities,
+                         std::vector<EntityID>& targets) {
+        targets.resize(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) targets[i] = entities[rows[i]];
     }
     
     // Deserialize a single entity from binary format
@@ -205,7 +778,7 @@ private:
         // Deserialize Tag
         if (flags & 0x02) {
             Tag tag;
-            tag.name = readString(data, offset);
+            tag.set(readString(data, offset));
             ecs->addComponent(entity, tag);
         }
         
@@ -264,10 +837,10 @@ private:
         data.insert(data.end(), bytes, bytes + sizeof(T));
     }
     
-    static void writeString(std::vector<uint8_t>& data, const std::string& str) {
-        uint16_t len = static_cast<uint16_t>(str.size());
-        writeBytes(data, len);
-        data.insert(data.end(), str.begin(), str.end());
+    template<typename T>
+    static void writeArray(std::vector<uint8_t>& data, const T* values, size_t count) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values);
+        data.insert(data.end(), bytes, bytes + count * sizeof(T));
     }
     
     // Binary read helpers
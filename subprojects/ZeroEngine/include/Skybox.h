@@ -9,6 +9,7 @@
 #include <iostream>
 #include <string>
 #include <stb_image.h>
+#include "VirtualFileSystem.h"
 
 class Skybox {
     VkDevice device = VK_NULL_HANDLE;
@@ -109,8 +110,16 @@ private:
         
         stbi_set_flip_vertically_on_load(false);
         
+        // Read all six faces at once; they decode one by one below
+        std::vector<AsyncIO::Ticket> files = VFS::FileSystem::get().readBatch(faces, AsyncIO::Priority::High);
+        auto decodeFace = [&](int i, int& w, int& h, int& c) -> stbi_uc* {
+            const AsyncIO::ReadResult& file = files[i].wait();
+            if (!file.ok()) return nullptr;
+            return stbi_load_from_memory(file.buffer.data(), static_cast<int>(file.buffer.size()), &w, &h, &c, 4);
+        };
+        
         int width, height, channels;
-        stbi_uc* pixels = stbi_load(faces[0].c_str(), &width, &height, &channels, 4);
+        stbi_uc* pixels = decodeFace(0, width, height, channels);
         if (!pixels) {
             std::cerr << "Failed to load skybox face: " << faces[0] << "\n";
             return false;
@@ -143,7 +152,7 @@ private:
         stbi_image_free(pixels);
         
         for (int i = 1; i < 6; ++i) {
-            pixels = stbi_load(faces[i].c_str(), &width, &height, &channels, 4);
+            pixels = decodeFace(i, width, height, channels);
             if (!pixels) {
                 std::cerr << "Failed to load skybox face: " << faces[i] << "\n";
                 vmaUnmapMemory(allocator, stagingAlloc);
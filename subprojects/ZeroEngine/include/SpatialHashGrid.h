@@ -0,0 +1,456 @@
+#pragma once
+#include "Engine.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <utility>
+
+// Uniform spatial hash over entity positions, for neighbour queries.
+//
+// Each occupied cell stores its members' positions, layer masks and tag
+// IDs side by side, so radius and nearest queries never touch the ECS.
+// Cells also keep the union of their members' layer masks and a 32-bit
+// tag bloom, letting filtered queries skip whole cells. update() is
+// incremental: an entity that stays in its cell is rewritten in place.
+class SpatialHashGrid {
+public:
+    static constexpr uint32_t NO_TAG = 0;
+
+    explicit SpatialHashGrid(float cellSize = 4.0f) : cellSize(cellSize), invCellSize(1.0f / cellSize) {}
+
+    // Re-bucket every entity; pick roughly the typical query radius
+    void setCellSize(float size) {
+        if (size <= 0.0f || size == cellSize) return;
+
+        std::vector<std::pair<EntityID, Slot>> entries;
+        for (const Cell& cell : cells) {
+            for (size_t i = 0; i < cell.entities.size(); ++i) {
+                entries.push_back({cell.entities[i], {cell.positions[i], cell.masks[i], cell.tags[i]}});
+            }
+        }
+
+        clear();
+        cellSize = size;
+        invCellSize = 1.0f / size;
+        for (auto& [entity, slot] : entries) update(entity, slot.position, slot.mask, slot.tag);
+    }
+
+    float getCellSize() const { return cellSize; }
+
+    // Insert or move an entity. tag is a caller-assigned tag ID (NO_TAG for none).
+    void update(EntityID entity, glm::vec3 position, uint32_t layerMask, uint32_t tag) {
+        if (entity >= locations.size()) locations.resize(entity + 1);
+        Location& loc = locations[entity];
+        Coord coord = coordOf(position);
+
+        if (loc.cell >= 0) {
+            Cell& cell = cells[loc.cell];
+            if (cell.coord == coord) {
+                cell.positions[loc.slot] = position;
+                if (cell.masks[loc.slot] != layerMask || cell.tags[loc.slot] != tag) {
+                    cell.masks[loc.slot] = layerMask;
+                    cell.tags[loc.slot] = tag;
+                    cell.refreshFilters();
+                }
+                return;
+            }
+            detach(entity);
+        }
+
+        int32_t index = findOrCreateCell(coord);
+        Cell& cell = cells[index];
+        loc.cell = index;
+        loc.slot = static_cast<uint32_t>(cell.entities.size());
+        cell.entities.push_back(entity);
+        cell.positions.push_back(position);
+        cell.masks.push_back(layerMask);
+        cell.tags.push_back(tag);
+        cell.layerUnion |= layerMask;
+        cell.tagBloom |= bloomBit(tag);
+        ++entityCount;
+    }
+
+    void remove(EntityID entity) {
+        if (entity < locations.size() && locations[entity].cell >= 0) detach(entity);
+    }
+
+    void clear() {
+        cells.clear();
+        freeCells.clear();
+        lookup.clear();
+        locations.clear();
+        occupiedMin = {COORD_LIMIT, COORD_LIMIT, COORD_LIMIT};
+        occupiedMax = {-COORD_LIMIT, -COORD_LIMIT, -COORD_LIMIT};
+        entityCount = 0;
+    }
+
+    size_t size() const { return entityCount; }
+    size_t cellCount() const { return lookup.size(); }
+
+    // fn(EntityID, glm::vec3 position, float distanceSq) for every entity within
+    // radius that passes the layer mask (and carries tag, unless NO_TAG)
+    template<typename Fn>
+    void queryRadius(glm::vec3 center, float radius, uint32_t layerMask, uint32_t tag, Fn&& fn) const {
+        if (entityCount == 0 || radius < 0.0f) return;
+        float radiusSq = radius * radius;
+
+        auto visit = [&](const Cell& cell) {
+            if (!cell.passes(layerMask, tag)) return;
+            for (size_t i = 0; i < cell.entities.size(); ++i) {
+                if (!(cell.masks[i] & layerMask)) continue;
+                if (tag != NO_TAG && cell.tags[i] != tag) continue;
+                glm::vec3 d = cell.positions[i] - center;
+                float distSq = glm::dot(d, d);
+                if (distSq <= radiusSq) fn(cell.entities[i], cell.positions[i], distSq);
+            }
+        };
+
+        Coord lo = coordOf(center - glm::vec3(radius));
+        Coord hi = coordOf(center + glm::vec3(radius));
+        if (!clampToOccupied(lo, hi)) return;
+        double range = double(hi.x - lo.x + 1) * double(hi.y - lo.y + 1) * double(hi.z - lo.z + 1);
+
+        // Huge radius: walking the occupied cells is cheaper than probing empty ones
+        if (range > double(lookup.size())) {
+            for (const Cell& cell : cells) {
+                if (!cell.entities.empty() && cellDistanceSq(cell.coord, center) <= radiusSq) visit(cell);
+            }
+            return;
+        }
+
+        for (int32_t x = lo.x; x <= hi.x; ++x) {
+            for (int32_t y = lo.y; y <= hi.y; ++y) {
+                for (int32_t z = lo.z; z <= hi.z; ++z) {
+                    Coord coord{x, y, z};
+                    if (cellDistanceSq(coord, center) > radiusSq) continue;
+                    int32_t index = lookup.find(keyOf(coord));
+                    if (index >= 0) visit(cells[index]);
+                }
+            }
+        }
+    }
+
+    // Up to k nearest entities within maxDistance, closest first (ties by EntityID).
+    // Searches outward in shells of cells and stops once no unvisited cell can
+    // beat the current k-th distance.
+    void kNearest(glm::vec3 point, size_t k, float maxDistance, uint32_t layerMask, uint32_t tag,
+                  std::vector<std::pair<float, EntityID>>& out) const {
+        out.clear();
+        if (entityCount == 0 || k == 0 || maxDistance < 0.0f) return;
+
+        float maxDistSq = maxDistance * maxDistance;
+        // Max-heap on (distanceSq, entity): front is the current k-th best
+        auto bound = [&]() { return out.size() < k ? maxDistSq : out.front().first; };
+
+        auto visit = [&](const Cell& cell) {
+            if (!cell.passes(layerMask, tag)) return;
+            if (cellDistanceSq(cell.coord, point) > bound()) return;
+            for (size_t i = 0; i < cell.entities.size(); ++i) {
+                if (!(cell.masks[i] & layerMask)) continue;
+                if (tag != NO_TAG && cell.tags[i] != tag) continue;
+                glm::vec3 d = cell.positions[i] - point;
+                std::pair<float, EntityID> candidate{glm::dot(d, d), cell.entities[i]};
+                if (candidate.first > maxDistSq) continue;
+
+                if (out.size() < k) {
+                    out.push_back(candidate);
+                    std::push_heap(out.begin(), out.end());
+                } else if (candidate < out.front()) {
+                    std::pop_heap(out.begin(), out.end());
+                    out.back() = candidate;
+                    std::push_heap(out.begin(), out.end());
+                }
+            }
+        };
+
+        auto visitCell = [&](Coord coord) {
+            int32_t index = lookup.find(keyOf(coord));
+            if (index >= 0) visit(cells[index]);
+        };
+
+        Coord c = coordOf(point);
+        int32_t maxRing = static_cast<int32_t>(std::min(maxDistance * invCellSize, float(COORD_LIMIT))) + 1;
+
+        // Shells closer than the occupied region are empty; start at its distance
+        int32_t first = std::max({occupiedMin.x - c.x, c.x - occupiedMax.x, occupiedMin.y - c.y,
+                                  c.y - occupiedMax.y, occupiedMin.z - c.z, c.z - occupiedMax.z, 0});
+
+        for (int32_t r = first; r <= maxRing; ++r) {
+            // Shell r lies outside the cube of cells within r - 1 of the point's cell
+            if (r > 0) {
+                float gap = std::numeric_limits<float>::max();
+                for (int i = 0; i < 3; ++i) {
+                    float lo = (c[i] - r + 1) * cellSize, hi = (c[i] + r) * cellSize;
+                    gap = std::min({gap, point[i] - lo, hi - point[i]});
+                }
+                gap = std::max(gap, 0.0f);
+                if (gap * gap > bound()) break;
+            }
+
+            // Only the part of the shell overlapping occupied cells (flat worlds stay 2D)
+            Coord lo{c.x - r, c.y - r, c.z - r};
+            Coord hi{c.x + r, c.y + r, c.z + r};
+            clampToOccupied(lo, hi);
+            if (r > 0 && lo.x > c.x - r && hi.x < c.x + r && lo.y > c.y - r && hi.y < c.y + r &&
+                lo.z > c.z - r && hi.z < c.z + r) {
+                break; // Occupied region is inside the shell, so every cell has been seen
+            }
+
+            // A shell with more cells than the grid holds: finish with one pass
+            // over the occupied cells that haven't been visited yet
+            Coord innerLo{c.x - r + 1, c.y - r + 1, c.z - r + 1};
+            Coord innerHi{c.x + r - 1, c.y + r - 1, c.z + r - 1};
+            int64_t shellCells = volume(lo, hi) - (r > 0 && clampToOccupied(innerLo, innerHi) ? volume(innerLo, innerHi) : 0);
+            if (shellCells > int64_t(lookup.size())) {
+                for (const Cell& cell : cells) {
+                    if (!cell.entities.empty() && chebyshev(cell.coord, c) >= r) visit(cell);
+                }
+                break;
+            }
+
+            for (int32_t x = lo.x; x <= hi.x; ++x) {
+                for (int32_t y = lo.y; y <= hi.y; ++y) {
+                    bool edge = r == 0 || x == c.x - r || x == c.x + r || y == c.y - r || y == c.y + r;
+                    if (edge) {
+                        for (int32_t z = lo.z; z <= hi.z; ++z) visitCell({x, y, z});
+                    } else {
+                        if (c.z - r >= lo.z) visitCell({x, y, c.z - r});
+                        if (c.z + r <= hi.z) visitCell({x, y, c.z + r});
+                    }
+                }
+            }
+        }
+
+        std::sort_heap(out.begin(), out.end());
+    }
+
+private:
+    static constexpr int32_t COORD_LIMIT = (1 << 20) - 1; // 21 bits per axis in the key
+
+    struct Coord {
+        int32_t x = 0, y = 0, z = 0;
+        int32_t operator[](int i) const { return i == 0 ? x : (i == 1 ? y : z); }
+        bool operator==(const Coord& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+
+    struct Cell {
+        Coord coord;
+        std::vector<EntityID> entities;
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> masks;
+        std::vector<uint32_t> tags;
+        uint32_t layerUnion = 0;
+        uint32_t tagBloom = 0;
+
+        bool passes(uint32_t layerMask, uint32_t tag) const {
+            return (layerUnion & layerMask) && (tag == NO_TAG || (tagBloom & bloomBit(tag)));
+        }
+
+        void refreshFilters() {
+            layerUnion = 0;
+            tagBloom = 0;
+            for (size_t i = 0; i < masks.size(); ++i) {
+                layerUnion |= masks[i];
+                tagBloom |= bloomBit(tags[i]);
+            }
+        }
+    };
+
+    // Open-addressing hash map from packed cell key to cell index. Probing a
+    // flat array is much cheaper than std::unordered_map's node chains, and
+    // queries probe many cells that turn out to be empty.
+    class CellTable {
+    public:
+        int32_t find(uint64_t key) const {
+            if (slots.empty()) return -1;
+            for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+                if (slots[i].key == key) return slots[i].value;
+                if (slots[i].key == EMPTY) return -1;
+            }
+        }
+
+        void insert(uint64_t key, int32_t value) {
+            if ((count + 1) * 2 > slots.size()) grow();
+            size_t i = hash(key) & mask;
+            while (slots[i].key != EMPTY) i = (i + 1) & mask;
+            slots[i] = {key, value};
+            ++count;
+        }
+
+        // Backward-shift deletion keeps probe chains intact without tombstones
+        void erase(uint64_t key) {
+            if (slots.empty()) return;
+            size_t i = hash(key) & mask;
+            while (slots[i].key != key) {
+                if (slots[i].key == EMPTY) return;
+                i = (i + 1) & mask;
+            }
+            for (size_t j = (i + 1) & mask;; j = (j + 1) & mask) {
+                if (slots[j].key == EMPTY) break;
+                size_t home = hash(slots[j].key) & mask;
+                // Move j back into the hole unless its home lies cyclically in (i, j]
+                if (((j - home) & mask) >= ((j - i) & mask)) {
+                    slots[i] = slots[j];
+                    i = j;
+                }
+            }
+            slots[i].key = EMPTY;
+            --count;
+        }
+
+        void clear() {
+            slots.clear();
+            mask = 0;
+            count = 0;
+        }
+
+        size_t size() const { return count; }
+
+    private:
+        static constexpr uint64_t EMPTY = ~0ull; // Packed keys use 63 bits
+
+        struct Entry {
+            uint64_t key = EMPTY;
+            int32_t value = -1;
+        };
+
+        std::vector<Entry> slots;
+        size_t mask = 0;
+        size_t count = 0;
+
+        static size_t hash(uint64_t key) {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdull;
+            key ^= key >> 33;
+            return static_cast<size_t>(key);
+        }
+
+        void grow() {
+            std::vector<Entry> old = std::move(slots);
+            slots.assign(old.empty() ? 64 : old.size() * 2, Entry());
+            mask = slots.size() - 1;
+            count = 0;
+            for (const Entry& entry : old) {
+                if (entry.key != EMPTY) insert(entry.key, entry.value);
+            }
+        }
+    };
+
+    struct Location {
+        int32_t cell = -1;
+        uint32_t slot = 0;
+    };
+
+    struct Slot {
+        glm::vec3 position;
+        uint32_t mask;
+        uint32_t tag;
+    };
+
+    float cellSize;
+    float invCellSize;
+    std::vector<Cell> cells;
+    std::vector<int32_t> freeCells;
+    CellTable lookup; // Packed Coord -> index into cells
+    std::vector<Location> locations;              // Indexed by EntityID
+    size_t entityCount = 0;
+    Coord occupiedMin{COORD_LIMIT, COORD_LIMIT, COORD_LIMIT}; // Grows only; conservative
+    Coord occupiedMax{-COORD_LIMIT, -COORD_LIMIT, -COORD_LIMIT};
+
+    static uint32_t bloomBit(uint32_t tag) {
+        return tag == NO_TAG ? 0 : 1u << (tag & 31);
+    }
+
+    Coord coordOf(glm::vec3 p) const {
+        auto axis = [&](float v) {
+            float c = std::floor(v * invCellSize);
+            return static_cast<int32_t>(std::max(std::min(c, float(COORD_LIMIT)), float(-COORD_LIMIT)));
+        };
+        return {axis(p.x), axis(p.y), axis(p.z)};
+    }
+
+    static uint64_t keyOf(Coord c) {
+        auto bits = [](int32_t v) { return uint64_t(uint32_t(v + COORD_LIMIT + 1) & 0x1FFFFF); };
+        return (bits(c.x) << 42) | (bits(c.y) << 21) | bits(c.z);
+    }
+
+    // Intersect [lo, hi] with the occupied region; false when nothing is left
+    bool clampToOccupied(Coord& lo, Coord& hi) const {
+        lo = {std::max(lo.x, occupiedMin.x), std::max(lo.y, occupiedMin.y), std::max(lo.z, occupiedMin.z)};
+        hi = {std::min(hi.x, occupiedMax.x), std::min(hi.y, occupiedMax.y), std::min(hi.z, occupiedMax.z)};
+        return lo.x <= hi.x && lo.y <= hi.y && lo.z <= hi.z;
+    }
+
+    static int64_t volume(Coord lo, Coord hi) {
+        return int64_t(hi.x - lo.x + 1) * int64_t(hi.y - lo.y + 1) * int64_t(hi.z - lo.z + 1);
+    }
+
+    static int32_t chebyshev(Coord a, Coord b) {
+        return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z)});
+    }
+
+    // Squared distance from a point to a cell's box
+    float cellDistanceSq(Coord c, glm::vec3 p) const {
+        auto axis = [&](int32_t cell, float v) {
+            float lo = cell * cellSize, hi = lo + cellSize;
+            float d = v < lo ? lo - v : (v > hi ? v - hi : 0.0f);
+            return d * d;
+        };
+        return axis(c.x, p.x) + axis(c.y, p.y) + axis(c.z, p.z);
+    }
+
+    int32_t findOrCreateCell(Coord coord) {
+        uint64_t key = keyOf(coord);
+        int32_t existing = lookup.find(key);
+        if (existing >= 0) return existing;
+
+        int32_t index;
+        if (!freeCells.empty()) {
+            index = freeCells.back();
+            freeCells.pop_back();
+        } else {
+            index = static_cast<int32_t>(cells.size());
+            cells.emplace_back();
+        }
+        cells[index].coord = coord;
+        lookup.insert(key, index);
+        occupiedMin = {std::min(occupiedMin.x, coord.x), std::min(occupiedMin.y, coord.y), std::min(occupiedMin.z, coord.z)};
+        occupiedMax = {std::max(occupiedMax.x, coord.x), std::max(occupiedMax.y, coord.y), std::max(occupiedMax.z, coord.z)};
+        return index;
+    }
+
+    // Swap-remove from the entity's cell; empty cells go back on the free list
+    void detach(EntityID entity) {
+        Location& loc = locations[entity];
+        Cell& cell = cells[loc.cell];
+        uint32_t last = static_cast<uint32_t>(cell.entities.size() - 1);
+
+        if (loc.slot != last) {
+            EntityID moved = cell.entities[last];
+            cell.entities[loc.slot] = moved;
+            cell.positions[loc.slot] = cell.positions[last];
+            cell.masks[loc.slot] = cell.masks[last];
+            cell.tags[loc.slot] = cell.tags[last];
+            locations[moved].slot = loc.slot;
+        }
+        cell.entities.pop_back();
+        cell.positions.pop_back();
+        cell.masks.pop_back();
+        cell.tags.pop_back();
+
+        if (cell.entities.empty()) {
+            lookup.erase(keyOf(cell.coord));
+            cell.layerUnion = 0;
+            cell.tagBloom = 0;
+            freeCells.push_back(loc.cell);
+        } else {
+            cell.refreshFilters();
+        }
+
+        loc.cell = -1;
+        --entityCount;
+    }
+};
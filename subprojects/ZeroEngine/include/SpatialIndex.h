@@ -0,0 +1,125 @@
+#pragma once
+#include "Engine.h"
+#include "DynamicAABBTree.h"
+#include "SpatialHashGrid.h"
+#include "transform.h"
+#include "tags.h"
+#include "PhysicsSystem.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+// Mirrors entity world bounds into a DynamicAABBTree, and positions into
+// a SpatialHashGrid for neighbour queries.
+//
+// Every entity with a Transform gets a proxy: colliders use their world
+// AABB, everything else a point at its position. sync() walks the dense
+// Transform array once per frame and only touches the tree for proxies
+// that left their fat bounds, or whose layer/collider changed.
+class SpatialIndex {
+public:
+    static constexpr uint32_t HAS_COLLIDER = 1u << 0;
+    static constexpr size_t REBUILD_MIN_INSERTS = 256;
+
+    void sync(ECS* ecs) {
+        ++stamp;
+        size_t created = 0;
+
+        ecs->each<Transform>([&](EntityID entity, Transform& transform) {
+            auto* collider = ecs->getComponent<Collider>(entity);
+            auto* layer = ecs->getComponent<Layer>(entity);
+            auto* tag = ecs->getComponent<Tag>(entity);
+
+            AABB box{transform.position, transform.position};
+            if (collider) {
+                getColliderBounds(&transform, collider, box.min, box.max);
+                // Keep the origin inside so point queries can prune on the box
+                box.min = glm::min(box.min, transform.position);
+                box.max = glm::max(box.max, transform.position);
+            }
+
+            uint32_t mask = layer ? layer->mask : 0xFFFFFFFF;
+            uint32_t flags = collider ? HAS_COLLIDER : 0;
+
+            if (entity >= proxyOf.size()) {
+                proxyOf.resize(entity + 1, DynamicAABBTree::NULL_NODE);
+                lastSeen.resize(entity + 1, 0);
+                lastPosition.resize(entity + 1, glm::vec3(0));
+            }
+
+            int32_t& proxy = proxyOf[entity];
+            if (proxy == DynamicAABBTree::NULL_NODE) {
+                proxy = tree.createProxy(box, entity, mask, flags);
+                tracked.push_back(entity);
+                ++created;
+            } else {
+                tree.moveProxy(proxy, box, transform.position - lastPosition[entity]);
+                tree.setFilter(proxy, mask, flags);
+            }
+
+            grid.update(entity, transform.position, mask, tag ? tagId(tag->id) : SpatialHashGrid::NO_TAG);
+            lastPosition[entity] = transform.position;
+            lastSeen[entity] = stamp;
+        });
+
+        // Drop proxies for destroyed entities or removed transforms
+        for (size_t i = 0; i < tracked.size();) {
+            EntityID entity = tracked[i];
+            if (lastSeen[entity] != stamp) {
+                tree.destroyProxy(proxyOf[entity]);
+                grid.remove(entity);
+                proxyOf[entity] = DynamicAABBTree::NULL_NODE;
+                tracked[i] = tracked.back();
+                tracked.pop_back();
+            } else {
+                ++i;
+            }
+        }
+
+        // Bulk inserts (scene load, mass spawn) leave a poor incremental tree
+        if (created >= REBUILD_MIN_INSERTS && created * 4 >= tracked.size()) {
+            tree.rebuild();
+        }
+    }
+
+    void clear() {
+        tree.clear();
+        grid.clear();
+        tagIds.clear();
+        proxyOf.clear();
+        lastSeen.clear();
+        lastPosition.clear();
+        tracked.clear();
+    }
+
+    const DynamicAABBTree& getTree() const { return tree; }
+    DynamicAABBTree& getTree() { return tree; }
+    const SpatialHashGrid& getGrid() const { return grid; }
+    SpatialHashGrid& getGrid() { return grid; }
+    size_t size() const { return tracked.size(); }
+
+    // Grid tag ID for a tag name, or NO_TAG if no indexed entity has used it
+    uint32_t findTagId(Name name) const {
+        auto it = tagIds.find(name);
+        return it != tagIds.end() ? it->second : SpatialHashGrid::NO_TAG;
+    }
+
+private:
+    DynamicAABBTree tree;
+    SpatialHashGrid grid;
+    std::unordered_map<Name, uint32_t> tagIds; // Dense grid IDs of Tag names, from 1
+    std::vector<int32_t> proxyOf;        // Indexed by EntityID
+    std::vector<uint32_t> lastSeen;      // Sync stamp per EntityID
+    std::vector<glm::vec3> lastPosition; // For predictive fattening
+    std::vector<EntityID> tracked;
+    uint32_t stamp = 0;
+
+    uint32_t tagId(Name name) {
+        if (name.empty()) return SpatialHashGrid::NO_TAG;
+        auto it = tagIds.find(name);
+        if (it != tagIds.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(tagIds.size() + 1);
+        tagIds.emplace(name, id);
+        return id;
+    }
+};
@@ -4,10 +4,12 @@
 #include <vk_mem_alloc.h>
 #include <string>
 #include <iostream>
+#include "VirtualFileSystem.h"
 
 // Forward declare stbi functions instead of including stb_image.h
 extern "C" {
     unsigned char* stbi_load(const char* filename, int* x, int* y, int* channels_in_file, int desired_channels);
+    unsigned char* stbi_load_from_memory(const unsigned char* buffer, int len, int* x, int* y, int* channels_in_file, int desired_channels);
     void stbi_image_free(void* retval_from_stbi_load);
 }
 
@@ -39,10 +41,17 @@ public:
         graphicsQueue = queue;
     }
     
+    VmaAllocator getAllocator() const { return allocator; }
+    
     bool loadTexture(const std::string& filepath, Texture& texture) {
         // Load image from file
         int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        AsyncIO::Buffer file;
+        stbi_uc* pixels = nullptr;
+        if (VFS::readFile(filepath, file)) {
+            pixels = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+                                           &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        }
         
         if (!pixels) {
             std::cerr << "Failed to load texture: " << filepath << std::endl;
@@ -0,0 +1,630 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// Ray hit against a triangle mesh (local space of the mesh)
+struct TriangleHit {
+    float distance = 0.0f;
+    glm::vec3 normal{0};
+    uint32_t triangle = 0;
+};
+
+// Static triangle mesh collider backed by a SAH-built BVH.
+//
+// Built once at import/cook time and shared read-only between the physics
+// narrowphase and SpatialQuery raycasts. Triangles are stored in leaf order
+// and nodes are quantized to 16 bytes, so four nodes share a cache line.
+class TriangleMeshShape {
+public:
+    struct Triangle {
+        glm::vec3 v0, v1, v2;
+    };
+
+    struct Node {
+        uint16_t qmin[3];
+        uint16_t qmax[3];
+        uint32_t data; // Interior: rightChild << 3 (left child is next). Leaf: firstTriangle << 3 | count
+
+        bool isLeaf() const { return (data & 7u) != 0; }
+        uint32_t count() const { return data & 7u; }
+        uint32_t index() const { return data >> 3; }
+    };
+    static_assert(sizeof(Node) == 16, "BVH node should stay 16 bytes");
+
+    static constexpr uint32_t MAX_LEAF_TRIANGLES = 4;
+    static constexpr uint32_t SAH_BINS = 16;
+    static constexpr int MAX_STACK = 64;
+
+    // Build from an indexed triangle list
+    static std::shared_ptr<TriangleMeshShape> build(const std::vector<glm::vec3>& positions,
+                                                    const std::vector<uint32_t>& indices) {
+        auto shape = std::make_shared<TriangleMeshShape>();
+
+        std::vector<Triangle> source;
+        source.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            if (indices[i] >= positions.size() || indices[i + 1] >= positions.size() ||
+                indices[i + 2] >= positions.size()) continue;
+            source.push_back({positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]]});
+        }
+
+        shape->buildFrom(source);
+        return shape;
+    }
+
+    // Build from any vertex type with a glm::vec3 `position` member (e.g. Model::vertices)
+    template<typename VertexT>
+    static std::shared_ptr<TriangleMeshShape> fromVertices(const std::vector<VertexT>& vertices,
+                                                           const std::vector<uint32_t>& indices) {
+        std::vector<glm::vec3> positions;
+        positions.reserve(vertices.size());
+        for (const auto& v : vertices) positions.push_back(v.position);
+        return build(positions, indices);
+    }
+
+    // === Queries (all in mesh local space) ===
+
+    // Closest hit along origin + dir * t, t in [0, maxDistance]
+    bool raycast(glm::vec3 origin, glm::vec3 dir, float maxDistance, TriangleHit& hit) const {
+        if (nodes.empty()) return false;
+
+        glm::vec3 invDir = 1.0f / dir;
+        float closest = maxDistance;
+        bool found = false;
+
+        uint32_t stack[MAX_STACK];
+        int sp = 0;
+        stack[sp++] = 0;
+
+        while (sp > 0) {
+            const Node& node = nodes[stack[--sp]];
+
+            if (node.isLeaf()) {
+                uint32_t first = node.index();
+                for (uint32_t i = 0; i < node.count(); ++i) {
+                    float t;
+                    if (rayTriangle(origin, dir, triangles[first + i], closest, t)) {
+                        closest = t;
+                        hit.distance = t;
+                        hit.triangle = first + i;
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            // Visit the nearer child first
+            uint32_t left = static_cast<uint32_t>(&node - nodes.data()) + 1;
+            uint32_t right = node.index();
+            float tLeft = rayNode(nodes[left], origin, invDir, closest);
+            float tRight = rayNode(nodes[right], origin, invDir, closest);
+
+            if (tLeft > tRight) { std::swap(tLeft, tRight); std::swap(left, right); }
+            if (tRight <= closest && sp < MAX_STACK) stack[sp++] = right;
+            if (tLeft <= closest && sp < MAX_STACK) stack[sp++] = left;
+        }
+
+        if (found) {
+            const Triangle& tri = triangles[hit.triangle];
+            hit.normal = glm::normalize(glm::cross(tri.v1 - tri.v0, tri.v2 - tri.v0));
+            if (glm::dot(hit.normal, dir) > 0.0f) hit.normal = -hit.normal;
+        }
+        return found;
+    }
+
+    // Calls fn(const Triangle&, uint32_t index) for every triangle whose node overlaps the box
+    template<typename Fn>
+    void queryAABB(glm::vec3 boxMin, glm::vec3 boxMax, Fn&& fn) const {
+        if (nodes.empty()) return;
+
+        uint32_t stack[MAX_STACK];
+        int sp = 0;
+        stack[sp++] = 0;
+
+        while (sp > 0) {
+            uint32_t idx = stack[--sp];
+            const Node& node = nodes[idx];
+
+            glm::vec3 nMin, nMax;
+            dequantize(node, nMin, nMax);
+            if (nMin.x > boxMax.x || nMax.x < boxMin.x ||
+                nMin.y > boxMax.y || nMax.y < boxMin.y ||
+                nMin.z > boxMax.z || nMax.z < boxMin.z) continue;
+
+            if (node.isLeaf()) {
+                uint32_t first = node.index();
+                for (uint32_t i = 0; i < node.count(); ++i) {
+                    fn(triangles[first + i], first + i);
+                }
+            } else if (sp + 2 <= MAX_STACK) {
+                stack[sp++] = node.index();
+                stack[sp++] = idx + 1;
+            }
+        }
+    }
+
+    // Closest point on the mesh to p, searching within maxDistance
+    bool closestPoint(glm::vec3 p, float maxDistance, glm::vec3& outPoint) const {
+        float bestSq = maxDistance * maxDistance;
+        bool found = false;
+        queryAABB(p - glm::vec3(maxDistance), p + glm::vec3(maxDistance),
+            [&](const Triangle& tri, uint32_t) {
+                glm::vec3 q = closestPointOnTriangle(p, tri.v0, tri.v1, tri.v2);
+                glm::vec3 d = q - p;
+                float distSq = glm::dot(d, d);
+                if (distSq < bestSq) {
+                    bestSq = distSq;
+                    outPoint = q;
+                    found = true;
+                }
+            });
+        return found;
+    }
+
+    // === Info ===
+
+    glm::vec3 getBoundsMin() const { return boundsMin; }
+    glm::vec3 getBoundsMax() const { return boundsMax; }
+    size_t getTriangleCount() const { return triangles.size(); }
+    size_t getNodeCount() const { return nodes.size(); }
+    const std::vector<Triangle>& getTriangles() const { return triangles; }
+    size_t getMemoryUsage() const {
+        return nodes.size() * sizeof(Node) + triangles.size() * sizeof(Triangle);
+    }
+
+    // === Cooking ===
+
+    // Layout: "ZTRI" | version | nodeCount | triangleCount | boundsMin | boundsMax | nodes | triangles
+    std::vector<uint8_t> serialize() const {
+        std::vector<uint8_t> out;
+        uint32_t version = 1;
+        uint32_t nodeCount = static_cast<uint32_t>(nodes.size());
+        uint32_t triCount = static_cast<uint32_t>(triangles.size());
+
+        out.insert(out.end(), {'Z', 'T', 'R', 'I'});
+        append(out, &version, sizeof(version));
+        append(out, &nodeCount, sizeof(nodeCount));
+        append(out, &triCount, sizeof(triCount));
+        append(out, &boundsMin, sizeof(boundsMin));
+        append(out, &boundsMax, sizeof(boundsMax));
+        append(out, nodes.data(), nodes.size() * sizeof(Node));
+        append(out, triangles.data(), triangles.size() * sizeof(Triangle));
+        return out;
+    }
+
+    static std::shared_ptr<TriangleMeshShape> deserialize(const uint8_t* data, size_t size) {
+        const size_t headerSize = 16 + 2 * sizeof(glm::vec3);
+        if (size < headerSize || std::memcmp(data, "ZTRI", 4) != 0) return nullptr;
+
+        uint32_t version, nodeCount, triCount;
+        std::memcpy(&version, data + 4, 4);
+        std::memcpy(&nodeCount, data + 8, 4);
+        std::memcpy(&triCount, data + 12, 4);
+        if (version != 1) return nullptr;
+        if (size < headerSize + size_t(nodeCount) * sizeof(Node) + size_t(triCount) * sizeof(Triangle)) {
+            return nullptr;
+        }
+
+        auto shape = std::make_shared<TriangleMeshShape>();
+        size_t offset = 16;
+        std::memcpy(&shape->boundsMin, data + offset, sizeof(glm::vec3)); offset += sizeof(glm::vec3);
+        std::memcpy(&shape->boundsMax, data + offset, sizeof(glm::vec3)); offset += sizeof(glm::vec3);
+
+        shape->nodes.resize(nodeCount);
+        std::memcpy(shape->nodes.data(), data + offset, nodeCount * sizeof(Node));
+        offset += nodeCount * sizeof(Node);
+
+        shape->triangles.resize(triCount);
+        std::memcpy(shape->triangles.data(), data + offset, triCount * sizeof(Triangle));
+
+        if (!shape->validTree()) return nullptr;
+        shape->updateQuantization();
+        return shape;
+    }
+
+    // === Geometry helpers ===
+
+    // Ericson, Real-Time Collision Detection 5.1.5
+    static glm::vec3 closestPointOnTriangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c) {
+        glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+        float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+        glm::vec3 bp = p - b;
+        float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3) return b;
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+        glm::vec3 cp = p - c;
+        float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6) return c;
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+            return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        }
+
+        float denom = 1.0f / (va + vb + vc);
+        return a + ab * (vb * denom) + ac * (vc * denom);
+    }
+
+    // Separating-axis test of an AABB against a triangle. On overlap, reports the
+    // axis of least penetration, oriented from the box towards the triangle.
+    static bool boxTriangleSAT(glm::vec3 center, glm::vec3 half,
+                               glm::vec3 a, glm::vec3 b, glm::vec3 c,
+                               glm::vec3& axisOut, float& depthOut) {
+        glm::vec3 edges[3] = {b - a, c - b, a - c};
+        glm::vec3 axes[13];
+        int count = 0;
+
+        axes[count++] = glm::vec3(1, 0, 0);
+        axes[count++] = glm::vec3(0, 1, 0);
+        axes[count++] = glm::vec3(0, 0, 1);
+        axes[count++] = glm::cross(edges[0], edges[1]);
+        for (int i = 0; i < 3; ++i) {
+            for (int e = 0; e < 3; ++e) {
+                glm::vec3 boxAxis(0);
+                boxAxis[i] = 1.0f;
+                axes[count++] = glm::cross(boxAxis, edges[e]);
+            }
+        }
+
+        depthOut = std::numeric_limits<float>::max();
+        for (int i = 0; i < count; ++i) {
+            float len = glm::length(axes[i]);
+            if (len < 1e-6f) continue;
+            glm::vec3 axis = axes[i] / len;
+
+            float pa = glm::dot(a, axis), pb = glm::dot(b, axis), pc = glm::dot(c, axis);
+            float triMin = glm::min(pa, glm::min(pb, pc));
+            float triMax = glm::max(pa, glm::max(pb, pc));
+
+            float boxCenter = glm::dot(center, axis);
+            float boxRadius = half.x * glm::abs(axis.x) + half.y * glm::abs(axis.y) + half.z * glm::abs(axis.z);
+
+            float overlap = glm::min(triMax - (boxCenter - boxRadius), (boxCenter + boxRadius) - triMin);
+            if (overlap <= 0.0f) return false;
+
+            if (overlap < depthOut) {
+                depthOut = overlap;
+                axisOut = (boxCenter < 0.5f * (triMin + triMax)) ? axis : -axis;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<Triangle> triangles;
+    glm::vec3 boundsMin{0};
+    glm::vec3 boundsMax{0};
+    glm::vec3 quantScale{1};    // world -> quantized
+    glm::vec3 dequantScale{1};  // quantized -> world
+
+    struct BuildRef {
+        glm::vec3 min, max, centroid;
+        uint32_t triangle;
+    };
+
+    static void append(std::vector<uint8_t>& out, const void* src, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(src);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    // Loaded trees: every child and leaf range in bounds, each node reached
+    // once, and shallow enough for the query stacks
+    bool validTree() const {
+        if (nodes.empty()) return triangles.empty();
+
+        std::vector<uint8_t> seen(nodes.size(), 0);
+        std::vector<std::pair<uint32_t, int>> pending{{0u, 0}};
+        size_t visited = 0;
+        while (!pending.empty()) {
+            auto [idx, depth] = pending.back();
+            pending.pop_back();
+            if (idx >= nodes.size() || seen[idx] || depth > MAX_STACK - 2) return false;
+            seen[idx] = 1;
+            visited++;
+
+            const Node& node = nodes[idx];
+            if (node.isLeaf()) {
+                if (size_t(node.index()) + node.count() > triangles.size()) return false;
+            } else {
+                pending.push_back({node.index(), depth + 1});
+                pending.push_back({idx + 1, depth + 1});
+            }
+        }
+        return visited == nodes.size();
+    }
+
+    // Levels of median splits until every leaf fits the 3-bit count
+    static int medianLevels(size_t count) {
+        int levels = 0;
+        for (; count > 7; count = (count + 1) / 2) levels++;
+        return levels;
+    }
+
+    static float surfaceArea(glm::vec3 mn, glm::vec3 mx) {
+        glm::vec3 d = glm::max(mx - mn, glm::vec3(0));
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    void updateQuantization() {
+        glm::vec3 extent = boundsMax - boundsMin;
+        for (int i = 0; i < 3; ++i) {
+            float e = extent[i] > 1e-6f ? extent[i] : 1e-6f;
+            quantScale[i] = 65535.0f / e;
+            dequantScale[i] = e / 65535.0f;
+        }
+    }
+
+    void quantize(glm::vec3 mn, glm::vec3 mx, Node& node) const {
+        // Round outwards so the quantized box always contains the real one
+        for (int i = 0; i < 3; ++i) {
+            float lo = std::floor((mn[i] - boundsMin[i]) * quantScale[i]);
+            float hi = std::ceil((mx[i] - boundsMin[i]) * quantScale[i]);
+            node.qmin[i] = static_cast<uint16_t>(glm::clamp(lo, 0.0f, 65535.0f));
+            node.qmax[i] = static_cast<uint16_t>(glm::clamp(hi, 0.0f, 65535.0f));
+        }
+    }
+
+    void dequantize(const Node& node, glm::vec3& mn, glm::vec3& mx) const {
+        for (int i = 0; i < 3; ++i) {
+            mn[i] = boundsMin[i] + float(node.qmin[i]) * dequantScale[i];
+            mx[i] = boundsMin[i] + float(node.qmax[i]) * dequantScale[i];
+        }
+    }
+
+    void buildFrom(const std::vector<Triangle>& source) {
+        nodes.clear();
+        triangles.clear();
+        if (source.empty()) return;
+
+        std::vector<BuildRef> refs(source.size());
+        boundsMin = glm::vec3(std::numeric_limits<float>::max());
+        boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+
+        for (size_t i = 0; i < source.size(); ++i) {
+            const Triangle& t = source[i];
+            BuildRef& r = refs[i];
+            r.min = glm::min(t.v0, glm::min(t.v1, t.v2));
+            r.max = glm::max(t.v0, glm::max(t.v1, t.v2));
+            r.centroid = (r.min + r.max) * 0.5f;
+            r.triangle = static_cast<uint32_t>(i);
+            boundsMin = glm::min(boundsMin, r.min);
+            boundsMax = glm::max(boundsMax, r.max);
+        }
+
+        updateQuantization();
+        nodes.reserve(2 * source.size() / MAX_LEAF_TRIANGLES + 1);
+        triangles.reserve(source.size());
+        buildNode(refs, 0, refs.size(), source, 0);
+    }
+
+    uint32_t buildNode(std::vector<BuildRef>& refs, size_t begin, size_t end,
+                       const std::vector<Triangle>& source, int depth) {
+        uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+
+        glm::vec3 mn(std::numeric_limits<float>::max()), mx(-std::numeric_limits<float>::max());
+        glm::vec3 cmn = mn, cmx = mx;
+        for (size_t i = begin; i < end; ++i) {
+            mn = glm::min(mn, refs[i].min);
+            mx = glm::max(mx, refs[i].max);
+            cmn = glm::min(cmn, refs[i].centroid);
+            cmx = glm::max(cmx, refs[i].centroid);
+        }
+        quantize(mn, mx, nodes[nodeIndex]);
+
+        size_t count = end - begin;
+        if (count <= MAX_LEAF_TRIANGLES) {
+            makeLeaf(nodeIndex, refs, begin, end, source);
+            return nodeIndex;
+        }
+
+        // Binned SAH split
+        int bestAxis = -1;
+        uint32_t bestBin = 0;
+        float bestCost = std::numeric_limits<float>::max();
+
+        for (int axis = 0; axis < 3; ++axis) {
+            float extent = cmx[axis] - cmn[axis];
+            if (extent < 1e-6f) continue;
+
+            struct Bin {
+                glm::vec3 min{std::numeric_limits<float>::max()};
+                glm::vec3 max{-std::numeric_limits<float>::max()};
+                uint32_t count = 0;
+            } bins[SAH_BINS];
+
+            float scale = SAH_BINS / extent;
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t b = std::min(SAH_BINS - 1, uint32_t((refs[i].centroid[axis] - cmn[axis]) * scale));
+                bins[b].count++;
+                bins[b].min = glm::min(bins[b].min, refs[i].min);
+                bins[b].max = glm::max(bins[b].max, refs[i].max);
+            }
+
+            // Right-to-left sweep for suffix areas
+            float rightArea[SAH_BINS];
+            uint32_t rightCount[SAH_BINS];
+            glm::vec3 rmn(std::numeric_limits<float>::max()), rmx(-std::numeric_limits<float>::max());
+            uint32_t rc = 0;
+            for (int b = SAH_BINS - 1; b > 0; --b) {
+                rc += bins[b].count;
+                if (bins[b].count) {
+                    rmn = glm::min(rmn, bins[b].min);
+                    rmx = glm::max(rmx, bins[b].max);
+                }
+                rightArea[b] = rc ? surfaceArea(rmn, rmx) : 0.0f;
+                rightCount[b] = rc;
+            }
+
+            glm::vec3 lmn(std::numeric_limits<float>::max()), lmx(-std::numeric_limits<float>::max());
+            uint32_t lc = 0;
+            for (uint32_t b = 0; b + 1 < SAH_BINS; ++b) {
+                lc += bins[b].count;
+                if (bins[b].count) {
+                    lmn = glm::min(lmn, bins[b].min);
+                    lmx = glm::max(lmx, bins[b].max);
+                }
+                if (lc == 0 || rightCount[b + 1] == 0) continue;
+
+                float cost = surfaceArea(lmn, lmx) * lc + rightArea[b + 1] * rightCount[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = b;
+                }
+            }
+        }
+
+        size_t mid;
+        if (bestAxis >= 0) {
+            float scale = SAH_BINS / (cmx[bestAxis] - cmn[bestAxis]);
+            float minC = cmn[bestAxis];
+            auto it = std::partition(refs.begin() + begin, refs.begin() + end,
+                [&](const BuildRef& r) {
+                    return std::min(SAH_BINS - 1, uint32_t((r.centroid[bestAxis] - minC) * scale)) <= bestBin;
+                });
+            mid = static_cast<size_t>(it - refs.begin());
+        } else {
+            // All centroids coincide: split in the middle
+            mid = begin + count / 2;
+        }
+
+        // Median splits keep the rest balanced once the depth budget is
+        // tight, so every leaf stays within the query stacks
+        bool tight = depth + medianLevels(count) >= MAX_STACK - 2;
+        if (mid == begin || mid == end || tight) {
+            if (count <= 7) {
+                makeLeaf(nodeIndex, refs, begin, end, source);
+                return nodeIndex;
+            }
+            glm::vec3 extent = cmx - cmn;
+            int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+            mid = begin + count / 2;
+            std::nth_element(refs.begin() + begin, refs.begin() + mid, refs.begin() + end,
+                [axis](const BuildRef& a, const BuildRef& b) { return a.centroid[axis] < b.centroid[axis]; });
+        }
+
+        buildNode(refs, begin, mid, source, depth + 1);
+        uint32_t right = buildNode(refs, mid, end, source, depth + 1);
+        nodes[nodeIndex].data = right << 3;
+        return nodeIndex;
+    }
+
+    void makeLeaf(uint32_t nodeIndex, const std::vector<BuildRef>& refs, size_t begin, size_t end,
+                  const std::vector<Triangle>& source) {
+        uint32_t first = static_cast<uint32_t>(triangles.size());
+        for (size_t i = begin; i < end; ++i) {
+            triangles.push_back(source[refs[i].triangle]);
+        }
+        nodes[nodeIndex].data = (first << 3) | static_cast<uint32_t>(end - begin);
+    }
+
+    // Entry distance into a node, or +inf when missed
+    float rayNode(const Node& node, glm::vec3 origin, glm::vec3 invDir, float maxT) const {
+        glm::vec3 mn, mx;
+        dequantize(node, mn, mx);
+
+        const float miss = std::numeric_limits<float>::infinity();
+        float tNear = 0.0f;
+        float tFar = maxT;
+        for (int i = 0; i < 3; ++i) {
+            // Axis-parallel rays: avoid 0 * inf when the origin lies on a slab plane
+            if (std::isinf(invDir[i])) {
+                if (origin[i] < mn[i] || origin[i] > mx[i]) return miss;
+                continue;
+            }
+            float t1 = (mn[i] - origin[i]) * invDir[i];
+            float t2 = (mx[i] - origin[i]) * invDir[i];
+            if (t1 > t2) std::swap(t1, t2);
+            tNear = glm::max(tNear, t1);
+            tFar = glm::min(tFar, t2);
+            if (tNear > tFar) return miss;
+        }
+        return tNear;
+    }
+
+    // Möller–Trumbore, two-sided
+    static bool rayTriangle(glm::vec3 origin, glm::vec3 dir, const Triangle& tri, float maxT, float& t) {
+        glm::vec3 e1 = tri.v1 - tri.v0;
+        glm::vec3 e2 = tri.v2 - tri.v0;
+        glm::vec3 p = glm::cross(dir, e2);
+        float det = glm::dot(e1, p);
+        if (glm::abs(det) < 1e-10f) return false;
+
+        float invDet = 1.0f / det;
+        glm::vec3 s = origin - tri.v0;
+        float u = glm::dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+
+        glm::vec3 q = glm::cross(s, e1);
+        float v = glm::dot(dir, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+
+        t = glm::dot(e2, q) * invDet;
+        return t >= 0.0f && t < maxT;
+    }
+};
+
+// World placement of a mesh collider (position/rotation/scale of its Transform)
+struct MeshPlacement {
+    glm::vec3 position{0};
+    glm::quat rotation{1, 0, 0, 0};
+    glm::vec3 scale{1};
+
+    glm::vec3 toWorld(glm::vec3 local) const { return position + rotation * (local * scale); }
+    glm::vec3 toLocal(glm::vec3 world) const { return (glm::inverse(rotation) * (world - position)) / scale; }
+    glm::vec3 dirToLocal(glm::vec3 dir) const { return (glm::inverse(rotation) * dir) / scale; }
+    glm::vec3 normalToWorld(glm::vec3 n) const { return glm::normalize(rotation * (n / scale)); }
+
+    // Local-space AABB enclosing a world-space AABB
+    void boxToLocal(glm::vec3 center, glm::vec3 half, glm::vec3& outMin, glm::vec3& outMax) const {
+        glm::mat3 r = glm::mat3_cast(glm::inverse(rotation));
+        glm::vec3 c = toLocal(center);
+        glm::vec3 h(0);
+        for (int i = 0; i < 3; ++i) {
+            h += glm::abs(r[i]) * half[i];
+        }
+        h /= glm::abs(scale);
+        outMin = c - h;
+        outMax = c + h;
+    }
+
+    // World-space AABB of the whole mesh
+    void worldBounds(const TriangleMeshShape& mesh, glm::vec3& outMin, glm::vec3& outMax) const {
+        glm::vec3 lmin = mesh.getBoundsMin(), lmax = mesh.getBoundsMax();
+        glm::vec3 c = toWorld((lmin + lmax) * 0.5f);
+        glm::vec3 half = (lmax - lmin) * 0.5f * glm::abs(scale);
+        glm::mat3 r = glm::mat3_cast(rotation);
+        glm::vec3 h(0);
+        for (int i = 0; i < 3; ++i) {
+            h += glm::abs(r[i]) * half[i];
+        }
+        outMin = c - h;
+        outMax = c + h;
+    }
+
+    // Closest hit in world space; returns distance along the (normalized) world ray
+    bool raycast(const TriangleMeshShape& mesh, glm::vec3 origin, glm::vec3 dir, float maxDistance,
+                 TriangleHit& hit) const {
+        // Unnormalized local direction keeps t in world units
+        if (!mesh.raycast(toLocal(origin), dirToLocal(dir), maxDistance, hit)) return false;
+        hit.normal = normalToWorld(hit.normal);
+        return true;
+    }
+};
@@ -0,0 +1,465 @@
+#pragma once
+#include "timer.h"
+#include "transform.h"
+#include "Material.h"
+#include <array>
+#include <memory>
+#include <iostream>
+
+// Batched tweens
+//
+// Tween and LerpTimer (timer.h) are one object and one std::function per
+// animated value. TweenSystem keeps every active tween in structure-of-
+// arrays tracks, one per (easing curve, bound property) pair, and updates a
+// track in passes over plain float arrays: advance time, apply the curve
+// to the whole batch, blend each component, then write the results
+// through the track's binding. The curve is picked once per track, not
+// per tween, so these loops vectorize.
+//
+// Bindings say where results go: a float/vec2/vec3/vec4 the caller owns
+// (UI element fields, anything that outlives the tween), an entity's
+// Transform position or scale (tweens of destroyed entities end quietly),
+// or a Material's base color or emissive.
+
+enum class Ease : uint8_t {
+    Linear, InQuad, OutQuad, InOutQuad, InCubic, OutCubic, InOutCubic,
+    InSin, OutSin, InOutSin, InElastic, OutBounce,
+    Count
+};
+
+enum class TweenProperty : uint8_t {
+    Float, Vec2, Vec3, Vec4,            // Caller-owned values
+    Position, Scale,                    // Transform of an entity
+    BaseColor, Emissive,                // Material
+    Count
+};
+
+struct TweenBinding {
+    TweenProperty property = TweenProperty::Float;
+    uintptr_t target = 0;               // Pointer, or EntityID for Transform properties
+
+    static TweenBinding value(float* v) { return {TweenProperty::Float, reinterpret_cast<uintptr_t>(v)}; }
+    static TweenBinding value(glm::vec2* v) { return {TweenProperty::Vec2, reinterpret_cast<uintptr_t>(v)}; }
+    static TweenBinding value(glm::vec3* v) { return {TweenProperty::Vec3, reinterpret_cast<uintptr_t>(v)}; }
+    static TweenBinding value(glm::vec4* v) { return {TweenProperty::Vec4, reinterpret_cast<uintptr_t>(v)}; }
+    static TweenBinding position(EntityID e) { return {TweenProperty::Position, uintptr_t(e)}; }
+    static TweenBinding scale(EntityID e) { return {TweenProperty::Scale, uintptr_t(e)}; }
+    static TweenBinding baseColor(Material* m) { return {TweenProperty::BaseColor, reinterpret_cast<uintptr_t>(m)}; }
+    static TweenBinding emissive(Material* m) { return {TweenProperty::Emissive, reinterpret_cast<uintptr_t>(m)}; }
+
+    // Float components the property takes
+    static uint32_t components(TweenProperty property) {
+        switch (property) {
+            case TweenProperty::Float: return 1;
+            case TweenProperty::Vec2: return 2;
+            case TweenProperty::Vec4:
+            case TweenProperty::BaseColor: return 4;
+            default: return 3;
+        }
+    }
+};
+
+struct TweenHandle {
+    uint32_t index = 0xFFFFFFFF;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != 0xFFFFFFFF; }
+    explicit operator bool() const { return valid(); }
+};
+
+struct TweenOptions {
+    float delay = 0.0f;                 // Seconds before it starts (and first writes)
+    int loops = 0;                      // Extra plays; -1 repeats until killed
+    bool yoyo = false;                  // Loops play back and forth
+    std::function<void()> onComplete;   // After the last play, not when killed
+};
+
+class TweenSystem {
+public:
+    explicit TweenSystem(ECS* ecs = nullptr) : ecs(ecs) {}
+
+    // Tween a binding from one value to another. The value type must match
+    // the binding (vec3 for positions, vec4 for base colors, ...); a
+    // mismatch is reported and returns an invalid handle.
+    TweenHandle add(const TweenBinding& target, float from, float to, float duration,
+                    Ease ease = Ease::Linear, TweenOptions options = {}) {
+        return add(target, 1, glm::vec4(from, 0.0f, 0.0f, 0.0f), glm::vec4(to, 0.0f, 0.0f, 0.0f), duration, ease, std::move(options));
+    }
+
+    TweenHandle add(const TweenBinding& target, const glm::vec2& from, const glm::vec2& to, float duration,
+                    Ease ease = Ease::Linear, TweenOptions options = {}) {
+        return add(target, 2, glm::vec4(from.x, from.y, 0.0f, 0.0f), glm::vec4(to.x, to.y, 0.0f, 0.0f), duration, ease, std::move(options));
+    }
+
+    TweenHandle add(const TweenBinding& target, const glm::vec3& from, const glm::vec3& to, float duration,
+                    Ease ease = Ease::Linear, TweenOptions options = {}) {
+        return add(target, 3, glm::vec4(from, 0.0f), glm::vec4(to, 0.0f), duration, ease, std::move(options));
+    }
+
+    TweenHandle add(const TweenBinding& target, const glm::vec4& from, const glm::vec4& to, float duration,
+                    Ease ease = Ease::Linear, TweenOptions options = {}) {
+        return add(target, 4, from, to, duration, ease, std::move(options));
+    }
+
+    // Advance every tween and write the results. onComplete callbacks run
+    // after all tracks are written, so they can start or kill tweens.
+    void update(float dt) {
+        if (updating) return;
+        updating = true;
+
+        for (auto& track : tracks) {
+            if (track && !track->ids.empty()) updateTrack(*track, dt);
+        }
+
+        std::vector<std::function<void()>> callbacks;
+        callbacks.swap(completed);
+        updating = false;
+        for (auto& callback : callbacks) callback();
+    }
+
+    bool isActive(TweenHandle handle) const {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+               slots[handle.index].track != NO_TRACK;
+    }
+
+    // Stop a tween where it is; with complete, jump to its end value (the
+    // last play's end when looping) and run onComplete
+    bool kill(TweenHandle handle, bool complete = false) {
+        if (!isActive(handle)) return false;
+        Slot& slot = slots[handle.index];
+        Track& track = *tracks[slot.track];
+        uint32_t lane = slot.lane;
+
+        std::function<void()> onComplete;
+        if (complete) {
+            bool reversed = track.yoyo[lane] && track.loopsLeft[lane] > 0 && (track.loopsLeft[lane] % 2) == 1;
+            float end = reversed ? 0.0f : 1.0f;
+            writeLane(track, lane, end);
+            onComplete = std::move(slot.onComplete);
+        }
+        removeLane(track, lane);
+        release(handle.index);
+        if (onComplete) onComplete();
+        return true;
+    }
+
+    // Stop every tween writing to target (before freeing a material or a
+    // UI element a tween points at)
+    size_t kill(const TweenBinding& target) {
+        size_t killed = 0;
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            Slot& slot = slots[i];
+            if (slot.track == NO_TRACK) continue;
+            Track& track = *tracks[slot.track];
+            if (track.property == target.property && track.targets[slot.lane] == target.target) {
+                killed += kill(TweenHandle{i, slot.generation}) ? 1 : 0;
+            }
+        }
+        return killed;
+    }
+
+    // Slots are released rather than dropped, so handles from before the
+    // clear stay dead instead of matching the tweens that reuse them
+    void clear() {
+        for (auto& track : tracks) track.reset();
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            if (slots[i].track != NO_TRACK) release(i);
+        }
+        completed.clear();
+    }
+
+    size_t getActiveCount() const { return activeCount; }
+
+    void setECS(ECS* e) { ecs = e; }
+
+    // In place over a batch of t in [0, 1]
+    static void applyEase(Ease ease, float* t, size_t count) {
+        switch (ease) {
+            case Ease::Linear: return;
+            case Ease::InQuad: return map(t, count, [](float x) { return Easing::easeInQuad(x); });
+            case Ease::OutQuad: return map(t, count, [](float x) { return Easing::easeOutQuad(x); });
+            case Ease::InOutQuad: return map(t, count, [](float x) { return Easing::easeInOutQuad(x); });
+            case Ease::InCubic: return map(t, count, [](float x) { return Easing::easeInCubic(x); });
+            case Ease::OutCubic: return map(t, count, [](float x) { return Easing::easeOutCubic(x); });
+            case Ease::InOutCubic: return map(t, count, [](float x) { return Easing::easeInOutCubic(x); });
+            case Ease::InSin: return map(t, count, [](float x) { return Easing::easeInSin(x); });
+            case Ease::OutSin: return map(t, count, [](float x) { return Easing::easeOutSin(x); });
+            case Ease::InOutSin: return map(t, count, [](float x) { return Easing::easeInOutSin(x); });
+            case Ease::InElastic: return map(t, count, [](float x) { return Easing::easeInElastic(x); });
+            case Ease::OutBounce: return map(t, count, [](float x) { return Easing::easeOutBounce(x); });
+            default: return;
+        }
+    }
+
+private:
+    static constexpr uint16_t NO_TRACK = 0xFFFF;
+    static constexpr size_t TRACK_COUNT = size_t(Ease::Count) * size_t(TweenProperty::Count);
+
+    // One easing curve writing one kind of property; lane i of every
+    // array is the same tween
+    struct Track {
+        Ease ease = Ease::Linear;
+        TweenProperty property = TweenProperty::Float;
+        uint32_t components = 1;
+
+        std::vector<float> elapsed;             // Negative while delayed
+        std::vector<float> duration;
+        std::vector<float> invDuration;
+        std::array<std::vector<float>, 4> from;
+        std::array<std::vector<float>, 4> delta;
+        std::vector<uintptr_t> targets;
+        std::vector<int32_t> loopsLeft;
+        std::vector<uint8_t> yoyo;
+        std::vector<uint32_t> ids;              // Slot of each lane
+
+        // Per update
+        std::vector<float> t;
+        std::array<std::vector<float>, 4> out;
+        std::vector<uint8_t> lost;              // Target gone (entity destroyed); Transform tracks
+    };
+
+    struct Slot {
+        uint32_t generation = 0;
+        uint16_t track = NO_TRACK;
+        uint32_t lane = 0;
+        std::function<void()> onComplete;
+    };
+
+    ECS* ecs;
+    std::array<std::unique_ptr<Track>, TRACK_COUNT> tracks;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<std::function<void()>> completed;
+    std::vector<uint32_t> finished;
+    size_t activeCount = 0;
+    bool updating = false;
+
+    template<typename F>
+    static void map(float* t, size_t count, F f) {
+        for (size_t i = 0; i < count; i++) t[i] = f(t[i]);
+    }
+
+    TweenHandle add(const TweenBinding& target, uint32_t components, const glm::vec4& from, const glm::vec4& to,
+                    float duration, Ease ease, TweenOptions options) {
+        bool onEntity = target.property == TweenProperty::Position || target.property == TweenProperty::Scale;
+        if (TweenBinding::components(target.property) != components || ease >= Ease::Count || (!onEntity && !target.target)) {
+            std::cerr << "✗ Tween value doesn't match its binding" << std::endl;
+            return {};
+        }
+        if (onEntity && !ecs) {
+            std::cerr << "✗ Transform tween needs an ECS" << std::endl;
+            return {};
+        }
+
+        size_t key = size_t(ease) * size_t(TweenProperty::Count) + size_t(target.property);
+        if (!tracks[key]) {
+            tracks[key] = std::make_unique<Track>();
+            tracks[key]->ease = ease;
+            tracks[key]->property = target.property;
+            tracks[key]->components = components;
+        }
+        Track& track = *tracks[key];
+
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        Slot& slot = slots[index];
+        slot.track = static_cast<uint16_t>(key);
+        slot.lane = static_cast<uint32_t>(track.ids.size());
+        slot.onComplete = std::move(options.onComplete);
+
+        duration = std::max(duration, 1e-6f);
+        track.elapsed.push_back(-std::max(options.delay, 0.0f));
+        track.duration.push_back(duration);
+        track.invDuration.push_back(1.0f / duration);
+        for (uint32_t c = 0; c < components; c++) {
+            track.from[c].push_back(from[c]);
+            track.delta[c].push_back(to[c] - from[c]);
+        }
+        track.targets.push_back(target.target);
+        track.loopsLeft.push_back(options.loops);
+        track.yoyo.push_back(options.yoyo ? 1 : 0);
+        track.ids.push_back(index);
+        activeCount++;
+        return {index, slot.generation};
+    }
+
+    void updateTrack(Track& track, float dt) {
+        size_t count = track.ids.size();
+        track.t.resize(count);
+        for (uint32_t c = 0; c < track.components; c++) track.out[c].resize(count);
+
+        // Time, then curve, then blend: each a straight loop over floats.
+        // The time pass also counts lanes that ended a play or are still
+        // delayed, so the passes after it can skip per-lane checks.
+        float* elapsed = track.elapsed.data();
+        const float* inv = track.invDuration.data();
+        float* t = track.t.data();
+        uint32_t ended = 0, delayed = 0;
+        for (size_t i = 0; i < count; i++) {
+            elapsed[i] += dt;
+            float raw = elapsed[i] * inv[i];
+            ended += raw >= 1.0f ? 1 : 0;
+            delayed += raw < 0.0f ? 1 : 0;
+            t[i] = std::min(std::max(raw, 0.0f), 1.0f);
+        }
+        applyEase(track.ease, t, count);
+        for (uint32_t c = 0; c < track.components; c++) {
+            const float* from = track.from[c].data();
+            const float* delta = track.delta[c].data();
+            float* out = track.out[c].data();
+            for (size_t i = 0; i < count; i++) out[i] = from[i] + delta[i] * t[i];
+        }
+
+        bool lostAny = write(track, 0, count, delayed != 0);
+        if (!ended && !lostAny) return;
+
+        // Ends of plays: loop, or finish and remove (back to front, as
+        // removal moves the last lane into the hole)
+        finished.clear();
+        for (size_t i = 0; i < count; i++) {
+            if (lostAny && track.lost[i]) {
+                finished.push_back(uint32_t(i));
+                continue;
+            }
+            if (elapsed[i] < track.duration[i]) continue;
+            int32_t& loops = track.loopsLeft[i];
+            if (loops != 0) {
+                elapsed[i] = std::min(elapsed[i] - track.duration[i], track.duration[i]);
+                if (loops > 0) loops--;
+                if (track.yoyo[i]) {
+                    for (uint32_t c = 0; c < track.components; c++) {
+                        track.from[c][i] += track.delta[c][i];
+                        track.delta[c][i] = -track.delta[c][i];
+                    }
+                }
+                continue;
+            }
+            finished.push_back(uint32_t(i));
+        }
+        for (auto it = finished.rbegin(); it != finished.rend(); ++it) {
+            uint32_t index = track.ids[*it];
+            bool lost = lostAny && track.lost[*it];
+            if (!lost && slots[index].onComplete) completed.push_back(std::move(slots[index].onComplete));
+            removeLane(track, *it);
+            release(index);
+        }
+    }
+
+    // fn(lane) for [begin, end), leaving out delayed lanes when there are any
+    template<typename Fn>
+    static void eachLane(const Track& track, size_t begin, size_t end, bool delayed, Fn fn) {
+        if (!delayed) {
+            for (size_t i = begin; i < end; i++) fn(i);
+            return;
+        }
+        const float* elapsed = track.elapsed.data();
+        for (size_t i = begin; i < end; i++) {
+            if (elapsed[i] >= 0.0f) fn(i);
+        }
+    }
+
+    // Results in track.out for lanes [begin, end). True if some lane's
+    // target is gone (flagged in track.lost).
+    bool write(Track& track, size_t begin, size_t end, bool delayed) {
+        const uintptr_t* targets = track.targets.data();
+        const float* x = track.out[0].data();
+        const float* y = track.components > 1 ? track.out[1].data() : nullptr;
+        const float* z = track.components > 2 ? track.out[2].data() : nullptr;
+        const float* w = track.components > 3 ? track.out[3].data() : nullptr;
+
+        switch (track.property) {
+            case TweenProperty::Float:
+                eachLane(track, begin, end, delayed, [&](size_t i) {
+                    *reinterpret_cast<float*>(targets[i]) = x[i];
+                });
+                return false;
+            case TweenProperty::Vec2:
+                eachLane(track, begin, end, delayed, [&](size_t i) {
+                    *reinterpret_cast<glm::vec2*>(targets[i]) = glm::vec2(x[i], y[i]);
+                });
+                return false;
+            case TweenProperty::Vec3:
+                eachLane(track, begin, end, delayed, [&](size_t i) {
+                    *reinterpret_cast<glm::vec3*>(targets[i]) = glm::vec3(x[i], y[i], z[i]);
+                });
+                return false;
+            case TweenProperty::Vec4:
+                eachLane(track, begin, end, delayed, [&](size_t i) {
+                    *reinterpret_cast<glm::vec4*>(targets[i]) = glm::vec4(x[i], y[i], z[i], w[i]);
+                });
+                return false;
+            case TweenProperty::Position:
+            case TweenProperty::Scale: {
+                bool position = track.property == TweenProperty::Position;
+                bool lostAny = false;
+                track.lost.assign(track.ids.size(), 0);
+                eachLane(track, begin, end, delayed, [&](size_t i) {
+                    Transform* transform = ecs ? ecs->getComponent<Transform>(EntityID(targets[i])) : nullptr;
+                    if (!transform) {
+                        track.lost[i] = 1;
+                        lostAny = true;
+                        return;
+                    }
+                    (position ? transform->position : transform->scale) = glm::vec3(x[i], y[i], z[i]);
+                });
+                return lostAny;
+            }
+            case TweenProperty::BaseColor:
+                eachLane(track, begin, end, delayed, [&](size_t i) {
+                    reinterpret_cast<Material*>(targets[i])->properties.baseColor = glm::vec4(x[i], y[i], z[i], w[i]);
+                });
+                return false;
+            case TweenProperty::Emissive:
+                eachLane(track, begin, end, delayed, [&](size_t i) {
+                    reinterpret_cast<Material*>(targets[i])->properties.emissive = glm::vec3(x[i], y[i], z[i]);
+                });
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    // One lane at eased position value (kill with complete), delay or not
+    void writeLane(Track& track, uint32_t lane, float value) {
+        for (uint32_t c = 0; c < track.components; c++) {
+            if (track.out[c].size() < track.ids.size()) track.out[c].resize(track.ids.size());
+            track.out[c][lane] = track.from[c][lane] + track.delta[c][lane] * value;
+        }
+        write(track, lane, lane + 1, false);
+    }
+
+    void removeLane(Track& track, uint32_t lane) {
+        uint32_t last = static_cast<uint32_t>(track.ids.size() - 1);
+        auto erase = [&](auto& values) {
+            values[lane] = values[last];
+            values.pop_back();
+        };
+        erase(track.elapsed);
+        erase(track.duration);
+        erase(track.invDuration);
+        for (uint32_t c = 0; c < track.components; c++) {
+            erase(track.from[c]);
+            erase(track.delta[c]);
+        }
+        erase(track.targets);
+        erase(track.loopsLeft);
+        erase(track.yoyo);
+        erase(track.ids);
+        if (lane != last) slots[track.ids[lane]].lane = lane;
+    }
+
+    void release(uint32_t index) {
+        Slot& slot = slots[index];
+        slot.track = NO_TRACK;
+        slot.generation++;
+        slot.onComplete = nullptr;
+        freeSlots.push_back(index);
+        activeCount--;
+    }
+};
@@ -0,0 +1,397 @@
+#pragma once
+#include "ScenePackage.h"
+#include "AsyncIO.h"
+#include <shared_mutex>
+#include <string_view>
+#include <iostream>
+
+// Virtual file system
+//
+// Loaders ask for files by virtual path ("models/tree.glb") and the VFS
+// answers from its mounts: directories on disk, and scene packages or
+// bundles whose resources carry a virtual path. Mounting a directory walks
+// it once and mounting a package reads its resource table, so lookups
+// afterwards are one probe into a single table keyed by hashed path, not
+// a stat() or open() per candidate location. On network filesystems those
+// round trips are most of a cold start.
+//
+// When several mounts provide the same path, the highest priority wins
+// (the later mount on a tie), so a patch package mounted above the loose
+// files overrides them. Paths no mount knows about are read from the real
+// filesystem as given, so absolute paths into a mounted directory resolve
+// through the table and ad-hoc paths keep working.
+namespace VFS {
+
+using PathID = uint64_t;
+using MountID = uint32_t;
+constexpr MountID INVALID_MOUNT = 0;
+
+// FNV-1a of a normalized path; constexpr so fixed paths hash at compile time
+constexpr PathID pathId(std::string_view normalized) {
+    PathID hash = 14695981039346656037ull;
+    for (char c : normalized) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Lexical cleanup: '\' becomes '/', "." and empty segments go, ".." folds
+// into its parent. A leading '/' (absolute path) is kept.
+inline std::string normalize(std::string_view path) {
+    std::vector<std::string_view> parts;
+    size_t begin = 0;
+    std::string slashed(path);
+    std::replace(slashed.begin(), slashed.end(), '\\', '/');
+    std::string_view view(slashed);
+    while (begin <= view.size()) {
+        size_t end = view.find('/', begin);
+        if (end == std::string_view::npos) end = view.size();
+        std::string_view part = view.substr(begin, end - begin);
+        if (part == "..") {
+            if (!parts.empty() && parts.back() != "..") parts.pop_back();
+            else if (view.empty() || view[0] != '/') parts.push_back(part);
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        begin = end + 1;
+    }
+
+    std::string out = !view.empty() && view[0] == '/' ? "/" : "";
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (i > 0) out += '/';
+        out += parts[i];
+    }
+    return out;
+}
+
+struct FileInfo {
+    uint64_t size = 0;
+    MountID mount = INVALID_MOUNT;
+    bool packed = false;        // A package resource rather than a loose file
+};
+
+class FileSystem {
+public:
+    static FileSystem& get() {
+        static FileSystem fileSystem;
+        return fileSystem;
+    }
+
+    FileSystem(const FileSystem&) = delete;
+    FileSystem& operator=(const FileSystem&) = delete;
+
+    // Index every file under directory as mountPoint/<relative path>.
+    // Hidden (dot) directories are skipped.
+    MountID mountDirectory(const std::string& directory, const std::string& mountPoint = "", int priority = 0) {
+        std::error_code ec;
+        std::filesystem::path root = std::filesystem::absolute(directory, ec);
+        if (ec || !std::filesystem::is_directory(root, ec)) {
+            std::cerr << "✗ VFS: not a directory: " << directory << std::endl;
+            return INVALID_MOUNT;
+        }
+
+        auto mount = std::make_unique<Mount>();
+        mount->root = normalize(root.string());
+        mount->mountPoint = normalize(mountPoint);
+        mount->priority = priority;
+        scanDirectory(*mount);
+        return addMount(std::move(mount));
+    }
+
+    // Serve the package's resources by their virtual paths. Scene-internal
+    // resources (component columns, cooked bundle data) aren't files and
+    // stay hidden.
+    MountID mountPackage(const std::string& packagePath, const std::string& mountPoint = "", int priority = 0) {
+        auto mount = std::make_unique<Mount>();
+        mount->package = std::make_unique<ScenePackage::MappedPackageReader>();
+        if (!mount->package->open(packagePath)) {
+            std::cerr << "✗ VFS: failed to mount package: " << packagePath << std::endl;
+            return INVALID_MOUNT;
+        }
+        mount->root = normalize(packagePath);
+        mount->mountPoint = normalize(mountPoint);
+        mount->priority = priority;
+
+        const auto& entries = mount->package->getResourceEntries();
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].virtualPath.empty() || !isFileResource(entries[i].type)) continue;
+            mount->files.push_back({join(mount->mountPoint, normalize(entries[i].virtualPath)),
+                                    static_cast<int32_t>(i), entries[i].dataSize});
+        }
+        return addMount(std::move(mount));
+    }
+
+    bool unmount(MountID id) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto found = std::find_if(mounts.begin(), mounts.end(), [&](const auto& m) { return m->id == id; });
+        if (found == mounts.end()) return false;
+        mounts.erase(found);
+        rebuild();
+        return true;
+    }
+
+    void unmountAll() {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        mounts.clear();
+        table.clear();
+    }
+
+    // Walk a mounted directory again to pick up files added or removed since
+    bool rescan(MountID id) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        for (auto& mount : mounts) {
+            if (mount->id != id || mount->package) continue;
+            mount->files.clear();
+            scanDirectory(*mount);
+            rebuild();
+            return true;
+        }
+        return false;
+    }
+
+    // Mounted files answer from the table; anything else (including files
+    // created since their directory was mounted) is checked on disk
+    bool exists(const std::string& path) const {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            if (find(path)) return true;
+        }
+        std::error_code ec;
+        return std::filesystem::is_regular_file(path, ec);
+    }
+
+    bool stat(const std::string& path, FileInfo& info) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const Entry* entry = find(path);
+        if (!entry) return false;
+        info.mount = entry->mount->id;
+        info.packed = entry->resource >= 0;
+        info.size = entry->size;
+        if (!info.packed) {
+            std::error_code ec;
+            info.size = std::filesystem::file_size(entry->realPath, ec);
+        }
+        return true;
+    }
+
+    // Path on disk for a loose file; "" when it only exists in a package.
+    // Unmounted paths come back unchanged.
+    std::string resolve(const std::string& path) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const Entry* entry = find(path);
+        if (!entry) return path;
+        return entry->resource >= 0 ? std::string() : entry->realPath;
+    }
+
+    bool readFile(const std::string& path, AsyncIO::Buffer& out,
+                  AsyncIO::Priority priority = AsyncIO::Priority::High) const {
+        std::string realPath;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            const Entry* entry = find(path);
+            if (entry && entry->resource >= 0) return readPacked(*entry, out);
+            realPath = entry ? entry->realPath : path;
+        }
+        return AsyncIO::readFile(realPath, out, priority);
+    }
+
+    bool readFile(const std::string& path, std::vector<uint8_t>& out,
+                  AsyncIO::Priority priority = AsyncIO::Priority::High) const {
+        AsyncIO::Buffer buffer;
+        if (!readFile(path, buffer, priority)) return false;
+        out = buffer.toVector();
+        return true;
+    }
+
+    bool readText(const std::string& path, std::string& out,
+                  AsyncIO::Priority priority = AsyncIO::Priority::High) const {
+        AsyncIO::Buffer buffer;
+        if (!readFile(path, buffer, priority)) return false;
+        out.assign(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        return true;
+    }
+
+    // Start reading several files at once. Packed files are copied out
+    // before this returns; loose ones go to AsyncIO as one batch.
+    std::vector<AsyncIO::Ticket> readBatch(const std::vector<std::string>& paths,
+                                           AsyncIO::Priority priority = AsyncIO::Priority::Normal) const {
+        std::vector<AsyncIO::Ticket> tickets(paths.size());
+        std::vector<AsyncIO::ReadRequest> requests;
+        std::vector<size_t> slots;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            for (size_t i = 0; i < paths.size(); i++) {
+                const Entry* entry = find(paths[i]);
+                if (entry && entry->resource >= 0) {
+                    AsyncIO::ReadResult result;
+                    result.status = readPacked(*entry, result.buffer) ? AsyncIO::Status::Done : AsyncIO::Status::Failed;
+                    tickets[i] = AsyncIO::Ticket::completed(std::move(result));
+                    continue;
+                }
+                AsyncIO::ReadRequest request;
+                request.path = entry ? entry->realPath : paths[i];
+                request.priority = priority;
+                requests.push_back(std::move(request));
+                slots.push_back(i);
+            }
+        }
+        std::vector<AsyncIO::Ticket> issued = AsyncIO::Service::get().submitBatch(requests);
+        for (size_t i = 0; i < slots.size(); i++) tickets[slots[i]] = std::move(issued[i]);
+        return tickets;
+    }
+
+    size_t fileCount() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return table.size();
+    }
+
+private:
+    struct File {
+        std::string path;           // Virtual
+        int32_t resource = -1;      // Package resource index; -1 for loose files
+        uint64_t size = 0;          // Packed files only
+    };
+
+    struct Mount {
+        MountID id = INVALID_MOUNT;
+        int priority = 0;
+        std::string root;           // Directory or package file, normalized absolute
+        std::string mountPoint;
+        std::unique_ptr<ScenePackage::MappedPackageReader> package;
+        std::vector<File> files;
+    };
+
+    // The open table: one winning entry per virtual path
+    struct Entry {
+        std::string path;
+        const Mount* mount = nullptr;
+        int32_t resource = -1;
+        uint64_t size = 0;
+        std::string realPath;       // Loose files
+    };
+
+    mutable std::shared_mutex mutex;
+    std::vector<std::unique_ptr<Mount>> mounts;     // In mount order
+    std::unordered_map<PathID, Entry> table;
+    MountID nextMount = 1;
+
+    FileSystem() = default;
+
+    static bool isFileResource(ScenePackage::ResourceType type) {
+        using ScenePackage::ResourceType;
+        return type <= ResourceType::NavMesh || type == ResourceType::Custom;
+    }
+
+    static std::string join(const std::string& mountPoint, const std::string& relative) {
+        return mountPoint.empty() ? relative : mountPoint + "/" + relative;
+    }
+
+    // One directory walk instead of a stat per lookup later
+    static void scanDirectory(Mount& mount) {
+        std::error_code ec;
+        auto options = std::filesystem::directory_options::skip_permission_denied;
+        std::filesystem::recursive_directory_iterator it(mount.root, options, ec), end;
+        for (; !ec && it != end; it.increment(ec)) {
+            const auto& entry = *it;
+            std::string name = entry.path().filename().string();
+            if (!name.empty() && name[0] == '.') {
+                if (entry.is_directory(ec)) it.disable_recursion_pending();
+                continue;
+            }
+            if (!entry.is_regular_file(ec)) continue;
+            std::string full = normalize(entry.path().string());
+            mount.files.push_back({join(mount.mountPoint, full.substr(mount.root.size() + 1)), -1, 0});
+        }
+    }
+
+    MountID addMount(std::unique_ptr<Mount> mount) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        mount->id = nextMount++;
+        MountID id = mount->id;
+        size_t files = mount->files.size();
+        std::string root = mount->root;
+        mounts.push_back(std::move(mount));
+        rebuild();
+        std::cout << "✓ VFS mounted " << root << " (" << files << " files)" << std::endl;
+        return id;
+    }
+
+    // Lowest priority first so higher ones overwrite; mount order breaks ties
+    void rebuild() {
+        std::vector<const Mount*> ordered;
+        size_t total = 0;
+        for (const auto& mount : mounts) {
+            ordered.push_back(mount.get());
+            total += mount->files.size();
+        }
+        std::stable_sort(ordered.begin(), ordered.end(),
+                         [](const Mount* a, const Mount* b) { return a->priority < b->priority; });
+
+        table.clear();
+        table.reserve(total);
+        for (const Mount* mount : ordered) {
+            for (const File& file : mount->files) {
+                Entry& entry = table[pathId(file.path)];
+                if (!entry.path.empty() && entry.path != file.path) {
+                    std::cerr << "✗ VFS: path hash collision: " << entry.path << " / " << file.path << std::endl;
+                    continue;
+                }
+                entry.path = file.path;
+                entry.mount = mount;
+                entry.resource = file.resource;
+                entry.size = file.size;
+                entry.realPath = file.resource >= 0 ? std::string()
+                               : mount->root + "/" + file.path.substr(mount->mountPoint.empty() ? 0 : mount->mountPoint.size() + 1);
+            }
+        }
+    }
+
+    // Virtual path, or an absolute path inside a mounted directory
+    const Entry* find(const std::string& path) const {
+        std::string normalized = normalize(path);
+        if (const Entry* entry = probe(normalized)) return entry;
+        if (normalized.empty() || normalized[0] != '/') return nullptr;
+        for (const auto& mount : mounts) {
+            if (mount->package || !within(normalized, mount->root)) continue;
+            if (const Entry* entry = probe(join(mount->mountPoint, normalized.substr(mount->root.size() + 1)))) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    const Entry* probe(const std::string& normalized) const {
+        auto found = table.find(pathId(normalized));
+        return found != table.end() && found->second.path == normalized ? &found->second : nullptr;
+    }
+
+    static bool within(const std::string& path, const std::string& directory) {
+        return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 &&
+               path[directory.size()] == '/';
+    }
+
+    // Caller holds the lock (keeps the package mapped)
+    static bool readPacked(const Entry& entry, AsyncIO::Buffer& out) {
+        out = AsyncIO::Buffer::allocate(static_cast<size_t>(entry.size));
+        if (entry.size > 0 && out.empty()) return false;
+        return entry.mount->package->readInto(entry.resource, out.data(), out.size());
+    }
+};
+
+inline bool readFile(const std::string& path, AsyncIO::Buffer& out,
+                     AsyncIO::Priority priority = AsyncIO::Priority::High) {
+    return FileSystem::get().readFile(path, out, priority);
+}
+
+inline bool readFile(const std::string& path, std::vector<uint8_t>& out,
+                     AsyncIO::Priority priority = AsyncIO::Priority::High) {
+    return FileSystem::get().readFile(path, out, priority);
+}
+
+inline bool readText(const std::string& path, std::string& out,
+                     AsyncIO::Priority priority = AsyncIO::Priority::High) {
+    return FileSystem::get().readText(path, out, priority);
+}
+
+} // namespace VFS
@@ -0,0 +1,261 @@
+#pragma once
+#include "SceneLoadPipeline.h"
+#include <future>
+
+// Background world construction for scene transitions
+//
+// WorldBuilder loads a scene package into a fresh ECS on a worker thread
+// and imports its models there too, while the current world keeps
+// running. The caller's update() uploads finished models a few instances
+// per frame; once everything is resident, take() hands over the complete
+// world to be swapped in at a frame boundary. The outgoing world goes to
+// RetiredWorlds, which frees it over the following frames.
+
+struct WorldBuildOptions {
+    size_t uploadsPerFrame = 16;    // Model instances uploaded per update()
+    size_t maxQueuedImports = 8;    // Imported models waiting for upload
+    ScenePackage::VerifyPolicy verify = ScenePackage::VerifyPolicy::Always;
+};
+
+class WorldBuilder {
+public:
+    using SetupFn = std::function<void(ECS*)>;
+    using ModelReadyFn = std::function<void(EntityID, Model*)>;
+
+    WorldBuilder() = default;
+    WorldBuilder(const WorldBuilder&) = delete;
+    WorldBuilder& operator=(const WorldBuilder&) = delete;
+    ~WorldBuilder() { cancel(); }
+
+    // Start building path into a new ECS. setup registers components and
+    // runs on the worker before the scene is read. False while a build runs.
+    bool start(const std::string& path, ModelLoader& loader, const SetupFn& setup,
+               const WorldBuildOptions& options = {}) {
+        if (building) return false;
+        cancel();
+
+        this->loader = &loader;
+        this->options = options;
+        progress = SceneLoadProgress{};
+        pending.clear();
+        ready = std::make_unique<BoundedQueue<std::shared_ptr<ModelImport>>>(options.maxQueuedImports);
+        next = std::make_unique<ECS>();
+        ecsReady = false;
+        importsDone = false;
+        failed = false;
+        building = true;
+
+        worker = std::thread([this, path, setup] { build(path, setup); });
+        return true;
+    }
+
+    bool isBuilding() const { return building; }
+    bool hasFailed() const { return failed; }
+    const SceneLoadProgress& getProgress() const { return progress; }
+
+    // Once per frame on the render thread. Uploads up to uploadsPerFrame
+    // model instances; true once the world is complete and ready for take().
+    bool update(const ModelReadyFn& onModelReady = nullptr) {
+        if (!building || !ecsReady) return false;
+        if (failed) {
+            cancel();
+            return false;
+        }
+
+        if (!progress.entitiesReady) {
+            progress.entitiesReady = true;
+            progress.modelCount = modelCount;
+            progress.instanceCount = instanceCount;
+        }
+
+        // Drain finished imports into per-instance uploads. importsDone is
+        // read first: once set, everything the worker made is in the queue.
+        bool done = importsDone;
+        bool drained = false;
+        std::shared_ptr<ModelImport> imported;
+        while (pending.size() < options.uploadsPerFrame) {
+            if (!ready->tryPop(imported)) {
+                drained = true;
+                break;
+            }
+            progress.modelsImported++;
+            auto found = pathEntities.find(imported->path);
+            if (found == pathEntities.end()) continue;
+            if (!imported->valid()) {
+                std::cerr << "  ✗ Model load failed: " << imported->path << std::endl;
+                progress.instancesUploaded += found->second.size();
+                continue;
+            }
+            for (EntityID e : found->second) pending.push_back({imported, e});
+        }
+
+        size_t count = std::min(pending.size(), std::max<size_t>(options.uploadsPerFrame, 1));
+        if (count > 0) {
+            std::vector<const ModelImport*> sources;
+            std::vector<EntityID> targets;
+            for (size_t i = 0; i < count; i++) {
+                sources.push_back(pending[i].first.get());
+                targets.push_back(pending[i].second);
+            }
+            std::vector<Model> models = loader->upload(sources);
+            for (size_t i = 0; i < models.size(); i++) {
+                auto* mc = next->getComponent<ModelComponent>(targets[i]);
+                if (!mc || mc->loadedModel) {
+                    loader->cleanup(models[i]);
+                    continue;
+                }
+                mc->loadedModel = new Model(std::move(models[i]));
+                uploaded.push_back(targets[i]);
+                if (onModelReady) onModelReady(targets[i], mc->loadedModel);
+            }
+            pending.erase(pending.begin(), pending.begin() + count);
+            progress.instancesUploaded += count;
+        }
+
+        return done && drained && pending.empty();
+    }
+
+    // The finished world, and the entities that got a model. Only valid
+    // after update() returned true.
+    std::unique_ptr<ECS> take(std::vector<EntityID>& modelEntities) {
+        if (worker.joinable()) worker.join();
+        building = false;
+        modelEntities = std::move(uploaded);
+        uploaded.clear();
+        return std::move(next);
+    }
+
+    // Abandon the build and free whatever was uploaded so far
+    void cancel() {
+        if (ready) ready->close();
+        if (worker.joinable()) worker.join();
+        if (next && loader) {
+            for (EntityID e : uploaded) {
+                auto* mc = next->getComponent<ModelComponent>(e);
+                if (mc && mc->loadedModel) {
+                    loader->cleanup(*mc->loadedModel);
+                    delete mc->loadedModel;
+                    mc->loadedModel = nullptr;
+                }
+            }
+        }
+        uploaded.clear();
+        pending.clear();
+        next.reset();
+        building = false;
+    }
+
+private:
+    ModelLoader* loader = nullptr;
+    WorldBuildOptions options;
+    std::thread worker;
+    std::unique_ptr<ECS> next;
+    std::unique_ptr<BoundedQueue<std::shared_ptr<ModelImport>>> ready;
+
+    std::atomic<bool> building{false};
+    std::atomic<bool> ecsReady{false};      // Worker is done with next; pathEntities is set
+    std::atomic<bool> importsDone{false};
+    std::atomic<bool> failed{false};
+
+    // Written by the worker before ecsReady, read-only afterwards
+    std::unordered_map<std::string, std::vector<EntityID>> pathEntities;
+    size_t modelCount = 0;
+    size_t instanceCount = 0;
+
+    // Render thread only
+    SceneLoadProgress progress;
+    std::deque<std::pair<std::shared_ptr<ModelImport>, EntityID>> pending;
+    std::vector<EntityID> uploaded;
+
+    void build(const std::string& path, const SetupFn& setup) {
+        if (setup) setup(next.get());
+        pathEntities.clear();
+        instanceCount = 0;
+
+        if (!ScenePackaging::ScenePackager::loadScene(next.get(), path, options.verify)) {
+            failed = true;
+            ecsReady = true;
+            return;
+        }
+        next->each<ModelComponent>([&](EntityID e, ModelComponent& mc) {
+            if (mc.loadedModel || mc.modelPath.empty()) return;
+            pathEntities[mc.modelPath].push_back(e);
+            instanceCount++;
+        });
+        modelCount = pathEntities.size();
+        ecsReady = true;
+
+        // Bundled models come from the package itself
+        ScenePackage::MappedPackageReader reader;
+        AssetBundle bundle;
+        if (reader.open(path)) bundle.attach(reader);
+
+        for (const auto& entry : pathEntities) {
+            auto imported = std::make_shared<ModelImport>();
+            if (!bundle.importModel(entry.first, *imported)) loader->import(entry.first, *imported);
+            if (!ready->push(std::move(imported))) break; // Cancelled
+        }
+        importsDone = true;
+    }
+};
+
+// Worlds swapped out, freed over the following frames: models once the GPU
+// can no longer be using them, a few per frame, then the ECS itself on a
+// background thread.
+class RetiredWorlds {
+public:
+    ~RetiredWorlds() {
+        if (deleter.valid()) deleter.wait();
+    }
+
+    void retire(ECS* ecs, std::vector<Model*> models) {
+        worlds.push_back({ecs, std::move(models), frame});
+    }
+
+    bool empty() const { return worlds.empty(); }
+
+    // Once per frame on the render thread
+    void update(ModelLoader& loader, uint32_t framesBeforeFree = 3, size_t modelsPerFrame = 32) {
+        frame++;
+        while (!worlds.empty() && frame - worlds.front().retiredAt >= framesBeforeFree) {
+            Retired& oldest = worlds.front();
+            while (!oldest.models.empty() && modelsPerFrame > 0) {
+                Model* model = oldest.models.back();
+                oldest.models.pop_back();
+                loader.cleanup(*model);
+                delete model;
+                modelsPerFrame--;
+            }
+            if (!oldest.models.empty()) return;
+
+            // Freeing a large ECS is pure CPU work; keep it off the frame
+            if (deleter.valid()) deleter.wait();
+            ECS* ecs = oldest.ecs;
+            deleter = std::async(std::launch::async, [ecs] { delete ecs; });
+            worlds.pop_front();
+        }
+    }
+
+    // Free everything now (the GPU must be idle)
+    void flush(ModelLoader& loader) {
+        for (Retired& world : worlds) {
+            for (Model* model : world.models) {
+                loader.cleanup(*model);
+                delete model;
+            }
+            delete world.ecs;
+        }
+        worlds.clear();
+        if (deleter.valid()) deleter.wait();
+    }
+
+private:
+    struct Retired {
+        ECS* ecs;
+        std::vector<Model*> models;
+        uint64_t retiredAt;
+    };
+    std::deque<Retired> worlds;
+    std::future<void> deleter;
+    uint64_t frame = 0;
+};
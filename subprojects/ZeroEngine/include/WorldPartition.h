@@ -0,0 +1,587 @@
+#pragma once
+#include "SceneLoadPipeline.h"
+#include <cmath>
+#include <limits>
+#include <map>
+
+// World partition: scenes split into grid cells that stream in and out
+// around streaming sources (the camera, players).
+//
+// save() assigns every root entity to the XZ cell containing its position;
+// children go with their root so hierarchies never span cells, and entities
+// without a Transform (or with a camera) go to an always-loaded cell. Each
+// cell is an ordinary v2 entity table plus columns named "cell/<x>_<z>/...",
+// so it is read, checked and decompressed like any other resource, and a
+// WorldCellIndex resource lists the cells. Models can be bundled into the
+// same file (AssetBundle.h). The asset graph has a root per cell, named
+// like its columns without the slash ("cell/<x>_<z>", "cell/global"), so
+// an AssetPreloader can warm a cell's models before it is needed.
+//
+// At runtime update() loads cells within loadRadius of a source, nearest
+// first, and unloads them past loadRadius + unloadHysteresis so a source
+// pacing along a cell border doesn't thrash. Decoding and model import run
+// on worker threads; the caller's thread only inserts components and
+// uploads, a bounded number of cells per update. Resident cells are kept
+// under memoryBudget by evicting the farthest ones first.
+
+namespace ScenePackaging {
+
+struct WorldPartitionHeader {
+    uint32_t cellCount = 0;
+    float cellSize = 0.0f;
+};
+
+struct WorldCellRecord {
+    int32_t x = 0;
+    int32_t z = 0;
+    uint32_t entityCount = 0;
+    uint32_t firstResource = 0;     // The cell's entity table; its columns follow
+    uint32_t resourceCount = 0;
+    uint32_t flags = 0;
+    uint64_t dataBytes = 0;         // Uncompressed size of the cell's resources
+};
+
+constexpr uint32_t CELL_ALWAYS_LOADED = 1u << 0;
+
+} // namespace ScenePackaging
+
+struct WorldStreamingSettings {
+    float loadRadius = 256.0f;
+    float unloadHysteresis = 64.0f;         // Unload past loadRadius + this
+    size_t memoryBudget = 512ull << 20;     // Estimated bytes of resident cells
+    unsigned workerThreads = 2;
+    size_t maxLoadsInFlight = 4;
+    size_t maxCellsAppliedPerUpdate = 1;    // Bounds the per-frame ECS insert + upload
+    size_t uploadBatchSize = 32;
+    uint32_t framesBeforeFree = 3;          // Unloaded models outlive frames in flight
+    ScenePackage::VerifyPolicy verify = ScenePackage::VerifyPolicy::Once;
+};
+
+struct WorldStreamingStats {
+    size_t cellCount = 0;
+    size_t loadedCells = 0;
+    size_t loadingCells = 0;
+    size_t residentBytes = 0;
+    size_t loadedEntities = 0;
+};
+
+class WorldPartition {
+public:
+    using ModelReadyFn = std::function<void(EntityID, Model*)>;
+    using CellUnloadFn = std::function<void(const std::vector<EntityID>&)>;
+
+    WorldPartition() = default;
+    WorldPartition(const WorldPartition&) = delete;
+    WorldPartition& operator=(const WorldPartition&) = delete;
+    ~WorldPartition() { close(); }
+
+    // Write the scene as a partitioned world with square cells of cellSize.
+    // With bundleModels, every referenced model is cooked into the package.
+    static bool save(ECS* ecs, const std::string& filepath, const std::string& sceneName = "Untitled",
+                     float cellSize = 64.0f,
+                     ScenePackage::CompressionType compression = ScenePackage::CompressionType::LZ4,
+                     ModelLoader* bundleModels = nullptr) {
+        using namespace ScenePackaging;
+        if (cellSize <= 0.0f) return false;
+
+        // Root of each entity's hierarchy (parents that no longer exist end it)
+        auto rootOf = [&](EntityID e) {
+            for (int depth = 0; depth < 256; depth++) {
+                auto* t = ecs->getComponent<Transform>(e);
+                if (!t || t->parent == 0 || !ecs->getComponent<Transform>(t->parent)) break;
+                e = t->parent;
+            }
+            return e;
+        };
+
+        std::map<std::pair<int32_t, int32_t>, std::vector<EntityID>> grid;
+        std::vector<EntityID> global;
+        auto assign = [&](EntityID e) {
+            EntityID root = rootOf(e);
+            auto* t = ecs->getComponent<Transform>(root);
+            if (!t || ecs->getComponent<CameraComponent>(root)) {
+                global.push_back(e);
+                return;
+            }
+            int32_t x = static_cast<int32_t>(std::floor(t->position.x / cellSize));
+            int32_t z = static_cast<int32_t>(std::floor(t->position.z / cellSize));
+            grid[{x, z}].push_back(e);
+        };
+        ecs->each<Transform>([&](EntityID e, Transform&) { assign(e); });
+        ecs->each<Tag>([&](EntityID e, Tag&) {
+            if (!ecs->getComponent<Transform>(e)) global.push_back(e);
+        });
+
+        SceneSnapshot snapshot;
+        AssetGraph graph;
+        std::vector<WorldCellRecord> records;
+        uint32_t entityCount = 0;
+        auto addCell = [&](int32_t x, int32_t z, std::vector<EntityID>& ids, uint32_t flags) {
+            std::sort(ids.begin(), ids.end());
+            WorldCellRecord record;
+            record.x = x;
+            record.z = z;
+            record.entityCount = static_cast<uint32_t>(ids.size());
+            record.firstResource = static_cast<uint32_t>(snapshot.resources.size());
+            record.flags = flags;
+            std::string prefix = cellPrefix(x, z, flags);
+            ScenePackager::snapshotEntities(ecs, ids, true, prefix, snapshot.resources);
+            graph.addRoot(prefix.substr(0, prefix.size() - 1), ecs, ids);
+            record.resourceCount = static_cast<uint32_t>(snapshot.resources.size()) - record.firstResource;
+            for (uint32_t i = record.firstResource; i < snapshot.resources.size(); i++) {
+                record.dataBytes += snapshot.resources[i].data.size();
+            }
+            records.push_back(record);
+            entityCount += record.entityCount;
+        };
+
+        if (!global.empty()) addCell(0, 0, global, CELL_ALWAYS_LOADED);
+        for (auto& cell : grid) addCell(cell.first.first, cell.first.second, cell.second, 0);
+
+        WorldPartitionHeader header;
+        header.cellCount = static_cast<uint32_t>(records.size());
+        header.cellSize = cellSize;
+        std::vector<uint8_t> index(sizeof(header) + records.size() * sizeof(WorldCellRecord));
+        std::memcpy(index.data(), &header, sizeof(header));
+        if (!records.empty()) {
+            std::memcpy(index.data() + sizeof(header), records.data(), records.size() * sizeof(WorldCellRecord));
+        }
+        snapshot.resources.push_back({"world/cells", "scene/world/cells.bin",
+                                      ScenePackage::ResourceType::WorldCellIndex, std::move(index)});
+        ScenePackager::storeAssetGraph(snapshot, graph);
+
+        if (bundleModels) {
+            AssetBundleWriter bundle(snapshot);
+            bundle.addSceneModels(ecs, *bundleModels);
+            bundle.finish();
+        }
+
+        snapshot.metadata.entityCount = entityCount;
+        snapshot.metadata.componentTypeCount = 0;
+        strncpy(snapshot.metadata.sceneName, sceneName.c_str(), sizeof(snapshot.metadata.sceneName) - 1);
+        strncpy(snapshot.metadata.sceneVersion, "3.0.0", sizeof(snapshot.metadata.sceneVersion) - 1);
+
+        if (!ScenePackager::writeSnapshot(std::move(snapshot), filepath, compression)) return false;
+        std::cout << "  World cells: " << records.size() << " (" << cellSize << " units)" << std::endl;
+        return true;
+    }
+
+    // Map a partitioned world and load its always-loaded cells. The rest
+    // stream in from update() once a source is set.
+    bool open(const std::string& filepath, ECS* ecs, ModelLoader& loader,
+              const WorldStreamingSettings& settings = {}) {
+        close();
+        this->ecs = ecs;
+        this->loader = &loader;
+        this->settings = settings;
+
+        reader.setVerifyPolicy(settings.verify);
+        if (!reader.open(filepath)) {
+            std::cerr << "✗ Failed to open world: " << filepath << std::endl;
+            this->ecs = nullptr;
+            return false;
+        }
+        if (!readIndex()) {
+            std::cerr << "✗ Not a partitioned world (no valid cell index): " << filepath << std::endl;
+            reader.close();
+            this->ecs = nullptr;
+            return false;
+        }
+
+        bundle.attach(reader);
+
+        unsigned threads = std::max(1u, settings.workerThreads);
+        requests = std::make_unique<BoundedQueue<int>>(SIZE_MAX);
+        finished = std::make_unique<BoundedQueue<std::unique_ptr<CellData>>>(SIZE_MAX);
+        for (unsigned i = 0; i < threads; i++) workers.emplace_back([this] { run(); });
+
+        // Always-loaded cells are in before open() returns
+        size_t pending = 0;
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (cells[i].record.flags & CELL_ALWAYS_LOADED) {
+                request(i);
+                pending++;
+            }
+        }
+        while (pending > 0) {
+            std::unique_ptr<CellData> data;
+            if (!finished->pop(data)) break;
+            apply(std::move(data));
+            pending--;
+        }
+
+        std::cout << "✓ Opened world: " << filepath << " (" << cells.size() << " cells, "
+                  << cellSize << " units)" << std::endl;
+        return true;
+    }
+
+    // Unload everything and stop the workers. Models are freed immediately,
+    // so wait for the GPU to go idle first.
+    void close() {
+        if (requests) requests->close();
+        if (finished) finished->close();
+        for (auto& worker : workers) worker.join();
+        workers.clear();
+        requests.reset();
+        finished.reset();
+
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (cells[i].state == CellState::Loaded) unload(i);
+        }
+        freeRetired(true);
+        cells.clear();
+        sources.clear();
+        bundle.detach();
+        reader.close();
+        ecs = nullptr;
+    }
+
+    bool isOpen() const { return ecs != nullptr; }
+
+    // Streaming sources by caller-chosen id; cells load around any of them
+    void setSource(uint32_t id, const glm::vec3& position) { sources[id] = position; }
+    void removeSource(uint32_t id) { sources.erase(id); }
+
+    void setCallbacks(const ModelReadyFn& onModelReady, const CellUnloadFn& onCellUnloading) {
+        this->onModelReady = onModelReady;
+        this->onCellUnloading = onCellUnloading;
+    }
+
+    // Once per frame on the thread that owns the ECS
+    void update() {
+        if (!isOpen()) return;
+        updateCount++;
+        freeRetired(false);
+
+        // Finished loads first, so their sizes count against the budget below
+        std::unique_ptr<CellData> data;
+        for (size_t applied = 0; applied < settings.maxCellsAppliedPerUpdate && finished->tryPop(data); applied++) {
+            apply(std::move(data));
+        }
+
+        float keepRadius = settings.loadRadius + settings.unloadHysteresis;
+        std::vector<std::pair<float, size_t>> wanted;
+        for (size_t i = 0; i < cells.size(); i++) {
+            Cell& cell = cells[i];
+            if (cell.record.flags & CELL_ALWAYS_LOADED) continue;
+            cell.distance = distanceTo(cell);
+
+            if (cell.distance > keepRadius) {
+                if (cell.state == CellState::Loaded) unload(i);
+                if (cell.state == CellState::Loading) cell.cancelled = true;
+            } else if (cell.distance <= settings.loadRadius) {
+                if (cell.state == CellState::Loading) cell.cancelled = false;
+                if (cell.state == CellState::Unloaded && !cell.failed) wanted.push_back({cell.distance, i});
+            }
+        }
+        std::sort(wanted.begin(), wanted.end());
+
+        // A first load can cost more than estimated; trim back from the far end
+        makeRoom(0, -1.0f);
+
+        for (const auto& candidate : wanted) {
+            if (loadsInFlight >= settings.maxLoadsInFlight) break;
+            size_t need = estimate(cells[candidate.second]);
+            // A farther, smaller cell may still fit
+            if (!makeRoom(need, candidate.first)) continue;
+            request(candidate.second);
+        }
+    }
+
+    WorldStreamingStats getStats() const {
+        WorldStreamingStats stats;
+        stats.cellCount = cells.size();
+        for (const Cell& cell : cells) {
+            if (cell.state == CellState::Loaded) {
+                stats.loadedCells++;
+                stats.loadedEntities += cell.entities.size();
+            }
+            if (cell.state == CellState::Loading) stats.loadingCells++;
+        }
+        stats.residentBytes = residentBytes;
+        return stats;
+    }
+
+private:
+    using WorldCellRecord = ScenePackaging::WorldCellRecord;
+    static constexpr uint32_t CELL_ALWAYS_LOADED = ScenePackaging::CELL_ALWAYS_LOADED;
+
+    enum class CellState { Unloaded, Loading, Loaded };
+
+    struct Cell {
+        WorldCellRecord record;
+        CellState state = CellState::Unloaded;
+        bool cancelled = false;         // Left the keep radius while loading
+        bool failed = false;            // Corrupt; not retried
+        float distance = 0.0f;
+        size_t bytes = 0;               // Measured at the last load, 0 = unknown
+        size_t pendingCharge = 0;       // What request() added to pendingBytes
+        std::vector<EntityID> entities;
+    };
+
+    // Built by a worker, applied on the update() thread
+    struct CellData {
+        size_t cell = 0;
+        bool ok = false;
+        ScenePackaging::SceneData scene;
+        std::vector<std::shared_ptr<ModelImport>> models;
+        size_t bytes = 0;
+    };
+
+    ECS* ecs = nullptr;
+    ModelLoader* loader = nullptr;
+    WorldStreamingSettings settings;
+    ScenePackage::MappedPackageReader reader;
+    AssetBundle bundle;
+    float cellSize = 0.0f;
+    std::vector<Cell> cells;
+    std::unordered_map<uint32_t, glm::vec3> sources;
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<BoundedQueue<int>> requests;
+    std::unique_ptr<BoundedQueue<std::unique_ptr<CellData>>> finished;
+    size_t loadsInFlight = 0;
+    size_t pendingBytes = 0;            // Estimates for cells being loaded
+    size_t residentBytes = 0;
+    size_t measuredBytes = 0;           // Totals over loads, for estimate()
+    size_t measuredEntities = 0;
+
+    uint64_t updateCount = 0;
+    std::vector<std::pair<Model*, uint64_t>> retired;  // Model, update it was unloaded in
+
+    ModelReadyFn onModelReady;
+    CellUnloadFn onCellUnloading;
+
+    static std::string cellPrefix(int32_t x, int32_t z, uint32_t flags) {
+        if (flags & CELL_ALWAYS_LOADED) return "cell/global/";
+        return "cell/" + std::to_string(x) + "_" + std::to_string(z) + "/";
+    }
+
+    bool readIndex() {
+        int index = reader.findResource("world/cells");
+        std::vector<uint8_t> storage;
+        ScenePackage::DataView view = ScenePackaging::ScenePackager::resourceBytes(reader, index, storage);
+        ScenePackaging::WorldPartitionHeader header;
+        if (view.size < sizeof(header)) return false;
+        std::memcpy(&header, view.data, sizeof(header));
+        if (view.size != sizeof(header) + size_t(header.cellCount) * sizeof(WorldCellRecord)) return false;
+        if (!(header.cellSize > 0.0f)) return false;
+
+        const auto& entries = reader.getResourceEntries();
+        cellSize = header.cellSize;
+        cells.resize(header.cellCount);
+        for (size_t i = 0; i < cells.size(); i++) {
+            WorldCellRecord& record = cells[i].record;
+            std::memcpy(&record, view.data + sizeof(header) + i * sizeof(WorldCellRecord), sizeof(WorldCellRecord));
+
+            // The cell's resources must be where the index says
+            uint64_t end = uint64_t(record.firstResource) + record.resourceCount;
+            if (record.resourceCount == 0 || end > entries.size() ||
+                entries[record.firstResource].name != cellPrefix(record.x, record.z, record.flags) + "entities") {
+                cells.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Distance on the XZ plane from the nearest source to the cell's square
+    float distanceTo(const Cell& cell) const {
+        float minX = cell.record.x * cellSize, minZ = cell.record.z * cellSize;
+        float nearest = std::numeric_limits<float>::max();
+        for (const auto& source : sources) {
+            float dx = std::max({minX - source.second.x, 0.0f, source.second.x - (minX + cellSize)});
+            float dz = std::max({minZ - source.second.z, 0.0f, source.second.z - (minZ + cellSize)});
+            nearest = std::min(nearest, std::sqrt(dx * dx + dz * dz));
+        }
+        return nearest;
+    }
+
+    // Measured size, or for a cell never loaded, its column bytes scaled by
+    // what loaded cells have cost per entity (models dominate)
+    size_t estimate(const Cell& cell) const {
+        if (cell.bytes) return cell.bytes;
+        size_t learned = measuredEntities ? measuredBytes / measuredEntities * cell.record.entityCount : 0;
+        return std::max(static_cast<size_t>(cell.record.dataBytes), learned);
+    }
+
+    bool evictable(const Cell& cell, float distance) const {
+        return cell.state == CellState::Loaded && !(cell.record.flags & CELL_ALWAYS_LOADED) && cell.distance > distance;
+    }
+
+    // Evict cells farther than distance, farthest first, until need fits.
+    // A load that can't fit even then evicts nothing.
+    bool makeRoom(size_t need, float distance) {
+        if (need > 0) {
+            size_t freeable = 0;
+            for (const Cell& cell : cells) {
+                if (evictable(cell, distance)) freeable += cell.bytes;
+            }
+            if (residentBytes + pendingBytes + need > settings.memoryBudget + freeable) return false;
+        }
+        while (residentBytes + pendingBytes + need > settings.memoryBudget) {
+            size_t farthest = SIZE_MAX;
+            for (size_t i = 0; i < cells.size(); i++) {
+                const Cell& cell = cells[i];
+                if (!evictable(cell, distance)) continue;
+                if (farthest == SIZE_MAX || cell.distance > cells[farthest].distance) farthest = i;
+            }
+            if (farthest == SIZE_MAX) return false;
+            unload(farthest);
+        }
+        return true;
+    }
+
+    void request(size_t index) {
+        Cell& cell = cells[index];
+        cell.state = CellState::Loading;
+        cell.cancelled = false;
+        loadsInFlight++;
+        cell.pendingCharge = estimate(cell);
+        pendingBytes += cell.pendingCharge;
+        requests->push(static_cast<int>(index));
+    }
+
+    // Worker: read, check and decode the cell's columns, then import its models
+    void run() {
+        int index;
+        while (requests->pop(index)) {
+            auto data = std::make_unique<CellData>();
+            data->cell = static_cast<size_t>(index);
+            const WorldCellRecord& record = cells[index].record;
+            std::string prefix = cellPrefix(record.x, record.z, record.flags);
+            const auto& entries = reader.getResourceEntries();
+
+            for (uint32_t r = record.firstResource; r < record.firstResource + record.resourceCount; r++) {
+                reader.prefetch(static_cast<int>(r));
+            }
+
+            std::vector<uint8_t> storage;
+            auto table = ScenePackaging::ScenePackager::resourceBytes(reader, record.firstResource, storage);
+            data->ok = ScenePackaging::ScenePackager::decodeEntityTable(table, data->scene, reader.getHeader().version);
+            for (uint32_t r = record.firstResource + 1; data->ok && r < record.firstResource + record.resourceCount; r++) {
+                auto blob = ScenePackaging::ScenePackager::resourceBytes(reader, static_cast<int>(r), storage);
+                data->ok = ScenePackaging::ScenePackager::decodeColumn(entries[r].name.substr(prefix.size()), blob, data->scene);
+                data->bytes += entries[r].dataSize;
+            }
+
+            // Distinct models of the cell; every instance gets its own upload
+            auto* models = data->scene.column<ModelComponent>();
+            if (data->ok && models) {
+                std::unordered_map<std::string, std::shared_ptr<ModelImport>> imported;
+                for (const ModelComponent& mc : models->components) {
+                    if (mc.modelPath.empty()) continue;
+                    auto& slot = imported[mc.modelPath];
+                    if (!slot) {
+                        slot = std::make_shared<ModelImport>();
+                        if (!bundle.importModel(mc.modelPath, *slot)) loader->import(mc.modelPath, *slot);
+                        data->models.push_back(slot);
+                    }
+                    data->bytes += modelBytes(*slot);
+                }
+            }
+
+            if (!finished->push(std::move(data))) break;
+        }
+    }
+
+    static size_t modelBytes(const ModelImport& imported) {
+        size_t bytes = imported.model.vertices.size() * sizeof(Vertex) +
+                       imported.model.indices.size() * sizeof(uint32_t);
+        for (const DecodedImage& image : imported.images) bytes += size_t(image.width) * image.height * 4;
+        return bytes;
+    }
+
+    // Insert a decoded cell into the ECS and upload its models
+    void apply(std::unique_ptr<CellData> data) {
+        Cell& cell = cells[data->cell];
+        loadsInFlight--;
+        // Exactly what request() charged; the estimate may have moved since.
+        // Failed and cancelled loads come through here too.
+        pendingBytes -= cell.pendingCharge;
+        cell.pendingCharge = 0;
+        cell.state = CellState::Unloaded;
+
+        if (!data->ok) {
+            std::cerr << "✗ World cell " << cell.record.x << "," << cell.record.z << " is corrupt; skipping" << std::endl;
+            cell.failed = true;
+            return;
+        }
+        if (!cell.bytes) {
+            measuredBytes += data->bytes;
+            measuredEntities += cell.record.entityCount;
+        }
+        cell.bytes = std::max<size_t>(data->bytes, 1);
+        if (cell.cancelled) return;
+
+        // Model rows, taken before applyScene moves the components out
+        std::vector<std::pair<uint32_t, std::string>> modelRows;
+        if (const auto* models = data->scene.column<ModelComponent>()) {
+            for (size_t i = 0; i < models->rows.size(); i++) modelRows.push_back({models->rows[i], models->components[i].modelPath});
+        }
+
+        cell.entities = ScenePackaging::ScenePackager::applyScene(ecs, data->scene);
+        cell.state = CellState::Loaded;
+        residentBytes += cell.bytes;
+
+        std::unordered_map<std::string, const ModelImport*> byPath;
+        for (const auto& imported : data->models) byPath[imported->path] = imported.get();
+
+        size_t batchSize = std::max<size_t>(settings.uploadBatchSize, 1);
+        std::vector<const ModelImport*> sources;
+        std::vector<EntityID> targets;
+        auto flush = [&] {
+            std::vector<Model> uploaded = loader->upload(sources);
+            for (size_t i = 0; i < uploaded.size(); i++) {
+                auto* mc = ecs->getComponent<ModelComponent>(targets[i]);
+                if (!mc || mc->loadedModel) {
+                    loader->cleanup(uploaded[i]);
+                    continue;
+                }
+                mc->loadedModel = new Model(std::move(uploaded[i]));
+                if (onModelReady) onModelReady(targets[i], mc->loadedModel);
+            }
+            sources.clear();
+            targets.clear();
+        };
+        for (const auto& row : modelRows) {
+            auto found = byPath.find(row.second);
+            if (found == byPath.end() || !found->second->valid()) continue;
+            sources.push_back(found->second);
+            targets.push_back(cell.entities[row.first]);
+            if (sources.size() >= batchSize) flush();
+        }
+        if (!sources.empty()) flush();
+    }
+
+    void unload(size_t index) {
+        Cell& cell = cells[index];
+        if (onCellUnloading) onCellUnloading(cell.entities);
+
+        for (EntityID e : cell.entities) {
+            auto* mc = ecs->getComponent<ModelComponent>(e);
+            if (mc && mc->loadedModel) {
+                retired.push_back({mc->loadedModel, updateCount});
+                mc->loadedModel = nullptr;
+            }
+            ecs->destroyEntity(e);
+        }
+        cell.entities.clear();
+        cell.state = CellState::Unloaded;
+        residentBytes -= std::min(residentBytes, cell.bytes);
+    }
+
+    // Models of unloaded cells may still be used by frames in flight
+    void freeRetired(bool all) {
+        size_t kept = 0;
+        for (auto& entry : retired) {
+            if (all || updateCount - entry.second >= settings.framesBeforeFree) {
+                loader->cleanup(*entry.first);
+                delete entry.first;
+            } else {
+                retired[kept++] = entry;
+            }
+        }
+        retired.resize(kept);
+    }
+};
@@ -15,9 +15,12 @@ class Skybox;
 class Camera;
 class PostProcessing;
 class ECS;
+class AssetManager;
+class EventSystem;
 struct BoneBuffer;
 struct Model;
 struct Transform;
+struct SceneLoadProgress;
 
 // ============================================================
 // ZeroEngine — embeddable engine interface
@@ -67,6 +70,7 @@ struct EngineConfig {
     
     // Shared settings
     std::string resourceRoot = "";  // empty = auto-detect
+    std::vector<std::string> packages;  // Mounted over the loose assets; later ones win
     bool enablePostProcess = true;
     bool enableShadows = true;
     bool enableSkybox = true;
@@ -135,7 +139,29 @@ public:
     // ==================== Scene ====================
     
     bool loadScene(const std::string& path);
+    // Same, reporting read/import/upload progress as the scene streams in
+    bool loadScene(const std::string& path, const std::function<void(const SceneLoadProgress&)>& onProgress);
+    // Load on worker threads while the current scene keeps running; update()
+    // swaps the new scene in between frames once its models are uploaded.
+    // False if a background load is already in progress.
+    bool loadSceneAsync(const std::string& path,
+                        const std::function<void(const SceneLoadProgress&)>& onProgress = nullptr);
+    bool isSceneLoading() const;
     bool saveScene(const std::string& path);
+    // Save with every referenced model cooked into the file; loads need no
+    // loose asset files
+    bool saveSceneBundle(const std::string& path);
+    // Snapshot now, compress and write on a worker; false while a save is running
+    bool saveSceneAsync(const std::string& path);
+    // Background-save to path every intervalSeconds while editing; 0 turns it off
+    void setAutosave(const std::string& path, float intervalSeconds);
+    
+    // Partitioned worlds: saved in cells, streamed in around the active
+    // camera (source 0) and any other sources as they move
+    bool saveWorld(const std::string& path, float cellSize = 64.0f, bool bundleAssets = false);
+    bool openWorld(const std::string& path);
+    void setStreamingSource(uint32_t id, const glm::vec3& position);
+    void removeStreamingSource(uint32_t id);
     void newScene();
     
     // ==================== Entity Management ====================
@@ -191,6 +217,13 @@ std::vector<EntityID> getEntityChildren(EntityID id) const;
     // Light settings
     void setDirectionalLight(glm::vec3 direction, glm::vec3 color, float ambient);
     
+    // Shared asset cache; update() frees what it evicts once frames in flight are done
+    AssetManager& getAssets();
+    
+    // Game events, dispatched once per update() after systems run.
+    // Subscribe to CollisionEvent for physics contacts.
+    EventSystem& getEvents();
+    
     // ==================== Vulkan Access (for editor integration) ====================
     
     VkDevice getDevice() const;
@@ -2,6 +2,8 @@
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <list>
+#include <deque>
 #include <iostream>
 #include "ModelLoader.h"
 #include "Texture.h"
@@ -12,348 +14,584 @@ template<typename T>
 class AssetHandle {
     std::shared_ptr<T> ptr;
     std::string path;
-    
+
 public:
     AssetHandle() = default;
     AssetHandle(std::shared_ptr<T> p, const std::string& pth) : ptr(p), path(pth) {}
-    
+
     T* get() const { return ptr.get(); }
     T* operator->() const { return ptr.get(); }
     T& operator*() const { return *ptr; }
-    
+
     bool isValid() const { return ptr != nullptr; }
     explicit operator bool() const { return isValid(); }
-    
+
     const std::string& getPath() const { return path; }
     int useCount() const { return ptr.use_count(); }
 };
 
+enum class AssetClass { Model, Texture, Sound, Count };
+
+// Byte limits for one asset class; 0 = unlimited
+struct AssetBudget {
+    size_t cpuBytes = 0;
+    size_t gpuBytes = 0;
+};
+
+// Caches assets by path and keeps each class within its budget. Assets
+// nothing else holds a handle to stay cached for reuse until their class
+// goes over budget; then the least recently used of them are unloaded.
+// Pinned assets are never evicted. Sounds are cached but not budgeted:
+// their samples live in AudioSystem, which this can't measure or free.
 class AssetManager {
 public:
+    struct ClassStats {
+        size_t count = 0;
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+        size_t evictions = 0;
+    };
+
     struct Stats {
         size_t modelCount = 0;
         size_t textureCount = 0;
         size_t soundCount = 0;
         size_t totalMemoryMB = 0;
+        ClassStats classes[static_cast<size_t>(AssetClass::Count)];
     };
-    
+
 private:
+    // One asset class: entries plus recency order (front = most recent)
+    template<typename T>
+    struct Cache {
+        struct Entry {
+            std::shared_ptr<T> asset;
+            size_t cpuBytes = 0;
+            size_t gpuBytes = 0;
+            bool pinned = false;
+            std::list<std::string>::iterator lru;
+        };
+
+        std::unordered_map<std::string, Entry> entries;
+        std::list<std::string> lru;
+        AssetBudget budget;
+        ClassStats stats;
+
+        Entry* find(const std::string& path) {
+            auto it = entries.find(path);
+            if (it == entries.end()) return nullptr;
+            lru.splice(lru.begin(), lru, it->second.lru);
+            return &it->second;
+        }
+
+        Entry& insert(const std::string& path, std::shared_ptr<T> asset, size_t cpuBytes, size_t gpuBytes) {
+            lru.push_front(path);
+            Entry& entry = entries[path];
+            entry.asset = std::move(asset);
+            entry.cpuBytes = cpuBytes;
+            entry.gpuBytes = gpuBytes;
+            entry.lru = lru.begin();
+            stats.count++;
+            stats.cpuBytes += cpuBytes;
+            stats.gpuBytes += gpuBytes;
+            return entry;
+        }
+
+        // Only the cache holds it
+        static bool unreferenced(const Entry& entry) { return entry.asset.use_count() <= 1; }
+
+        // destroy(std::shared_ptr<T>&) frees the asset or retires it
+        template<typename Destroy>
+        typename std::unordered_map<std::string, Entry>::iterator
+        erase(typename std::unordered_map<std::string, Entry>::iterator it, Destroy&& destroy) {
+            destroy(it->second.asset);
+            stats.count--;
+            stats.cpuBytes -= it->second.cpuBytes;
+            stats.gpuBytes -= it->second.gpuBytes;
+            lru.erase(it->second.lru);
+            return entries.erase(it);
+        }
+
+        bool overBudget() const {
+            return (budget.cpuBytes && stats.cpuBytes > budget.cpuBytes) ||
+                   (budget.gpuBytes && stats.gpuBytes > budget.gpuBytes);
+        }
+
+        // Unload unreferenced, unpinned assets oldest first until within
+        // budget (or nothing more can go)
+        template<typename Destroy>
+        void evict(Destroy&& destroy) {
+            for (auto pos = lru.end(); overBudget() && pos != lru.begin();) {
+                --pos;
+                auto it = entries.find(*pos);
+                if (it->second.pinned || !unreferenced(it->second)) continue;
+
+                pos = std::next(pos);
+                erase(it, destroy);
+                stats.evictions++;
+            }
+        }
+
+        bool setPinned(const std::string& path, bool pinned) {
+            auto it = entries.find(path);
+            if (it == entries.end()) return false;
+            it->second.pinned = pinned;
+            return true;
+        }
+    };
+
     // Asset caches
-    std::unordered_map<std::string, std::shared_ptr<Model>> models;
-    std::unordered_map<std::string, std::shared_ptr<Texture>> textures;
-    std::unordered_map<std::string, std::shared_ptr<Sound>> sounds;
-    
+    Cache<Model> models;
+    Cache<Texture> textures;
+    Cache<Sound> sounds;
+
     // Loaders (injected dependencies)
     ModelLoader* modelLoader = nullptr;
     TextureLoader* textureLoader = nullptr;
     AudioSystem* audioSystem = nullptr;
-    
+
     // Base directories
     std::string modelDir = "models/";
     std::string textureDir = "textures/";
     std::string soundDir = "sounds/";
-    
+
     // Stats tracking
     Stats stats;
-    
+
+    // Removed GPU assets, oldest first, kept until update() frees them
+    template<typename T>
+    struct Retired {
+        std::shared_ptr<T> asset;
+        uint64_t retiredAt;
+    };
+    std::deque<Retired<Model>> retiredModels;
+    std::deque<Retired<Texture>> retiredTextures;
+    uint64_t frame = 0;
+
 public:
     void init(ModelLoader* ml, TextureLoader* tl = nullptr, AudioSystem* as = nullptr) {
         modelLoader = ml;
         textureLoader = tl;
         audioSystem = as;
     }
-    
-    void setBaseDirectories(const std::string& modelPath, 
-                           const std::string& texturePath = "", 
+
+    void setBaseDirectories(const std::string& modelPath,
+                           const std::string& texturePath = "",
                            const std::string& soundPath = "") {
         modelDir = modelPath;
         if (!texturePath.empty()) textureDir = texturePath;
         if (!soundPath.empty()) soundDir = soundPath;
     }
-    
+
+    // === Budgets ===
+
+    // Evicts right away if the class is already over the new budget.
+    // Models and textures only.
+    void setBudget(AssetClass type, const AssetBudget& budget) {
+        switch (type) {
+            case AssetClass::Model: models.budget = budget; break;
+            case AssetClass::Texture: textures.budget = budget; break;
+            default:
+                std::cerr << "✗ Only model and texture budgets are supported" << std::endl;
+                return;
+        }
+        enforceBudgets();
+    }
+
+    AssetBudget getBudget(AssetClass type) const {
+        switch (type) {
+            case AssetClass::Model: return models.budget;
+            case AssetClass::Texture: return textures.budget;
+            default: return {};
+        }
+    }
+
+    // Loads evict as needed, but assets only become evictable once their
+    // last handle is dropped; call this after releasing assets (between
+    // levels, or once a frame) to reclaim them. Evicted models and textures
+    // are freed by update() once no frame in flight can still use them.
+    void enforceBudgets() {
+        models.evict([this](std::shared_ptr<Model>& model) { retire(retiredModels, model); });
+        textures.evict([this](std::shared_ptr<Texture>& texture) { retire(retiredTextures, texture); });
+        updateStats();
+    }
+
+    // Once per frame on the render thread: frees the GPU side of models and
+    // textures removed at least framesBeforeFree frames ago. Their bytes
+    // already stopped counting against the budgets when they were removed.
+    void update(uint32_t framesBeforeFree = 3) {
+        frame++;
+        freeRetired(retiredModels, framesBeforeFree, [this](Model& model) { destroyModel(model); });
+        freeRetired(retiredTextures, framesBeforeFree, [this](Texture& texture) { destroyTexture(texture); });
+    }
+
+    // === Pinning ===
+    // Pinned assets stay loaded regardless of budgets. False if not loaded.
+
+    bool pinModel(const std::string& filename, bool pinned = true) {
+        return models.setPinned(modelDir + filename, pinned);
+    }
+
+    bool pinTexture(const std::string& filename, bool pinned = true) {
+        return textures.setPinned(textureDir + filename, pinned);
+    }
+
+    bool pinSound(const std::string& filename, bool pinned = true) {
+        return sounds.setPinned(soundDir + filename, pinned);
+    }
+
     // === Model Loading ===
-    
+
     AssetHandle<Model> loadModel(const std::string& filename) {
         std::string fullPath = modelDir + filename;
-        
+
         // Check cache first
-        auto it = models.find(fullPath);
-        if (it != models.end()) {
-            std::cout << "Asset cache hit: " << fullPath << " (refs: " << it->second.use_count() << ")" << std::endl;
-            return AssetHandle<Model>(it->second, fullPath);
+        if (auto* entry = models.find(fullPath)) {
+            return AssetHandle<Model>(entry->asset, fullPath);
         }
-        
+
         // Load new model
         if (!modelLoader) {
             std::cerr << "ModelLoader not initialized!" << std::endl;
             return AssetHandle<Model>();
         }
-        
+
         std::cout << "Loading model: " << fullPath << std::endl;
         Model model = modelLoader->load(fullPath);
-        
+
         if (model.vertices.empty()) {
             std::cerr << "Failed to load model: " << fullPath << std::endl;
             return AssetHandle<Model>();
         }
-        
-        // Store in cache
+
+        // Store in cache, then make room for it
         auto sharedModel = std::make_shared<Model>(std::move(model));
-        models[fullPath] = sharedModel;
-        stats.modelCount++;
-        
+        models.insert(fullPath, sharedModel, modelCpuBytes(*sharedModel), modelGpuBytes(*sharedModel));
+        enforceBudgets();
+
         return AssetHandle<Model>(sharedModel, fullPath);
     }
-    
+
     AssetHandle<Model> getModel(const std::string& filename) {
         std::string fullPath = modelDir + filename;
-        auto it = models.find(fullPath);
-        if (it != models.end()) {
-            return AssetHandle<Model>(it->second, fullPath);
+        if (auto* entry = models.find(fullPath)) {
+            return AssetHandle<Model>(entry->asset, fullPath);
         }
         return AssetHandle<Model>();
     }
-    
+
     bool hasModel(const std::string& filename) const {
         std::string fullPath = modelDir + filename;
-        return models.find(fullPath) != models.end();
+        return models.entries.find(fullPath) != models.entries.end();
     }
-    
+
     void unloadModel(const std::string& filename) {
         std::string fullPath = modelDir + filename;
-        auto it = models.find(fullPath);
-        if (it != models.end()) {
-            std::cout << "Unloading model: " << fullPath << " (refs: " << it->second.use_count() << ")" << std::endl;
-            
+        auto it = models.entries.find(fullPath);
+        if (it != models.entries.end()) {
+            std::cout << "Unloading model: " << fullPath << " (refs: " << it->second.asset.use_count() << ")" << std::endl;
+
             // Only unload if no external references
-            if (it->second.use_count() <= 1) {
-                // Cleanup GPU resources
-                if (modelLoader) {
-                    modelLoader->cleanup(*it->second);
-                }
-                models.erase(it);
-                stats.modelCount--;
+            if (Cache<Model>::unreferenced(it->second)) {
+                models.erase(it, [this](std::shared_ptr<Model>& model) { retire(retiredModels, model); });
+                updateStats();
             } else {
                 std::cout << "  Model still in use, keeping in cache" << std::endl;
             }
         }
     }
-    
+
     // === Texture Loading ===
-    
+
     AssetHandle<Texture> loadTexture(const std::string& filename) {
         std::string fullPath = textureDir + filename;
-        
-        auto it = textures.find(fullPath);
-        if (it != textures.end()) {
-            std::cout << "Texture cache hit: " << fullPath << std::endl;
-            return AssetHandle<Texture>(it->second, fullPath);
+
+        if (auto* entry = textures.find(fullPath)) {
+            return AssetHandle<Texture>(entry->asset, fullPath);
         }
-        
+
         if (!textureLoader) {
             std::cerr << "TextureLoader not initialized!" << std::endl;
             return AssetHandle<Texture>();
         }
-        
+
         std::cout << "Loading texture: " << fullPath << std::endl;
         auto texture = std::make_shared<Texture>();
-        
+
         if (!textureLoader->loadTexture(fullPath, *texture)) {
             std::cerr << "Failed to load texture: " << fullPath << std::endl;
             return AssetHandle<Texture>();
         }
-        
-        textures[fullPath] = texture;
-        stats.textureCount++;
-        
+
+        textures.insert(fullPath, texture, 0, imageBytes(textureLoader->getAllocator(), *texture));
+        enforceBudgets();
+
         return AssetHandle<Texture>(texture, fullPath);
     }
-    
+
     AssetHandle<Texture> getTexture(const std::string& filename) {
         std::string fullPath = textureDir + filename;
-        auto it = textures.find(fullPath);
-        if (it != textures.end()) {
-            return AssetHandle<Texture>(it->second, fullPath);
+        if (auto* entry = textures.find(fullPath)) {
+            return AssetHandle<Texture>(entry->asset, fullPath);
         }
         return AssetHandle<Texture>();
     }
-    
+
     void unloadTexture(const std::string& filename) {
         std::string fullPath = textureDir + filename;
-        auto it = textures.find(fullPath);
-        if (it != textures.end()) {
-            if (it->second.use_count() <= 1 && textureLoader) {
-                textureLoader->destroyTexture(*it->second);
-                textures.erase(it);
-                stats.textureCount--;
+        auto it = textures.entries.find(fullPath);
+        if (it != textures.entries.end()) {
+            if (Cache<Texture>::unreferenced(it->second) && textureLoader) {
+                textures.erase(it, [this](std::shared_ptr<Texture>& texture) { retire(retiredTextures, texture); });
+                updateStats();
             }
         }
     }
-    
+
     // === Sound Loading ===
-    
+
     AssetHandle<Sound> loadSound(const std::string& filename) {
         std::string fullPath = soundDir + filename;
-        
-        auto it = sounds.find(fullPath);
-        if (it != sounds.end()) {
-            return AssetHandle<Sound>(it->second, fullPath);
+
+        if (auto* entry = sounds.find(fullPath)) {
+            return AssetHandle<Sound>(entry->asset, fullPath);
         }
-        
+
         if (!audioSystem) {
             std::cerr << "AudioSystem not initialized!" << std::endl;
             return AssetHandle<Sound>();
         }
-        
+
         std::cout << "Loading sound: " << fullPath << std::endl;
         auto sound = std::make_shared<Sound>();
-        
+
         if (!audioSystem->loadSound(filename, fullPath)) {
             std::cerr << "Failed to load sound: " << fullPath << std::endl;
             return AssetHandle<Sound>();
         }
-        
-        sounds[fullPath] = sound;
-        stats.soundCount++;
-        
+
+        sounds.insert(fullPath, sound, 0, 0);
+
         return AssetHandle<Sound>(sound, fullPath);
     }
-    
+
     // === Resource Management ===
-    
-    // Clean up assets with no external references
+
+    // Clean up assets with no external references (pinned ones stay)
     void cleanupUnused() {
         std::cout << "\n=== Cleaning unused assets ===" << std::endl;
-        
+
         // Cleanup models
-        for (auto it = models.begin(); it != models.end();) {
-            if (it->second.use_count() <= 1) {
+        for (auto it = models.entries.begin(); it != models.entries.end();) {
+            if (!it->second.pinned && Cache<Model>::unreferenced(it->second)) {
                 std::cout << "  Removing unused model: " << it->first << std::endl;
-                if (modelLoader) {
-                    modelLoader->cleanup(*it->second);
-                }
-                it = models.erase(it);
-                stats.modelCount--;
+                it = models.erase(it, [this](std::shared_ptr<Model>& model) { retire(retiredModels, model); });
             } else {
                 ++it;
             }
         }
-        
+
         // Cleanup textures
-        for (auto it = textures.begin(); it != textures.end();) {
-            if (it->second.use_count() <= 1) {
+        for (auto it = textures.entries.begin(); it != textures.entries.end();) {
+            if (!it->second.pinned && Cache<Texture>::unreferenced(it->second)) {
                 std::cout << "  Removing unused texture: " << it->first << std::endl;
-                if (textureLoader) {
-                    textureLoader->destroyTexture(*it->second);
-                }
-                it = textures.erase(it);
-                stats.textureCount--;
+                it = textures.erase(it, [this](std::shared_ptr<Texture>& texture) { retire(retiredTextures, texture); });
             } else {
                 ++it;
             }
         }
-        
+
         // Cleanup sounds
-        for (auto it = sounds.begin(); it != sounds.end();) {
-            if (it->second.use_count() <= 1) {
+        for (auto it = sounds.entries.begin(); it != sounds.entries.end();) {
+            if (!it->second.pinned && Cache<Sound>::unreferenced(it->second)) {
                 std::cout << "  Removing unused sound: " << it->first << std::endl;
-                it = sounds.erase(it);
-                stats.soundCount--;
+                it = sounds.erase(it, [](std::shared_ptr<Sound>&) {});
             } else {
                 ++it;
             }
         }
-        
+
+        updateStats();
         std::cout << "Cleanup complete. Remaining assets: "
                   << stats.modelCount << " models, "
                   << stats.textureCount << " textures, "
                   << stats.soundCount << " sounds" << std::endl;
     }
-    
-    // Force unload all assets
+
+    // Force unload all assets, pinned or not, and free everything retired
+    // right away (the GPU must be idle)
     void clear() {
         std::cout << "Clearing all assets..." << std::endl;
-        
+
         // Clean up GPU resources
-        if (modelLoader) {
-            for (auto& [path, model] : models) {
-                modelLoader->cleanup(*model);
-            }
+        for (auto it = models.entries.begin(); it != models.entries.end();) {
+            it = models.erase(it, [this](std::shared_ptr<Model>& model) { destroyModel(*model); });
         }
-        
-        if (textureLoader) {
-            for (auto& [path, texture] : textures) {
-                textureLoader->destroyTexture(*texture);
-            }
+        for (auto it = textures.entries.begin(); it != textures.entries.end();) {
+            it = textures.erase(it, [this](std::shared_ptr<Texture>& texture) { destroyTexture(*texture); });
         }
-        
-        models.clear();
-        textures.clear();
-        sounds.clear();
-        
-        stats = Stats{};
+        for (auto& retired : retiredModels) destroyModel(*retired.asset);
+        for (auto& retired : retiredTextures) destroyTexture(*retired.asset);
+        retiredModels.clear();
+        retiredTextures.clear();
+        sounds.entries.clear();
+        sounds.lru.clear();
+        sounds.stats.count = sounds.stats.cpuBytes = sounds.stats.gpuBytes = 0;
+
+        updateStats();
     }
-    
+
     // === Statistics ===
-    
+
     const Stats& getStats() const { return stats; }
-    
+
     void printStats() const {
+        auto line = [](const char* label, const ClassStats& c, const AssetBudget& budget) {
+            std::cout << label << c.count << "  CPU " << c.cpuBytes / (1024.0f * 1024.0f) << " MB";
+            if (budget.cpuBytes) std::cout << " / " << budget.cpuBytes / (1024.0f * 1024.0f);
+            std::cout << "  GPU " << c.gpuBytes / (1024.0f * 1024.0f) << " MB";
+            if (budget.gpuBytes) std::cout << " / " << budget.gpuBytes / (1024.0f * 1024.0f);
+            std::cout << "  evicted " << c.evictions << std::endl;
+        };
+
         std::cout << "\n=== Asset Manager Stats ===" << std::endl;
-        std::cout << "Models:   " << stats.modelCount << std::endl;
-        std::cout << "Textures: " << stats.textureCount << std::endl;
-        std::cout << "Sounds:   " << stats.soundCount << std::endl;
-        std::cout << "Total:    " << (stats.modelCount + stats.textureCount + stats.soundCount) << std::endl;
+        line("Models:   ", models.stats, models.budget);
+        line("Textures: ", textures.stats, textures.budget);
+        line("Sounds:   ", sounds.stats, sounds.budget);
+        std::cout << "Total:    " << (stats.modelCount + stats.textureCount + stats.soundCount)
+                  << " (" << stats.totalMemoryMB << " MB)" << std::endl;
     }
-    
+
     void printDetailedStats() const {
         std::cout << "\n=== Detailed Asset Stats ===" << std::endl;
-        
-        std::cout << "\nModels (" << models.size() << "):" << std::endl;
-        for (const auto& [path, model] : models) {
-            std::cout << "  " << path << " (refs: " << model.use_count() << ")" << std::endl;
-            std::cout << "    Vertices: " << model->vertices.size() 
-                      << ", Indices: " << model->indices.size() << std::endl;
-        }
-        
-        std::cout << "\nTextures (" << textures.size() << "):" << std::endl;
-        for (const auto& [path, texture] : textures) {
-            std::cout << "  " << path << " (refs: " << texture.use_count() << ")" << std::endl;
-            if (texture) {
-                std::cout << "    Size: " << texture->width << "x" << texture->height << std::endl;
-            }
+
+        std::cout << "\nModels (" << models.entries.size() << "):" << std::endl;
+        for (const auto& [path, entry] : models.entries) {
+            std::cout << "  " << path << " (refs: " << entry.asset.use_count() << (entry.pinned ? ", pinned" : "") << ")" << std::endl;
+            std::cout << "    Vertices: " << entry.asset->vertices.size()
+                      << ", Indices: " << entry.asset->indices.size()
+                      << ", CPU: " << entry.cpuBytes / 1024 << " KB, GPU: " << entry.gpuBytes / 1024 << " KB" << std::endl;
+        }
+
+        std::cout << "\nTextures (" << textures.entries.size() << "):" << std::endl;
+        for (const auto& [path, entry] : textures.entries) {
+            std::cout << "  " << path << " (refs: " << entry.asset.use_count() << (entry.pinned ? ", pinned" : "") << ")" << std::endl;
+            std::cout << "    Size: " << entry.asset->width << "x" << entry.asset->height
+                      << ", GPU: " << entry.gpuBytes / 1024 << " KB" << std::endl;
         }
-        
-        std::cout << "\nSounds (" << sounds.size() << "):" << std::endl;
-        for (const auto& [path, sound] : sounds) {
-            std::cout << "  " << path << " (refs: " << sound.use_count() << ")" << std::endl;
+
+        std::cout << "\nSounds (" << sounds.entries.size() << "):" << std::endl;
+        for (const auto& [path, entry] : sounds.entries) {
+            std::cout << "  " << path << " (refs: " << entry.asset.use_count() << (entry.pinned ? ", pinned" : "") << ")" << std::endl;
         }
     }
-    
+
     // List all loaded assets
     std::vector<std::string> getLoadedModels() const {
         std::vector<std::string> result;
-        for (const auto& [path, _] : models) {
+        for (const auto& [path, _] : models.entries) {
             result.push_back(path);
         }
         return result;
     }
-    
+
     std::vector<std::string> getLoadedTextures() const {
         std::vector<std::string> result;
-        for (const auto& [path, _] : textures) {
+        for (const auto& [path, _] : textures.entries) {
             result.push_back(path);
         }
         return result;
     }
-    
+
     std::vector<std::string> getLoadedSounds() const {
         std::vector<std::string> result;
-        for (const auto& [path, _] : sounds) {
+        for (const auto& [path, _] : sounds.entries) {
             result.push_back(path);
         }
         return result;
     }
+
+private:
+    template<typename T>
+    void retire(std::deque<Retired<T>>& retired, std::shared_ptr<T>& asset) {
+        retired.push_back({std::move(asset), frame});
+    }
+
+    template<typename T, typename Destroy>
+    void freeRetired(std::deque<Retired<T>>& retired, uint32_t framesBeforeFree, Destroy&& destroy) {
+        while (!retired.empty() && frame - retired.front().retiredAt >= framesBeforeFree) {
+            destroy(*retired.front().asset);
+            retired.pop_front();
+        }
+    }
+
+    void destroyModel(Model& model) {
+        if (modelLoader) modelLoader->cleanup(model);
+    }
+
+    void destroyTexture(Texture& texture) {
+        if (textureLoader) textureLoader->destroyTexture(texture);
+    }
+
+    void updateStats() {
+        stats.modelCount = models.stats.count;
+        stats.textureCount = textures.stats.count;
+        stats.soundCount = sounds.stats.count;
+        stats.classes[static_cast<size_t>(AssetClass::Model)] = models.stats;
+        stats.classes[static_cast<size_t>(AssetClass::Texture)] = textures.stats;
+        stats.classes[static_cast<size_t>(AssetClass::Sound)] = sounds.stats;
+
+        size_t total = 0;
+        for (const ClassStats& c : stats.classes) total += c.cpuBytes + c.gpuBytes;
+        stats.totalMemoryMB = total / (1024 * 1024);
+    }
+
+    // Actual allocation size from VMA (includes alignment padding)
+    static size_t allocationBytes(VmaAllocator allocator, VmaAllocation allocation) {
+        if (!allocator || !allocation) return 0;
+        VmaAllocationInfo info{};
+        vmaGetAllocationInfo(allocator, allocation, &info);
+        return static_cast<size_t>(info.size);
+    }
+
+    static size_t imageBytes(VmaAllocator allocator, const Texture& texture) {
+        if (texture.image == VK_NULL_HANDLE) return 0;
+        return allocationBytes(allocator, texture.allocation);
+    }
+
+    // CPU copies the model keeps after upload
+    static size_t modelCpuBytes(const Model& model) {
+        size_t bytes = sizeof(Model);
+        bytes += model.vertices.capacity() * sizeof(Vertex);
+        bytes += model.indices.capacity() * sizeof(uint32_t);
+        bytes += model.submeshes.capacity() * sizeof(SubMesh);
+        bytes += model.materials.capacity() * sizeof(MaterialData);
+        bytes += model.textures.capacity() * sizeof(Texture);
+        bytes += model.bones.capacity() * sizeof(BoneInfo);
+        for (const Animation& anim : model.animations) {
+            bytes += sizeof(Animation);
+            for (const auto& channel : anim.channels) {
+                bytes += sizeof(channel);
+                bytes += channel.positions.capacity() * sizeof(channel.positions[0]);
+                bytes += channel.rotations.capacity() * sizeof(channel.rotations[0]);
+                bytes += channel.scales.capacity() * sizeof(channel.scales[0]);
+            }
+        }
+        if (model.collisionMesh) {
+            bytes += model.collisionMesh->getTriangleCount() * sizeof(TriangleMeshShape::Triangle);
+            bytes += model.collisionMesh->getNodeCount() * sizeof(TriangleMeshShape::Node);
+        }
+        return bytes;
+    }
+
+    size_t modelGpuBytes(const Model& model) const {
+        VmaAllocator allocator = modelLoader ? modelLoader->getAllocator() : nullptr;
+        size_t bytes = 0;
+        if (model.vertexBuffer) bytes += allocationBytes(allocator, model.vertexAllocation);
+        if (model.indexBuffer) bytes += allocationBytes(allocator, model.indexAllocation);
+        for (const Texture& texture : model.textures) bytes += imageBytes(allocator, texture);
+        return bytes;
+    }
 };
 
 // Global asset manager (optional singleton pattern)
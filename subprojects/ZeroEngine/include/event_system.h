@@ -1,10 +1,18 @@
 #pragma once
 #include "Engine.h"
+#include "MPSCQueue.h"
+#include "Name.h"
 #include <functional>
 #include <unordered_map>
 #include <vector>
 #include <string>
 #include <variant>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <type_traits>
 #include <glm/glm.hpp>
 
 enum class EventType {
@@ -52,12 +60,12 @@ struct Event {
     EventType type;
     EntityID entity = 0;
     std::string customType; // For Custom events
-    std::unordered_map<std::string, EventData> data;
+    std::unordered_map<Name, EventData> data;
     float timestamp = 0.0f;
     
     // Helper methods to get data safely
     template<typename T>
-    T get(const std::string& key, T defaultValue = T{}) const {
+    T get(Name key, T defaultValue = T{}) const {
         auto it = data.find(key);
         if (it != data.end()) {
             if (auto* val = std::get_if<T>(&it->second)) {
@@ -67,26 +75,129 @@ struct Event {
         return defaultValue;
     }
     
-    bool has(const std::string& key) const {
+    bool has(Name key) const {
         return data.find(key) != data.end();
     }
     
     // Convenience setters
-    void setInt(const std::string& key, int value) { data[key] = value; }
-    void setFloat(const std::string& key, float value) { data[key] = value; }
-    void setBool(const std::string& key, bool value) { data[key] = value; }
-    void setString(const std::string& key, const std::string& value) { data[key] = value; }
-    void setVec3(const std::string& key, const glm::vec3& value) { data[key] = value; }
-    void setEntity(const std::string& key, EntityID value) { data[key] = value; }
+    void setInt(Name key, int value) { data[key] = value; }
+    void setFloat(Name key, float value) { data[key] = value; }
+    void setBool(Name key, bool value) { data[key] = value; }
+    void setString(Name key, const std::string& value) { data[key] = value; }
+    void setVec3(Name key, const glm::vec3& value) { data[key] = value; }
+    void setEntity(Name key, EntityID value) { data[key] = value; }
 };
 
 // Event listener handle for unsubscribing
 using ListenerHandle = size_t;
 
+// Callable with no per-call allocation. Small trivially copyable callables
+// (function pointers, lambdas capturing pointers or IDs) are stored inline;
+// anything else is copied to the heap once, when bound.
+template<typename Signature>
+class EventDelegate;
+
+template<typename R, typename... Args>
+class EventDelegate<R(Args...)> {
+public:
+    static constexpr size_t INLINE_SIZE = 4 * sizeof(void*);
+    
+    EventDelegate() = default;
+    
+    template<typename Fn, typename = std::enable_if_t<!std::is_same<std::decay_t<Fn>, EventDelegate>::value>>
+    EventDelegate(Fn&& fn) { bind(std::forward<Fn>(fn)); }
+    
+    EventDelegate(EventDelegate&& other) noexcept { take(other); }
+    
+    EventDelegate& operator=(EventDelegate&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+    
+    EventDelegate(const EventDelegate&) = delete;
+    EventDelegate& operator=(const EventDelegate&) = delete;
+    
+    ~EventDelegate() { reset(); }
+    
+    R operator()(Args... args) const { return call(target(), std::forward<Args>(args)...); }
+    explicit operator bool() const { return call != nullptr; }
+    
+private:
+    using Call = R (*)(void*, Args...);
+    using Destroy = void (*)(void*);
+    
+    union {
+        void* heap;
+        alignas(void*) unsigned char local[INLINE_SIZE];
+    };
+    Call call = nullptr;
+    Destroy destroy = nullptr;  // Set when the callable is on the heap
+    
+    template<typename Fn>
+    void bind(Fn&& fn) {
+        using F = std::decay_t<Fn>;
+        if constexpr (sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(void*) &&
+                      std::is_trivially_copyable<F>::value) {
+            new (local) F(std::forward<Fn>(fn));
+        } else {
+            heap = new F(std::forward<Fn>(fn));
+            destroy = [](void* p) { delete static_cast<F*>(p); };
+        }
+        call = [](void* p, Args... args) -> R { return (*static_cast<F*>(p))(std::forward<Args>(args)...); };
+    }
+    
+    void* target() const { return destroy ? heap : const_cast<unsigned char*>(local); }
+    
+    void take(EventDelegate& other) {
+        std::memcpy(local, other.local, INLINE_SIZE);
+        call = other.call;
+        destroy = other.destroy;
+        other.call = nullptr;
+        other.destroy = nullptr;
+    }
+    
+    void reset() {
+        if (destroy) destroy(heap);
+        call = nullptr;
+        destroy = nullptr;
+    }
+};
+
+// Two kinds of events:
+//
+// Event (EventType or custom name) carries a map of named values; handy
+// for scripting and rare events, but every publish builds that map.
+//
+// Typed events are plain structs. publish<CollisionEvent>(...) appends to
+// a buffer per type, and processQueue() hands each listener the whole
+// buffer in one call: a contiguous span, in publish order, highest
+// priority listener first. Buffers keep their capacity from frame to
+// frame and listeners are EventDelegates, so a steady stream of events
+// doesn't allocate.
+//
+// All of the above is for the thread that owns the EventSystem. Other
+// threads (physics, loading, audio) use publishAsync<E>() and
+// queueAsync(): each type has a bounded lock-free queue (MPSCQueue.h)
+// that processQueue() or drainAsync() moves into the frame's events. A
+// full queue rejects the event, and getAsyncStats() reports it.
 class EventSystem {
 public:
     using Callback = std::function<void(const Event&)>;
     
+    template<typename E>
+    using BatchCallback = EventDelegate<void(const E*, size_t)>;
+    
+    struct AsyncQueueStats {
+        size_t capacity = 0;
+        size_t published = 0;   // Accepted since the queue was created
+        size_t dropped = 0;     // Rejected because the queue was full
+        size_t highWater = 0;   // Most events moved by one drain
+        size_t pending = 0;     // Waiting for the next drain (approximate)
+    };
+    
 private:
     struct Listener {
         ListenerHandle handle;
@@ -102,7 +213,214 @@ private:
     
     ListenerHandle nextHandle = 1;
     
+    // === Typed channels ===
+    
+    struct ChannelBase {
+        virtual ~ChannelBase() = default;
+        virtual void dispatch() = 0;
+        virtual void remove(ListenerHandle handle) = 0;
+        virtual void clear() = 0;
+    };
+    
+    template<typename E>
+    struct Channel : ChannelBase {
+        struct Listener {
+            ListenerHandle handle;
+            int priority;
+            BatchCallback<E> callback;
+            bool removed = false;
+        };
+        
+        std::vector<Listener> listeners;
+        std::vector<Listener> added;        // Subscribed during dispatch; joins after it
+        std::vector<E> events;              // Published since the last dispatch
+        std::vector<E> delivering;          // Being dispatched
+        bool dispatching = false;
+        
+        void add(Listener listener) {
+            if (dispatching) {
+                added.push_back(std::move(listener));
+                return;
+            }
+            // Stable: equal priorities keep subscription order
+            auto at = std::upper_bound(listeners.begin(), listeners.end(), listener.priority,
+                [](int priority, const Listener& l) { return priority > l.priority; });
+            listeners.insert(at, std::move(listener));
+        }
+        
+        // Listeners may subscribe, unsubscribe and publish from inside
+        void deliver(const E* data, size_t count) {
+            bool nested = dispatching;
+            dispatching = true;
+            for (size_t i = 0; i < listeners.size(); i++) {
+                if (!listeners[i].removed) listeners[i].callback(data, count);
+            }
+            dispatching = nested;
+            if (!dispatching) settle();
+        }
+        
+        // Events published by listeners go into the next round
+        void dispatch() override {
+            std::swap(events, delivering);
+            deliver(delivering.data(), delivering.size());
+            delivering.clear();
+        }
+        
+        void remove(ListenerHandle handle) override {
+            for (auto& l : listeners) {
+                if (l.handle == handle) l.removed = true;
+            }
+            for (auto& l : added) {
+                if (l.handle == handle) l.removed = true;
+            }
+            if (!dispatching) settle();
+        }
+        
+        void clear() override {
+            for (auto& l : listeners) l.removed = true;
+            added.clear();
+            events.clear();
+            if (!dispatching) settle();
+        }
+        
+        // Apply removals and subscriptions deferred during dispatch
+        void settle() {
+            listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                           [](const Listener& l) { return l.removed; }),
+                            listeners.end());
+            std::vector<Listener> pending = std::move(added);
+            added.clear();
+            for (auto& l : pending) {
+                if (!l.removed) add(std::move(l));
+            }
+        }
+    };
+    
+    std::vector<std::unique_ptr<ChannelBase>> channels;   // By channelIndex<E>()
+    std::vector<size_t> activeChannels;                   // Have events, in first-publish order
+    std::vector<size_t> dispatchingChannels;
+    
+    static size_t nextChannelIndex() {
+        static std::atomic<size_t> next{0};
+        return next++;
+    }
+    
+    template<typename E>
+    static size_t channelIndex() {
+        static const size_t index = nextChannelIndex();
+        return index;
+    }
+    
+    template<typename E>
+    Channel<E>& channel() {
+        size_t index = channelIndex<E>();
+        if (index >= channels.size()) channels.resize(index + 1);
+        if (!channels[index]) channels[index] = std::make_unique<Channel<E>>();
+        return static_cast<Channel<E>&>(*channels[index]);
+    }
+    
+    template<typename E>
+    std::vector<E>& publishBuffer() {
+        Channel<E>& ch = channel<E>();
+        if (ch.events.empty()) activeChannels.push_back(channelIndex<E>());
+        return ch.events;
+    }
+    
+    // === Cross-thread queues ===
+    //
+    // A fixed table so threads can find (or create, with one CAS) a type's
+    // queue without locking; channels themselves are only touched by the
+    // owning thread, when draining.
+    
+    static constexpr size_t MAX_ASYNC_TYPES = 128;
+    static constexpr size_t DEFAULT_ASYNC_CAPACITY = 4096;
+    
+    struct AsyncQueueBase {
+        size_t highWater = 0;           // Most events found in one drain
+        std::atomic<size_t> dropped{0};
+        
+        virtual ~AsyncQueueBase() = default;
+        virtual size_t drainInto(EventSystem& events) = 0;
+        virtual size_t capacity() const = 0;
+        virtual size_t pushed() const = 0;
+        virtual size_t pending() const = 0;
+    };
+    
+    template<typename E>
+    struct AsyncQueue : AsyncQueueBase {
+        MPSCQueue<E> queue;
+        
+        explicit AsyncQueue(size_t capacity) : queue(capacity) {}
+        
+        size_t drainInto(EventSystem& events) override {
+            // One ring's worth at most, so busy producers can't hold up the frame
+            size_t count = queue.drain([&](E&& event) { events.accept(std::move(event)); }, queue.capacity());
+            highWater = std::max(highWater, count);
+            return count;
+        }
+        
+        size_t capacity() const override { return queue.capacity(); }
+        size_t pushed() const override { return queue.pushed(); }
+        size_t pending() const override { return queue.size(); }
+    };
+    
+    std::unique_ptr<std::atomic<AsyncQueueBase*>[]> asyncQueues{new std::atomic<AsyncQueueBase*>[MAX_ASYNC_TYPES]()};
+    std::atomic<size_t> asyncQueueSlots{0};    // Highest used slot + 1
+    
+    // Keyed like channels; Event (the string kind) gets a slot of its own
+    template<typename E>
+    AsyncQueue<E>* asyncQueue(size_t capacity = DEFAULT_ASYNC_CAPACITY) {
+        size_t index = channelIndex<E>();
+        if (index >= MAX_ASYNC_TYPES) return nullptr;
+        
+        std::atomic<AsyncQueueBase*>& slot = asyncQueues[index];
+        AsyncQueueBase* existing = slot.load(std::memory_order_acquire);
+        if (existing) return static_cast<AsyncQueue<E>*>(existing);
+        
+        auto* created = new AsyncQueue<E>(capacity);
+        if (!slot.compare_exchange_strong(existing, created, std::memory_order_acq_rel)) {
+            delete created;     // Another thread got there first
+            return static_cast<AsyncQueue<E>*>(existing);
+        }
+        size_t used = asyncQueueSlots.load(std::memory_order_relaxed);
+        while (used < index + 1 && !asyncQueueSlots.compare_exchange_weak(used, index + 1)) {}
+        return created;
+    }
+    
+    static AsyncQueueStats asyncStats(const AsyncQueueBase* async) {
+        AsyncQueueStats stats;
+        if (!async) return stats;
+        stats.capacity = async->capacity();
+        stats.published = async->pushed();
+        stats.dropped = async->dropped.load(std::memory_order_relaxed);
+        stats.highWater = async->highWater;
+        stats.pending = async->pending();
+        return stats;
+    }
+    
+    template<typename E>
+    void accept(E&& event) { publishBuffer<E>().push_back(std::move(event)); }
+    void accept(Event&& event) { eventQueue.push_back(std::move(event)); }
+    
+    // One round over the channels that have events
+    bool dispatchChannels() {
+        if (activeChannels.empty()) return false;
+        std::swap(activeChannels, dispatchingChannels);
+        for (size_t index : dispatchingChannels) channels[index]->dispatch();
+        dispatchingChannels.clear();
+        return true;
+    }
+    
 public:
+    EventSystem() = default;
+    EventSystem(const EventSystem&) = delete;
+    EventSystem& operator=(const EventSystem&) = delete;
+    
+    // Producers must be done with publishAsync() by now
+    ~EventSystem() {
+        for (size_t i = 0; i < MAX_ASYNC_TYPES; i++) delete asyncQueues[i].load(std::memory_order_acquire);
+    }
+    
     // Subscribe to event type
     ListenerHandle subscribe(EventType type, Callback callback, int priority = 0) {
         ListenerHandle handle = nextHandle++;
@@ -132,6 +450,23 @@ public:
         return handle;
     }
     
+    // Subscribe to a typed event; fn(const E&) runs once per event
+    template<typename E, typename Fn>
+    ListenerHandle subscribe(Fn fn, int priority = 0) {
+        return subscribeBatch<E>([fn](const E* events, size_t count) {
+            for (size_t i = 0; i < count; i++) fn(events[i]);
+        }, priority);
+    }
+    
+    // Subscribe to a typed event; fn(const E* events, size_t count) gets
+    // each round's events in one call
+    template<typename E, typename Fn>
+    ListenerHandle subscribeBatch(Fn&& fn, int priority = 0) {
+        ListenerHandle handle = nextHandle++;
+        channel<E>().add({handle, priority, BatchCallback<E>(std::forward<Fn>(fn))});
+        return handle;
+    }
+    
     // Unsubscribe by handle
     void unsubscribe(ListenerHandle handle) {
         // Search in regular listeners
@@ -147,6 +482,11 @@ public:
                 [handle](const Listener& l) { return l.handle == handle; });
             list.erase(it, list.end());
         }
+        
+        // Search in typed channels
+        for (auto& ch : channels) {
+            if (ch) ch->remove(handle);
+        }
     }
     
     // Emit event immediately (synchronous)
@@ -168,6 +508,68 @@ public:
         }
     }
     
+    // Queue a typed event for processQueue(); E is built from args
+    template<typename E, typename... Args>
+    void publish(Args&&... args) {
+        publishBuffer<E>().push_back(E{std::forward<Args>(args)...});
+    }
+    
+    // Queue count typed events at once
+    template<typename E>
+    void publishBatch(const E* events, size_t count) {
+        if (count == 0) return;
+        std::vector<E>& buffer = publishBuffer<E>();
+        buffer.insert(buffer.end(), events, events + count);
+    }
+    
+    // Queue a typed event from any thread; it's delivered by the owning
+    // thread's next processQueue(). False (and counted) when E's queue is full.
+    template<typename E, typename... Args>
+    bool publishAsync(Args&&... args) {
+        AsyncQueue<E>* async = asyncQueue<E>();
+        if (!async) return false;
+        if (async->queue.push(E{std::forward<Args>(args)...})) return true;
+        async->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    // queue() for other threads
+    bool queueAsync(const Event& event) {
+        AsyncQueue<Event>* async = asyncQueue<Event>();
+        if (async && async->queue.push(event)) return true;
+        if (async) async->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    // Size E's cross-thread queue before any thread uses it; false if it
+    // already exists. Producers that post bursts (a physics step's contacts)
+    // want room for the largest burst between drains.
+    template<typename E>
+    bool setAsyncCapacity(size_t capacity) {
+        size_t index = channelIndex<E>();
+        if (index >= MAX_ASYNC_TYPES || asyncQueues[index].load(std::memory_order_acquire)) return false;
+        AsyncQueue<E>* async = asyncQueue<E>(capacity);
+        return async && async->capacity() >= capacity;
+    }
+    
+    // Move events posted by other threads into this frame's queues. Owning
+    // thread; processQueue() does this first. Returns how many moved.
+    size_t drainAsync() {
+        size_t moved = 0;
+        size_t slots = asyncQueueSlots.load(std::memory_order_acquire);
+        for (size_t i = 0; i < slots; i++) {
+            AsyncQueueBase* async = asyncQueues[i].load(std::memory_order_acquire);
+            if (async) moved += async->drainInto(*this);
+        }
+        return moved;
+    }
+    
+    // Deliver a typed event right away (synchronous)
+    template<typename E>
+    void emit(const E& event) {
+        channel<E>().deliver(&event, 1);
+    }
+    
     // Queue event for later processing (asynchronous)
     void queue(const Event& event) {
         eventQueue.push_back(event);
@@ -178,15 +580,18 @@ public:
         if (processingEvents) return; // Prevent recursive processing
         
         processingEvents = true;
+        drainAsync();
         
         // Process queue (allow new events to be queued during processing)
-        while (!eventQueue.empty()) {
+        while (!eventQueue.empty() || !activeChannels.empty()) {
             std::vector<Event> currentQueue = std::move(eventQueue);
             eventQueue.clear();
             
             for (const auto& event : currentQueue) {
                 emit(event);
             }
+            
+            dispatchChannels();
         }
         
         processingEvents = false;
@@ -194,9 +599,14 @@ public:
     
     // Clear all listeners
     void clear() {
+        drainAsync();   // Cross-thread events are dropped with the rest
         listeners.clear();
         customListeners.clear();
         eventQueue.clear();
+        for (auto& ch : channels) {
+            if (ch) ch->clear();
+        }
+        activeChannels.clear();
     }
     
     // Get number of listeners for event type
@@ -209,6 +619,40 @@ public:
         auto it = customListeners.find(customType);
         return it != customListeners.end() ? it->second.size() : 0;
     }
+    
+    template<typename E>
+    size_t getListenerCount() {
+        return channel<E>().listeners.size();
+    }
+    
+    // E's cross-thread queue; all zero until some thread uses it
+    template<typename E>
+    AsyncQueueStats getAsyncStats() const {
+        size_t index = channelIndex<E>();
+        if (index >= MAX_ASYNC_TYPES) return {};
+        return asyncStats(asyncQueues[index].load(std::memory_order_acquire));
+    }
+    
+    // Summed over every type's queue
+    AsyncQueueStats getAsyncStats() const {
+        AsyncQueueStats total;
+        size_t slots = asyncQueueSlots.load(std::memory_order_acquire);
+        for (size_t i = 0; i < slots; i++) {
+            AsyncQueueStats one = asyncStats(asyncQueues[i].load(std::memory_order_acquire));
+            total.capacity += one.capacity;
+            total.published += one.published;
+            total.dropped += one.dropped;
+            total.highWater += one.highWater;
+            total.pending += one.pending;
+        }
+        return total;
+    }
+    
+    // Typed events of E waiting for processQueue()
+    template<typename E>
+    size_t getPendingCount() {
+        return channel<E>().events.size();
+    }
 };
 
 // Global event system instance (optional, or pass around as needed)
@@ -4,109 +4,318 @@
 #include "tags.h"
 #include "PhysicsSystem.h"
 #include <nlohmann/json.hpp>
+#include "VirtualFileSystem.h"
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
 #include <iostream>
 
 using json = nlohmann::json;
 
-// Prefab - reusable entity template
-class Prefab {
+// Compiled prefab - the JSON parsed once into ready-built components
+//
+// Each entity of the (flattened) hierarchy is a node; nested prefabs are
+// inlined at compile time. Components are stored per type as prototype
+// values, so an instance is a bulk copy of each block plus remapping of
+// node indices to the freshly created EntityIDs. No JSON is touched.
+class CompiledPrefab {
 public:
+    // Returns the JSON of a nested prefab by reference name, or nullptr
+    using Resolver = std::function<const json*(const std::string&)>;
+    
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+    static constexpr int MAX_NESTING = 16;
+    
     std::string name;
-    json data;
     
-    Prefab() = default;
-    Prefab(const std::string& n) : name(n) {}
+    // nullptr (and a message) if the document or a nested prefab is invalid
+    static std::shared_ptr<const CompiledPrefab> compile(const json& data, const Resolver& resolve) {
+        auto compiled = std::make_shared<CompiledPrefab>();
+        if (data.contains("name") && data["name"].is_string()) {
+            compiled->name = data["name"];
+        }
+        
+        try {
+            std::vector<std::string> stack;
+            if (!compiled->addNode(data, NO_PARENT, nullptr, resolve, stack)) {
+                return nullptr;
+            }
+        } catch (const json::exception& e) {
+            std::cerr << "Prefab compile error (" << compiled->name << "): " << e.what() << std::endl;
+            return nullptr;
+        }
+        
+        return compiled;
+    }
     
-    // Create entity from this prefab
-    EntityID instantiate(ECS* ecs, glm::vec3 position = glm::vec3(0), glm::quat rotation = glm::quat(1,0,0,0)) {
-        EntityID entity = ecs->createEntity();
+    size_t nodeCount() const { return parents.size(); }
+    
+    // Create one copy; returns the root entity
+    EntityID instantiate(ECS* ecs, glm::vec3 position = glm::vec3(0), glm::quat rotation = glm::quat(1,0,0,0)) const {
+        std::vector<EntityID> roots = instantiate(ecs, &position, 1, rotation);
+        return roots.empty() ? 0 : roots[0];
+    }
+    
+    // Create one copy per position; returns the root entity of each
+    std::vector<EntityID> instantiate(ECS* ecs, const std::vector<glm::vec3>& positions,
+                                      glm::quat rotation = glm::quat(1,0,0,0)) const {
+        return instantiate(ecs, positions.data(), positions.size(), rotation);
+    }
+    
+    std::vector<EntityID> instantiate(ECS* ecs, const glm::vec3* positions, size_t count,
+                                      glm::quat rotation = glm::quat(1,0,0,0)) const {
+        std::vector<EntityID> roots;
+        const size_t nodes = nodeCount();
+        if (nodes == 0 || count == 0) return roots;
+        
+        // Instance c, node n -> ids[c * nodes + n]
+        std::vector<EntityID> ids(count * nodes);
+        for (EntityID& id : ids) {
+            id = ecs->createEntity();
+        }
+        
+        roots.reserve(count);
+        for (size_t c = 0; c < count; ++c) {
+            roots.push_back(ids[c * nodes]);
+        }
         
-        // Apply components from prefab data
-        if (data.contains("components")) {
-            const json& components = data["components"];
-            
-            // Transform
-            if (components.contains("transform")) {
-                Transform transform;
-                transform.position = position; // Override with instantiation position
-                transform.rotation = rotation;
-                
-                if (components["transform"].contains("scale")) {
-                    auto& s = components["transform"]["scale"];
-                    transform.scale = glm::vec3(s[0], s[1], s[2]);
+        // Transforms carry the hierarchy, so they are remapped per copy
+        if (!transforms.values.empty()) {
+            std::vector<EntityID> targets;
+            std::vector<Transform> out;
+            expand(transforms, ids, count, targets, out);
+            
+            const size_t perCopy = transforms.values.size();
+            for (size_t c = 0; c < count; ++c) {
+                const EntityID* base = &ids[c * nodes];
+                for (size_t i = 0; i < perCopy; ++i) {
+                    Transform& t = out[c * perCopy + i];
+                    uint32_t node = transforms.nodes[i];
+                    
+                    if (parents[node] == NO_PARENT) {
+                        t.position = positions[c];
+                        t.rotation = rotation;
+                    } else {
+                        t.parent = base[parents[node]];
+                    }
+                    for (EntityID& child : t.children) {
+                        child = base[child];
+                    }
                 }
-                
-                ecs->addComponent(entity, transform);
             }
+            ecs->addComponents(targets, out);
+        }
+        
+        addBlock(ecs, tags, ids, count);
+        addBlock(ecs, layers, ids, count);
+        addBlock(ecs, rigidBodies, ids, count);
+        addBlock(ecs, colliders, ids, count);
+        
+        return roots;
+    }
+    
+private:
+    // Prototype components of one type and the node each belongs to
+    template<typename T>
+    struct Block {
+        std::vector<uint32_t> nodes;
+        std::vector<T> values;
+        
+        void add(uint32_t node, T value) {
+            nodes.push_back(node);
+            values.push_back(std::move(value));
+        }
+    };
+    
+    std::vector<uint32_t> parents;  // Per node; NO_PARENT for the root
+    Block<Transform> transforms;    // children hold node indices until remapped
+    Block<Tag> tags;
+    Block<Layer> layers;
+    Block<RigidBody> rigidBodies;
+    Block<Collider> colliders;
+    
+    template<typename T>
+    static void expand(const Block<T>& block, const std::vector<EntityID>& ids, size_t count,
+                       std::vector<EntityID>& targets, std::vector<T>& out) {
+        const size_t nodes = ids.size() / count;
+        targets.reserve(count * block.nodes.size());
+        out.reserve(count * block.values.size());
+        for (size_t c = 0; c < count; ++c) {
+            for (uint32_t node : block.nodes) {
+                targets.push_back(ids[c * nodes + node]);
+            }
+            out.insert(out.end(), block.values.begin(), block.values.end());
+        }
+    }
+    
+    template<typename T>
+    static void addBlock(ECS* ecs, const Block<T>& block, const std::vector<EntityID>& ids, size_t count) {
+        if (block.values.empty()) return;
+        std::vector<EntityID> targets;
+        std::vector<T> out;
+        expand(block, ids, count, targets, out);
+        ecs->addComponents(targets, out);
+    }
+    
+    static glm::vec3 readVec3(const json& v) {
+        return glm::vec3(v[0].get<float>(), v[1].get<float>(), v[2].get<float>());
+    }
+    
+    // Flatten one prefab document (and its children) into nodes. overrides
+    // is the referencing entry of a nested prefab: its position, rotation
+    // and scale replace those of the nested root.
+    bool addNode(const json& data, uint32_t parent, const json* overrides,
+                 const Resolver& resolve, std::vector<std::string>& stack) {
+        uint32_t node = static_cast<uint32_t>(parents.size());
+        parents.push_back(parent);
+        
+        const json empty = json::object();
+        const json& components = data.contains("components") ? data["components"] : empty;
+        
+        // Children always get a Transform so they can link to their parent
+        size_t transformIndex = SIZE_MAX;
+        if (components.contains("transform") || parent != NO_PARENT) {
+            Transform transform;
+            const json& t = components.contains("transform") ? components["transform"] : empty;
             
-            // Tag
-            if (components.contains("tag")) {
-                Tag tag(components["tag"].get<std::string>());
-                ecs->addComponent(entity, tag);
+            if (t.contains("position")) transform.position = readVec3(t["position"]);
+            if (t.contains("rotation")) transform.setEulerAngles(readVec3(t["rotation"]));
+            if (t.contains("scale")) transform.scale = readVec3(t["scale"]);
+            
+            if (overrides) {
+                if (overrides->contains("position")) transform.position = readVec3((*overrides)["position"]);
+                if (overrides->contains("rotation")) transform.setEulerAngles(readVec3((*overrides)["rotation"]));
+                if (overrides->contains("scale")) transform.scale = readVec3((*overrides)["scale"]);
             }
             
-            // Layer
-            if (components.contains("layer")) {
-                Layer layer;
-                layer.mask = components["layer"].get<uint32_t>();
-                ecs->addComponent(entity, layer);
+            transformIndex = transforms.values.size();
+            transforms.add(node, transform);
+        }
+        
+        if (components.contains("tag")) {
+            tags.add(node, Tag(components["tag"].get<std::string>()));
+        }
+        
+        if (components.contains("layer")) {
+            Layer layer;
+            layer.mask = components["layer"].get<uint32_t>();
+            layers.add(node, layer);
+        }
+        
+        if (components.contains("rigidbody")) {
+            RigidBody rb;
+            auto& rbData = components["rigidbody"];
+            
+            if (rbData.contains("mass")) rb.mass = rbData["mass"];
+            if (rbData.contains("drag")) rb.drag = rbData["drag"];
+            if (rbData.contains("useGravity")) rb.useGravity = rbData["useGravity"];
+            if (rbData.contains("isKinematic")) rb.isKinematic = rbData["isKinematic"];
+            
+            rigidBodies.add(node, rb);
+        }
+        
+        if (components.contains("collider")) {
+            Collider collider;
+            auto& colData = components["collider"];
+            
+            if (colData.contains("type")) {
+                std::string typeStr = colData["type"];
+                if (typeStr == "box") collider.type = ColliderType::Box;
+                else if (typeStr == "sphere") collider.type = ColliderType::Sphere;
+                else if (typeStr == "capsule") collider.type = ColliderType::Capsule;
+                else if (typeStr == "mesh") collider.type = ColliderType::Mesh;
             }
             
-            // RigidBody
-            if (components.contains("rigidbody")) {
-                RigidBody rb;
-                auto& rbData = components["rigidbody"];
-                
-                if (rbData.contains("mass")) rb.mass = rbData["mass"];
-                if (rbData.contains("drag")) rb.drag = rbData["drag"];
-                if (rbData.contains("useGravity")) rb.useGravity = rbData["useGravity"];
-                if (rbData.contains("isKinematic")) rb.isKinematic = rbData["isKinematic"];
-                
-                ecs->addComponent(entity, rb);
+            if (colData.contains("size")) collider.size = readVec3(colData["size"]);
+            if (colData.contains("radius")) collider.radius = colData["radius"];
+            if (colData.contains("isTrigger")) collider.isTrigger = colData["isTrigger"];
+            
+            colliders.add(node, collider);
+        }
+        
+        if (!data.contains("children")) return true;
+        
+        // Child nodes: inline documents, or {"prefab": "<name>", position/rotation/scale}
+        std::vector<uint32_t> childNodes;
+        for (const json& child : data["children"]) {
+            childNodes.push_back(static_cast<uint32_t>(parents.size()));
+            
+            if (!child.contains("prefab")) {
+                if (!addNode(child, node, nullptr, resolve, stack)) return false;
+                continue;
             }
             
-            // Collider
-            if (components.contains("collider")) {
-                Collider collider;
-                auto& colData = components["collider"];
-                
-                if (colData.contains("type")) {
-                    std::string typeStr = colData["type"];
-                    if (typeStr == "box") collider.type = ColliderType::Box;
-                    else if (typeStr == "sphere") collider.type = ColliderType::Sphere;
-                    else if (typeStr == "capsule") collider.type = ColliderType::Capsule;
-                }
-                
-                if (colData.contains("size")) {
-                    auto& s = colData["size"];
-                    collider.size = glm::vec3(s[0], s[1], s[2]);
-                }
-                
-                if (colData.contains("radius")) {
-                    collider.radius = colData["radius"];
-                }
-                
-                if (colData.contains("isTrigger")) {
-                    collider.isTrigger = colData["isTrigger"];
-                }
-                
-                ecs->addComponent(entity, collider);
+            std::string ref = child["prefab"];
+            if (std::find(stack.begin(), stack.end(), ref) != stack.end() ||
+                static_cast<int>(stack.size()) >= MAX_NESTING) {
+                std::cerr << "Prefab " << name << ": recursive or too deeply nested reference to " << ref << std::endl;
+                return false;
             }
+            
+            const json* nested = resolve ? resolve(ref) : nullptr;
+            if (!nested) {
+                std::cerr << "Prefab " << name << ": nested prefab not found: " << ref << std::endl;
+                return false;
+            }
+            
+            stack.push_back(ref);
+            bool ok = addNode(*nested, node, &child, resolve, stack);
+            stack.pop_back();
+            if (!ok) return false;
         }
         
-        return entity;
+        if (transformIndex != SIZE_MAX) {
+            transforms.values[transformIndex].children.assign(childNodes.begin(), childNodes.end());
+        }
+        
+        return true;
+    }
+};
+
+// Prefab - reusable entity template
+class Prefab {
+public:
+    std::string name;
+    json data;
+    
+    Prefab() = default;
+    Prefab(const std::string& n) : name(n) {}
+    
+    // Build the binary template. Nested prefabs are names registered with
+    // or loadable by a PrefabManager, looked up through resolve (see
+    // PrefabManager::resolver()); without one they can't be found. Call
+    // again after editing data.
+    bool compile(const CompiledPrefab::Resolver& resolve = nullptr) {
+        compiled = CompiledPrefab::compile(data, resolve);
+        return compiled != nullptr;
+    }
+    
+    std::shared_ptr<const CompiledPrefab> getCompiled() const { return compiled; }
+    
+    // Create entity from this prefab (compiles on first use)
+    EntityID instantiate(ECS* ecs, glm::vec3 position = glm::vec3(0), glm::quat rotation = glm::quat(1,0,0,0)) {
+        if (!compiled && !compile()) return 0;
+        return compiled->instantiate(ecs, position, rotation);
+    }
+    
+    // Create one copy per position in a single batch
+    std::vector<EntityID> instantiate(ECS* ecs, const std::vector<glm::vec3>& positions,
+                                      glm::quat rotation = glm::quat(1,0,0,0)) {
+        if (!compiled && !compile()) return {};
+        return compiled->instantiate(ecs, positions, rotation);
     }
     
     // Load prefab from JSON file
     static Prefab load(const std::string& path) {
         Prefab prefab;
         
-        std::ifstream file(path);
-        if (!file.is_open()) {
+        std::string text;
+        if (!VFS::readText(path, text)) {
             std::cerr << "Failed to open prefab file: " << path << std::endl;
             return prefab;
         }
+        std::istringstream file(text);
         
         try {
             file >> prefab.data;
@@ -142,6 +351,9 @@ public:
             return false;
         }
     }
+    
+private:
+    std::shared_ptr<const CompiledPrefab> compiled;
 };
 
 // Entity serialization helpers
@@ -197,6 +409,7 @@ namespace EntitySerializer {
                 case ColliderType::Box: colJson["type"] = "box"; break;
                 case ColliderType::Sphere: colJson["type"] = "sphere"; break;
                 case ColliderType::Capsule: colJson["type"] = "capsule"; break;
+                case ColliderType::Mesh: colJson["type"] = "mesh"; break;
             }
             
             colJson["size"] = {col->size.x, col->size.y, col->size.z};
@@ -285,6 +498,7 @@ namespace EntitySerializer {
                 if (typeStr == "box") collider.type = ColliderType::Box;
                 else if (typeStr == "sphere") collider.type = ColliderType::Sphere;
                 else if (typeStr == "capsule") collider.type = ColliderType::Capsule;
+                else if (typeStr == "mesh") collider.type = ColliderType::Mesh;
             }
             
             if (colData.contains("size")) {
@@ -337,11 +551,12 @@ namespace EntitySerializer {
     
     // Load scene from file
     inline bool loadScene(ECS* ecs, const std::string& path) {
-        std::ifstream file(path);
-        if (!file.is_open()) {
+        std::string text;
+        if (!VFS::readText(path, text)) {
             std::cerr << "Failed to load scene from: " << path << std::endl;
             return false;
         }
+        std::istringstream file(text);
         
         try {
             json scene;
@@ -366,6 +581,9 @@ namespace EntitySerializer {
 }
 
 // Prefab manager for caching prefabs
+//
+// Prefabs are compiled when loaded or registered, so instantiating through
+// the manager during gameplay never parses JSON.
 class PrefabManager {
     std::unordered_map<std::string, Prefab> prefabs;
     std::string baseDir = "prefabs/";
@@ -375,24 +593,15 @@ public:
         baseDir = dir;
     }
     
-    // Load and cache prefab
+    // Load, compile and cache prefab
     Prefab* load(const std::string& name) {
-        // Check cache
-        auto it = prefabs.find(name);
-        if (it != prefabs.end()) {
-            return &it->second;
-        }
-        
-        // Load from file
-        std::string path = baseDir + name + ".json";
-        Prefab prefab = Prefab::load(path);
+        Prefab* prefab = fetch(name);
+        if (!prefab) return nullptr;
         
-        if (prefab.data.empty()) {
+        if (!prefab->getCompiled() && !prefab->compile(resolver())) {
             return nullptr;
         }
-        
-        prefabs[name] = std::move(prefab);
-        return &prefabs[name];
+        return prefab;
     }
     
     // Get cached prefab
@@ -403,24 +612,62 @@ public:
     
     // Create entity from cached prefab
     EntityID instantiate(ECS* ecs, const std::string& name, glm::vec3 position = glm::vec3(0)) {
-        Prefab* prefab = get(name);
-        if (!prefab) {
-            prefab = load(name);
-        }
-        
-        if (prefab) {
+        if (Prefab* prefab = load(name)) {
             return prefab->instantiate(ecs, position);
         }
         
         return 0;
     }
     
-    // Register prefab programmatically
-    void registerPrefab(const std::string& name, const Prefab& prefab) {
-        prefabs[name] = prefab;
+    // Create one copy per position in a single batch (volleys, debris bursts)
+    std::vector<EntityID> instantiate(ECS* ecs, const std::string& name, const std::vector<glm::vec3>& positions) {
+        if (Prefab* prefab = load(name)) {
+            return prefab->instantiate(ecs, positions);
+        }
+        
+        return {};
+    }
+    
+    // Register prefab programmatically. False (and nothing registered) if
+    // it doesn't compile.
+    bool registerPrefab(const std::string& name, const Prefab& prefab) {
+        Prefab registered = prefab;
+        if (!registered.compile(resolver())) {
+            std::cerr << "Failed to register prefab: " << name << std::endl;
+            return false;
+        }
+        prefabs[name] = std::move(registered);
+        return true;
+    }
+    
+    // Looks nested references up by the same names as load(), for compiling
+    // prefabs edited outside the manager
+    CompiledPrefab::Resolver resolver() {
+        return [this](const std::string& ref) -> const json* {
+            Prefab* nested = fetch(ref);
+            return nested ? &nested->data : nullptr;
+        };
     }
     
     void clear() {
         prefabs.clear();
     }
+    
+private:
+    // Cached or freshly read prefab, not necessarily compiled yet
+    Prefab* fetch(const std::string& name) {
+        auto it = prefabs.find(name);
+        if (it != prefabs.end()) {
+            return &it->second;
+        }
+        
+        std::string path = baseDir + name + ".json";
+        Prefab prefab = Prefab::load(path);
+        
+        if (prefab.data.empty()) {
+            return nullptr;
+        }
+        
+        return &prefabs.emplace(name, std::move(prefab)).first->second;
+    }
 };
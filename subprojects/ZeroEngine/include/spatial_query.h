@@ -1,11 +1,19 @@
 #pragma once
 #include "Engine.h"
 #include "transform.h"
+#include "tags.h"
 #include "PhysicsSystem.h"
+#include "SpatialIndex.h"
 #include <glm/glm.hpp>
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <thread>
+#include <cstdint>
+#include <string>
+#include <utility>
 
 // Raycast hit result
 struct RaycastHit {
@@ -22,52 +30,82 @@ struct RaycastHit {
     }
 };
 
+// One ray of a batch query
+struct Ray {
+    glm::vec3 origin{0};
+    glm::vec3 direction{0, 0, -1};
+    float maxDistance = 1000.0f;
+    uint32_t layerMask = 0xFFFFFFFF;
+};
+
+// Flattened results of a batched overlap: query i owns
+// entities[offsets[i] .. offsets[i + 1])
+struct OverlapBatchResult {
+    std::vector<EntityID> entities;
+    std::vector<uint32_t> offsets;
+    
+    size_t count(size_t query) const { return offsets[query + 1] - offsets[query]; }
+    const EntityID* begin(size_t query) const { return entities.data() + offsets[query]; }
+    const EntityID* end(size_t query) const { return entities.data() + offsets[query + 1]; }
+};
+
 // Spatial query system
+//
+// Queries run against a per-ECS SpatialIndex (a dynamic AABB tree for
+// shapes, a hash grid for proximity) once update() has been called for
+// that ECS; otherwise they fall back to a linear scan. The index reflects
+// the ECS as of the last update(). The out-parameter overloads reuse the
+// caller's vector, so hot paths can query without allocating.
 class SpatialQuery {
 public:
+    // === Acceleration ===
+    
+    // Refresh the index for this ECS. Call once per frame before the
+    // systems that query it.
+    static void update(ECS* ecs) {
+        auto& index = indices[ecs];
+        if (!index) index = std::make_unique<SpatialIndex>();
+        index->sync(ecs);
+    }
+    
+    // Drop the index (call before the ECS is destroyed)
+    static void release(ECS* ecs) {
+        indices.erase(ecs);
+    }
+    
+    static SpatialIndex* getIndex(ECS* ecs) {
+        auto it = indices.find(ecs);
+        return it != indices.end() ? it->second.get() : nullptr;
+    }
+    
+    // === Raycasts ===
+    
     // Raycast against all colliders
-    static RaycastHit raycast(ECS* ecs, glm::vec3 origin, glm::vec3 direction, 
+    static RaycastHit raycast(ECS* ecs, glm::vec3 origin, glm::vec3 direction,
                              float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF) {
         direction = glm::normalize(direction);
         RaycastHit closestHit;
         closestHit.distance = maxDistance;
         
+        if (SpatialIndex* index = getIndex(ecs)) {
+            index->getTree().raycast(origin, direction, maxDistance, layerMask, SpatialIndex::HAS_COLLIDER,
+                [&](EntityID entity, int32_t, float maxT) {
+                    RaycastHit hit;
+                    if (rayEntity(ecs, entity, origin, direction, maxT, hit) && hit.distance < closestHit.distance) {
+                        closestHit = hit;
+                        return hit.distance;
+                    }
+                    return maxT;
+                });
+            return closestHit;
+        }
+        
         // Check all entities with colliders
         for (size_t i = 0; i < 10000; ++i) {
-            auto* transform = ecs->getComponent<Transform>(i);
-            auto* collider = ecs->getComponent<Collider>(i);
-            auto* layer = ecs->getComponent<Layer>(i);
-            
-            if (!transform || !collider) continue;
-            
-            // Layer mask filter
-            if (layer && !(layer->mask & layerMask)) continue;
+            if (!passesLayer(ecs, i, layerMask)) continue;
             
             RaycastHit hit;
-            hit.entity = i;
-            
-            // Ray-collider intersection
-            bool intersects = false;
-            
-            switch (collider->type) {
-                case ColliderType::Sphere:
-                    intersects = raySphere(origin, direction, transform->position, 
-                                          collider->radius, hit);
-                    break;
-                    
-                case ColliderType::Box:
-                    intersects = rayBox(origin, direction, transform->position,
-                                       collider->size * transform->scale, hit);
-                    break;
-                    
-                case ColliderType::Capsule:
-                    // Simplified capsule as sphere for now
-                    intersects = raySphere(origin, direction, transform->position,
-                                          collider->radius, hit);
-                    break;
-            }
-            
-            if (intersects && hit.distance < closestHit.distance && hit.distance <= maxDistance) {
+            if (rayEntity(ecs, i, origin, direction, maxDistance, hit) && hit.distance < closestHit.distance) {
                 closestHit = hit;
             }
         }
@@ -75,202 +113,630 @@ public:
         return closestHit;
     }
     
-    // Raycast returning all hits
-    static std::vector<RaycastHit> raycastAll(ECS* ecs, glm::vec3 origin, glm::vec3 direction,
-                                               float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF) {
+    // Raycast returning all hits, sorted by distance
+    static void raycastAll(ECS* ecs, glm::vec3 origin, glm::vec3 direction, std::vector<RaycastHit>& hits,
+                           float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF) {
         direction = glm::normalize(direction);
-        std::vector<RaycastHit> hits;
+        hits.clear();
         
-        for (size_t i = 0; i < 10000; ++i) {
-            auto* transform = ecs->getComponent<Transform>(i);
-            auto* collider = ecs->getComponent<Collider>(i);
-            auto* layer = ecs->getComponent<Layer>(i);
-            
-            if (!transform || !collider) continue;
-            if (layer && !(layer->mask & layerMask)) continue;
-            
-            RaycastHit hit;
-            hit.entity = i;
-            
-            bool intersects = false;
-            
-            switch (collider->type) {
-                case ColliderType::Sphere:
-                    intersects = raySphere(origin, direction, transform->position,
-                                          collider->radius, hit);
-                    break;
-                case ColliderType::Box:
-                    intersects = rayBox(origin, direction, transform->position,
-                                       collider->size * transform->scale, hit);
-                    break;
-                case ColliderType::Capsule:
-                    intersects = raySphere(origin, direction, transform->position,
-                                          collider->radius, hit);
-                    break;
-            }
-            
-            if (intersects && hit.distance <= maxDistance) {
-                hits.push_back(hit);
+        if (SpatialIndex* index = getIndex(ecs)) {
+            index->getTree().raycast(origin, direction, maxDistance, layerMask, SpatialIndex::HAS_COLLIDER,
+                [&](EntityID entity, int32_t, float maxT) {
+                    RaycastHit hit;
+                    if (rayEntity(ecs, entity, origin, direction, maxDistance, hit)) {
+                        hits.push_back(hit);
+                    }
+                    return maxT;
+                });
+        } else {
+            for (size_t i = 0; i < 10000; ++i) {
+                if (!passesLayer(ecs, i, layerMask)) continue;
+                
+                RaycastHit hit;
+                if (rayEntity(ecs, i, origin, direction, maxDistance, hit)) {
+                    hits.push_back(hit);
+                }
             }
         }
         
         // Sort by distance
         std::sort(hits.begin(), hits.end());
-        
+    }
+    
+    static std::vector<RaycastHit> raycastAll(ECS* ecs, glm::vec3 origin, glm::vec3 direction,
+                                               float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF) {
+        std::vector<RaycastHit> hits;
+        raycastAll(ecs, origin, direction, hits, maxDistance, layerMask);
         return hits;
     }
     
-    // Overlap sphere - find all colliders in radius
-    static std::vector<EntityID> overlapSphere(ECS* ecs, glm::vec3 center, float radius,
-                                                uint32_t layerMask = 0xFFFFFFFF) {
-        std::vector<EntityID> results;
-        float radiusSq = radius * radius;
+    // === Batches ===
+    
+    // Closest hit for each ray (hits[i] answers rays[i]). Rays are sorted into
+    // coherent 8-ray packets (direction octant, then Morton order of origin)
+    // that traverse the BVH together. threads > 1 splits the packets across
+    // worker threads (0 = hardware concurrency); the ECS must not be modified
+    // while the batch runs.
+    static void raycastBatch(ECS* ecs, const Ray* rays, RaycastHit* hits, size_t count, unsigned threads = 1) {
+        if (count == 0) return;
         
-        for (size_t i = 0; i < 10000; ++i) {
-            auto* transform = ecs->getComponent<Transform>(i);
-            auto* collider = ecs->getComponent<Collider>(i);
-            auto* layer = ecs->getComponent<Layer>(i);
-            
-            if (!transform || !collider) continue;
-            if (layer && !(layer->mask & layerMask)) continue;
-            
-            bool overlaps = false;
+        SpatialIndex* index = getIndex(ecs);
+        if (!index) {
+            for (size_t i = 0; i < count; ++i) {
+                hits[i] = raycast(ecs, rays[i].origin, rays[i].direction, rays[i].maxDistance, rays[i].layerMask);
+            }
+            return;
+        }
+        
+        std::vector<uint32_t> order = coherentOrder(rays, count);
+        const DynamicAABBTree& tree = index->getTree();
+        constexpr size_t P = DynamicAABBTree::PACKET_SIZE;
+        size_t packetCount = (count + P - 1) / P;
+        
+        parallelFor(packetCount, threads, [&](size_t first, size_t last) {
+            glm::vec3 origins[P], directions[P];
+            float maxDistances[P];
+            uint32_t masks[P];
             
-            switch (collider->type) {
-                case ColliderType::Sphere: {
-                    float dist = glm::distance(center, transform->position);
-                    overlaps = dist < (radius + collider->radius);
-                    break;
+            for (size_t packet = first; packet < last; ++packet) {
+                size_t base = packet * P;
+                int lanes = static_cast<int>(std::min(P, count - base));
+                
+                for (int lane = 0; lane < lanes; ++lane) {
+                    const Ray& ray = rays[order[base + lane]];
+                    origins[lane] = ray.origin;
+                    directions[lane] = glm::normalize(ray.direction);
+                    maxDistances[lane] = ray.maxDistance;
+                    masks[lane] = ray.layerMask;
+                    
+                    RaycastHit& hit = hits[order[base + lane]];
+                    hit = RaycastHit();
+                    hit.distance = ray.maxDistance;
                 }
-                case ColliderType::Box: {
-                    // Sphere-box overlap (simplified)
-                    glm::vec3 halfExtents = collider->size * transform->scale * 0.5f;
-                    glm::vec3 closestPoint = glm::clamp(center, 
-                                                        transform->position - halfExtents,
-                                                        transform->position + halfExtents);
-                    float distSq = glm::distance2(center, closestPoint);
-                    overlaps = distSq < radiusSq;
-                    break;
+                
+                if (isCoherent(origins, directions, maxDistances, lanes)) {
+                    tree.raycastPacket(origins, directions, maxDistances, masks, lanes, SpatialIndex::HAS_COLLIDER,
+                        [&](int lane, EntityID entity, int32_t, float maxT) {
+                            RaycastHit hit;
+                            RaycastHit& best = hits[order[base + lane]];
+                            if (rayEntity(ecs, entity, origins[lane], directions[lane], maxT, hit) &&
+                                hit.distance < best.distance) {
+                                best = hit;
+                                return hit.distance;
+                            }
+                            return maxT;
+                        });
+                    continue;
                 }
-                case ColliderType::Capsule: {
-                    float dist = glm::distance(center, transform->position);
-                    overlaps = dist < (radius + collider->radius);
-                    break;
+                
+                // Divergent packet: the shared walk would visit the union of every
+                // ray's path, so trace lanes one by one
+                for (int lane = 0; lane < lanes; ++lane) {
+                    RaycastHit& best = hits[order[base + lane]];
+                    tree.raycast(origins[lane], directions[lane], maxDistances[lane], masks[lane],
+                                 SpatialIndex::HAS_COLLIDER,
+                        [&](EntityID entity, int32_t, float maxT) {
+                            RaycastHit hit;
+                            if (rayEntity(ecs, entity, origins[lane], directions[lane], maxT, hit) &&
+                                hit.distance < best.distance) {
+                                best = hit;
+                                return hit.distance;
+                            }
+                            return maxT;
+                        });
                 }
             }
-            
-            if (overlaps) {
-                results.push_back(i);
-            }
-        }
-        
+        });
+    }
+    
+    static void raycastBatch(ECS* ecs, const std::vector<Ray>& rays, std::vector<RaycastHit>& hits,
+                             unsigned threads = 1) {
+        hits.resize(rays.size());
+        raycastBatch(ecs, rays.data(), hits.data(), rays.size(), threads);
+    }
+    
+    // overlapSphere for many spheres at once
+    static void overlapSphereBatch(ECS* ecs, const glm::vec3* centers, const float* radii, size_t count,
+                                   OverlapBatchResult& result, uint32_t layerMask = 0xFFFFFFFF,
+                                   unsigned threads = 1) {
+        overlapBatch(count, result, threads, [&](size_t i, std::vector<EntityID>& out) {
+            appendOverlapSphere(ecs, centers[i], radii[i], out, layerMask);
+        });
+    }
+    
+    // overlapBox for many boxes at once
+    static void overlapBoxBatch(ECS* ecs, const glm::vec3* centers, const glm::vec3* halfExtents, size_t count,
+                                OverlapBatchResult& result, uint32_t layerMask = 0xFFFFFFFF,
+                                unsigned threads = 1) {
+        overlapBatch(count, result, threads, [&](size_t i, std::vector<EntityID>& out) {
+            appendOverlapBox(ecs, centers[i], halfExtents[i], out, layerMask);
+        });
+    }
+    
+    // === Overlaps ===
+    
+    // Overlap sphere - find all colliders in radius
+    static void overlapSphere(ECS* ecs, glm::vec3 center, float radius, std::vector<EntityID>& results,
+                              uint32_t layerMask = 0xFFFFFFFF) {
+        results.clear();
+        appendOverlapSphere(ecs, center, radius, results, layerMask);
+    }
+    
+    static std::vector<EntityID> overlapSphere(ECS* ecs, glm::vec3 center, float radius,
+                                                uint32_t layerMask = 0xFFFFFFFF) {
+        std::vector<EntityID> results;
+        overlapSphere(ecs, center, radius, results, layerMask);
         return results;
     }
     
     // Overlap box - find all colliders in box
+    static void overlapBox(ECS* ecs, glm::vec3 center, glm::vec3 halfExtents, std::vector<EntityID>& results,
+                           uint32_t layerMask = 0xFFFFFFFF) {
+        results.clear();
+        appendOverlapBox(ecs, center, halfExtents, results, layerMask);
+    }
+    
     static std::vector<EntityID> overlapBox(ECS* ecs, glm::vec3 center, glm::vec3 halfExtents,
                                             uint32_t layerMask = 0xFFFFFFFF) {
         std::vector<EntityID> results;
-        
-        for (size_t i = 0; i < 10000; ++i) {
-            auto* transform = ecs->getComponent<Transform>(i);
-            auto* collider = ecs->getComponent<Collider>(i);
-            auto* layer = ecs->getComponent<Layer>(i);
-            
-            if (!transform || !collider) continue;
-            if (layer && !(layer->mask & layerMask)) continue;
-            
-            bool overlaps = false;
-            
-            switch (collider->type) {
-                case ColliderType::Sphere: {
-                    // Box-sphere overlap
-                    glm::vec3 closestPoint = glm::clamp(transform->position,
-                                                        center - halfExtents,
-                                                        center + halfExtents);
-                    float distSq = glm::distance2(transform->position, closestPoint);
-                    overlaps = distSq < (collider->radius * collider->radius);
-                    break;
-                }
-                case ColliderType::Box: {
-                    // Box-box overlap (AABB test)
-                    glm::vec3 otherHalf = collider->size * transform->scale * 0.5f;
-                    glm::vec3 min1 = center - halfExtents;
-                    glm::vec3 max1 = center + halfExtents;
-                    glm::vec3 min2 = transform->position - otherHalf;
-                    glm::vec3 max2 = transform->position + otherHalf;
-                    
-                    overlaps = (min1.x <= max2.x && max1.x >= min2.x) &&
-                              (min1.y <= max2.y && max1.y >= min2.y) &&
-                              (min1.z <= max2.z && max1.z >= min2.z);
-                    break;
-                }
-                case ColliderType::Capsule: {
-                    glm::vec3 closestPoint = glm::clamp(transform->position,
-                                                        center - halfExtents,
-                                                        center + halfExtents);
-                    float distSq = glm::distance2(transform->position, closestPoint);
-                    overlaps = distSq < (collider->radius * collider->radius);
-                    break;
-                }
-            }
-            
-            if (overlaps) {
-                results.push_back(i);
-            }
-        }
-        
+        overlapBox(ecs, center, halfExtents, results, layerMask);
         return results;
     }
     
+    // === Proximity ===
+    
     // Find closest entity to point
     static EntityID findClosest(ECS* ecs, glm::vec3 point, float maxDistance = 1000.0f,
                                 uint32_t layerMask = 0xFFFFFFFF) {
-        EntityID closest = 0;
-        float closestDistSq = maxDistance * maxDistance;
+        std::vector<EntityID>& results = closestScratch();
+        nearestImpl(ecs, point, 1, maxDistance, layerMask, nullptr, results);
+        return results.empty() ? 0 : results[0];
+    }
+    
+    // Find closest entity whose Tag matches
+    static EntityID findClosestWithTag(ECS* ecs, glm::vec3 point, Name tag,
+                                       float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF) {
+        std::vector<EntityID>& results = closestScratch();
+        nearestImpl(ecs, point, 1, maxDistance, layerMask, &tag, results);
+        return results.empty() ? 0 : results[0];
+    }
+    
+    // Find the k closest entities, nearest first
+    static void findKNearest(ECS* ecs, glm::vec3 point, size_t k, std::vector<EntityID>& results,
+                             float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF) {
+        nearestImpl(ecs, point, k, maxDistance, layerMask, nullptr, results);
+    }
+    
+    static std::vector<EntityID> findKNearest(ECS* ecs, glm::vec3 point, size_t k,
+                                              float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF) {
+        std::vector<EntityID> results;
+        findKNearest(ecs, point, k, results, maxDistance, layerMask);
+        return results;
+    }
+    
+    // Find all entities within distance
+    static void findInRadius(ECS* ecs, glm::vec3 center, float radius, std::vector<EntityID>& results,
+                             uint32_t layerMask = 0xFFFFFFFF) {
+        radiusImpl(ecs, center, radius, layerMask, nullptr, results);
+    }
+    
+    static std::vector<EntityID> findInRadius(ECS* ecs, glm::vec3 center, float radius,
+                                              uint32_t layerMask = 0xFFFFFFFF) {
+        std::vector<EntityID> results;
+        findInRadius(ecs, center, radius, results, layerMask);
+        return results;
+    }
+    
+    // Find all entities within distance whose Tag matches
+    static void findInRadiusWithTag(ECS* ecs, glm::vec3 center, float radius, Name tag,
+                                    std::vector<EntityID>& results, uint32_t layerMask = 0xFFFFFFFF) {
+        radiusImpl(ecs, center, radius, layerMask, &tag, results);
+    }
+    
+    static std::vector<EntityID> findInRadiusWithTag(ECS* ecs, glm::vec3 center, float radius,
+                                                     Name tag, uint32_t layerMask = 0xFFFFFFFF) {
+        std::vector<EntityID> results;
+        findInRadiusWithTag(ecs, center, radius, tag, results, layerMask);
+        return results;
+    }
+    
+    // Grid cell size for proximity queries; roughly the common query radius works best
+    static void setProximityCellSize(ECS* ecs, float cellSize) {
+        auto& index = indices[ecs];
+        if (!index) index = std::make_unique<SpatialIndex>();
+        index->getGrid().setCellSize(cellSize);
+    }
+
+private:
+    static inline std::unordered_map<ECS*, std::unique_ptr<SpatialIndex>> indices;
+    
+    static void appendOverlapSphere(ECS* ecs, glm::vec3 center, float radius, std::vector<EntityID>& results,
+                                    uint32_t layerMask) {
+        if (SpatialIndex* index = getIndex(ecs)) {
+            AABB bounds{center - glm::vec3(radius), center + glm::vec3(radius)};
+            index->getTree().query(bounds, layerMask, SpatialIndex::HAS_COLLIDER,
+                [&](EntityID entity, int32_t) {
+                    if (sphereEntity(ecs, entity, center, radius)) results.push_back(entity);
+                    return true;
+                });
+            return;
+        }
         
         for (size_t i = 0; i < 10000; ++i) {
-            auto* transform = ecs->getComponent<Transform>(i);
-            auto* layer = ecs->getComponent<Layer>(i);
-            
-            if (!transform) continue;
-            if (layer && !(layer->mask & layerMask)) continue;
-            
-            float distSq = glm::distance2(point, transform->position);
-            if (distSq < closestDistSq) {
-                closestDistSq = distSq;
-                closest = i;
+            if (!passesLayer(ecs, i, layerMask)) continue;
+            if (sphereEntity(ecs, i, center, radius)) results.push_back(i);
+        }
+    }
+    
+    static void appendOverlapBox(ECS* ecs, glm::vec3 center, glm::vec3 halfExtents, std::vector<EntityID>& results,
+                                 uint32_t layerMask) {
+        if (SpatialIndex* index = getIndex(ecs)) {
+            AABB bounds{center - halfExtents, center + halfExtents};
+            index->getTree().query(bounds, layerMask, SpatialIndex::HAS_COLLIDER,
+                [&](EntityID entity, int32_t) {
+                    if (boxEntity(ecs, entity, center, halfExtents)) results.push_back(entity);
+                    return true;
+                });
+            return;
+        }
+        
+        for (size_t i = 0; i < 10000; ++i) {
+            if (!passesLayer(ecs, i, layerMask)) continue;
+            if (boxEntity(ecs, i, center, halfExtents)) results.push_back(i);
+        }
+    }
+    
+    // Run fn(first, last) over [0, count), split into contiguous ranges per thread
+    template<typename Fn>
+    static void parallelFor(size_t count, unsigned threads, Fn&& fn) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+        
+        if (threads <= 1) {
+            fn(size_t(0), count);
+            return;
+        }
+        
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        size_t chunk = (count + threads - 1) / threads;
+        for (unsigned t = 1; t < threads; ++t) {
+            size_t first = t * chunk;
+            size_t last = std::min(count, first + chunk);
+            if (first >= last) break;
+            workers.emplace_back([&fn, first, last] { fn(first, last); });
+        }
+        fn(size_t(0), std::min(count, chunk));
+        for (auto& worker : workers) worker.join();
+    }
+    
+    // Per-thread result buffers, stitched into one flat result
+    template<typename Fn>
+    static void overlapBatch(size_t count, OverlapBatchResult& result, unsigned threads, Fn&& query) {
+        result.entities.clear();
+        result.offsets.assign(count + 1, 0);
+        if (count == 0) return;
+        
+        std::vector<uint32_t> counts(count);
+        std::vector<std::vector<EntityID>> partial;
+        std::vector<size_t> partialStart;
+        
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+        size_t chunk = (count + threads - 1) / threads;
+        partial.resize(threads);
+        
+        parallelFor(count, threads, [&](size_t first, size_t last) {
+            std::vector<EntityID>& out = threads > 1 ? partial[first / chunk] : result.entities;
+            for (size_t i = first; i < last; ++i) {
+                size_t before = out.size();
+                query(i, out);
+                counts[i] = static_cast<uint32_t>(out.size() - before);
+            }
+        });
+        
+        for (size_t i = 0; i < count; ++i) {
+            result.offsets[i + 1] = result.offsets[i] + counts[i];
+        }
+        if (threads > 1) {
+            result.entities.reserve(result.offsets[count]);
+            for (auto& part : partial) {
+                result.entities.insert(result.entities.end(), part.begin(), part.end());
             }
         }
+    }
+    
+    // Rays worth traversing as one packet: close origins and similar directions
+    static bool isCoherent(const glm::vec3* origins, const glm::vec3* directions, const float* maxDistances,
+                           int lanes) {
+        if (lanes < 2) return false;
         
-        return closest;
+        glm::vec3 lo = origins[0], hi = origins[0];
+        float reach = maxDistances[0];
+        for (int i = 1; i < lanes; ++i) {
+            if (glm::dot(directions[i], directions[0]) < PACKET_MIN_COS) return false;
+            lo = glm::min(lo, origins[i]);
+            hi = glm::max(hi, origins[i]);
+            reach = std::min(reach, maxDistances[i]);
+        }
+        return glm::length(hi - lo) <= reach * PACKET_MAX_SPREAD;
     }
     
-    // Find all entities within distance
-    static std::vector<EntityID> findInRadius(ECS* ecs, glm::vec3 center, float radius,
-                                              uint32_t layerMask = 0xFFFFFFFF) {
-        std::vector<EntityID> results;
-        float radiusSq = radius * radius;
+    static constexpr float PACKET_MIN_COS = 0.95f;   // ~18 degrees between lanes
+    static constexpr float PACKET_MAX_SPREAD = 0.1f; // Origin spread relative to ray length
+    
+    // Spread the low 10 bits of v so they occupy every third bit
+    static uint32_t expandBits(uint32_t v) {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+    
+    // Ray indices grouped by direction octant, then by Morton code of the origin
+    static std::vector<uint32_t> coherentOrder(const Ray* rays, size_t count) {
+        glm::vec3 lo(std::numeric_limits<float>::max()), hi(-std::numeric_limits<float>::max());
+        for (size_t i = 0; i < count; ++i) {
+            lo = glm::min(lo, rays[i].origin);
+            hi = glm::max(hi, rays[i].origin);
+        }
+        glm::vec3 scale = 1023.0f / glm::max(hi - lo, glm::vec3(1e-6f));
+        
+        std::vector<std::pair<uint32_t, uint32_t>> keys(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Ray& ray = rays[i];
+            uint32_t octant = (ray.direction.x < 0 ? 1u : 0u) | (ray.direction.y < 0 ? 2u : 0u) |
+                              (ray.direction.z < 0 ? 4u : 0u);
+            glm::vec3 q = (ray.origin - lo) * scale;
+            uint32_t morton = (expandBits(uint32_t(q.x)) << 2) | (expandBits(uint32_t(q.y)) << 1) |
+                              expandBits(uint32_t(q.z));
+            keys[i] = {(octant << 29) | (morton >> 3), static_cast<uint32_t>(i)};
+        }
+        std::sort(keys.begin(), keys.end());
         
+        std::vector<uint32_t> order(count);
+        for (size_t i = 0; i < count; ++i) order[i] = keys[i].second;
+        return order;
+    }
+    
+    // Proximity queries use the hash grid when indexed, else scan entity IDs
+    static void radiusImpl(ECS* ecs, glm::vec3 center, float radius, uint32_t layerMask,
+                           const Name* tag, std::vector<EntityID>& results) {
+        results.clear();
+        
+        if (SpatialIndex* index = getIndex(ecs)) {
+            uint32_t tagId = SpatialHashGrid::NO_TAG;
+            if (tag) {
+                tagId = index->findTagId(*tag);
+                if (tagId == SpatialHashGrid::NO_TAG) return;
+            }
+            index->getGrid().queryRadius(center, radius, layerMask, tagId,
+                [&](EntityID entity, glm::vec3, float) { results.push_back(entity); });
+            return;
+        }
+        
+        float radiusSq = radius * radius;
         for (size_t i = 0; i < 10000; ++i) {
             auto* transform = ecs->getComponent<Transform>(i);
-            auto* layer = ecs->getComponent<Layer>(i);
-            
-            if (!transform) continue;
-            if (layer && !(layer->mask & layerMask)) continue;
+            if (!transform || !passesLayer(ecs, i, layerMask) || !passesTag(ecs, i, tag)) continue;
             
             float distSq = glm::distance2(center, transform->position);
             if (distSq <= radiusSq) {
                 results.push_back(i);
             }
         }
+    }
+    
+    static void nearestImpl(ECS* ecs, glm::vec3 point, size_t k, float maxDistance, uint32_t layerMask,
+                            const Name* tag, std::vector<EntityID>& results) {
+        results.clear();
+        thread_local std::vector<std::pair<float, EntityID>> candidates;
+        candidates.clear();
+        
+        if (SpatialIndex* index = getIndex(ecs)) {
+            uint32_t tagId = SpatialHashGrid::NO_TAG;
+            if (tag) {
+                tagId = index->findTagId(*tag);
+                if (tagId == SpatialHashGrid::NO_TAG) return;
+            }
+            index->getGrid().kNearest(point, k, maxDistance, layerMask, tagId, candidates);
+        } else {
+            float maxDistSq = maxDistance * maxDistance;
+            for (size_t i = 0; i < 10000; ++i) {
+                auto* transform = ecs->getComponent<Transform>(i);
+                if (!transform || !passesLayer(ecs, i, layerMask) || !passesTag(ecs, i, tag)) continue;
+                
+                float distSq = glm::distance2(point, transform->position);
+                if (distSq <= maxDistSq) candidates.push_back({distSq, static_cast<EntityID>(i)});
+            }
+            size_t n = std::min(k, candidates.size());
+            std::partial_sort(candidates.begin(), candidates.begin() + n, candidates.end());
+            candidates.resize(n);
+        }
         
+        for (const auto& candidate : candidates) results.push_back(candidate.second);
+    }
+    
+    static std::vector<EntityID>& closestScratch() {
+        thread_local std::vector<EntityID> results;
         return results;
     }
-
-private:
+    
+    static bool passesTag(ECS* ecs, EntityID entity, const Name* tag) {
+        if (!tag) return true;
+        auto* component = ecs->getComponent<Tag>(entity);
+        return component && component->id == *tag;
+    }
+    
+    static bool passesLayer(ECS* ecs, EntityID entity, uint32_t layerMask) {
+        auto* layer = ecs->getComponent<Layer>(entity);
+        return !layer || (layer->mask & layerMask);
+    }
+    
+    // Sphere/capsule radius scaled like the physics broadphase
+    static float scaledRadius(const Transform* transform, const Collider* collider) {
+        return collider->radius * glm::max(glm::max(transform->scale.x, transform->scale.y), transform->scale.z);
+    }
+    
+    // Ray against one entity's collider
+    static bool rayEntity(ECS* ecs, EntityID entity, glm::vec3 origin, glm::vec3 direction,
+                          float maxDistance, RaycastHit& hit) {
+        auto* transform = ecs->getComponent<Transform>(entity);
+        auto* collider = ecs->getComponent<Collider>(entity);
+        if (!transform || !collider) return false;
+        
+        hit.entity = entity;
+        bool intersects = false;
+        
+        switch (collider->type) {
+            case ColliderType::Sphere:
+                intersects = raySphere(origin, direction, transform->position,
+                                      scaledRadius(transform, collider), hit);
+                break;
+            
+            case ColliderType::Box:
+                intersects = rayBox(origin, direction, transform->position,
+                                   collider->size * transform->scale, hit);
+                break;
+            
+            case ColliderType::Capsule:
+                // Simplified capsule as sphere for now
+                intersects = raySphere(origin, direction, transform->position,
+                                      scaledRadius(transform, collider), hit);
+                break;
+            
+            case ColliderType::Mesh:
+                intersects = rayMesh(origin, direction, maxDistance, transform, collider, hit);
+                break;
+        }
+        
+        return intersects && hit.distance <= maxDistance;
+    }
+    
+    // Sphere against one entity's collider
+    static bool sphereEntity(ECS* ecs, EntityID entity, glm::vec3 center, float radius) {
+        auto* transform = ecs->getComponent<Transform>(entity);
+        auto* collider = ecs->getComponent<Collider>(entity);
+        if (!transform || !collider) return false;
+        
+        switch (collider->type) {
+            case ColliderType::Sphere:
+            case ColliderType::Capsule: {
+                float dist = glm::distance(center, transform->position);
+                return dist < (radius + scaledRadius(transform, collider));
+            }
+            case ColliderType::Box: {
+                // Sphere-box overlap (simplified)
+                glm::vec3 halfExtents = collider->size * transform->scale * 0.5f;
+                glm::vec3 closestPoint = glm::clamp(center,
+                                                    transform->position - halfExtents,
+                                                    transform->position + halfExtents);
+                return glm::distance2(center, closestPoint) < radius * radius;
+            }
+            case ColliderType::Mesh: {
+                glm::vec3 closestPoint;
+                return collider->mesh && closestPointOnMesh(center, radius, transform, collider, closestPoint);
+            }
+        }
+        return false;
+    }
+    
+    // Box against one entity's collider
+    static bool boxEntity(ECS* ecs, EntityID entity, glm::vec3 center, glm::vec3 halfExtents) {
+        auto* transform = ecs->getComponent<Transform>(entity);
+        auto* collider = ecs->getComponent<Collider>(entity);
+        if (!transform || !collider) return false;
+        
+        switch (collider->type) {
+            case ColliderType::Sphere:
+            case ColliderType::Capsule: {
+                // Box-sphere overlap
+                glm::vec3 closestPoint = glm::clamp(transform->position,
+                                                    center - halfExtents,
+                                                    center + halfExtents);
+                float radius = scaledRadius(transform, collider);
+                return glm::distance2(transform->position, closestPoint) < radius * radius;
+            }
+            case ColliderType::Box: {
+                // Box-box overlap (AABB test)
+                glm::vec3 otherHalf = collider->size * transform->scale * 0.5f;
+                AABB a{center - halfExtents, center + halfExtents};
+                AABB b{transform->position - otherHalf, transform->position + otherHalf};
+                return a.overlaps(b);
+            }
+            case ColliderType::Mesh:
+                return collider->mesh && boxMesh(center, halfExtents, transform, collider);
+        }
+        return false;
+    }
+    
+    static MeshPlacement placementOf(const Transform* transform) {
+        return MeshPlacement{transform->position, transform->rotation, transform->scale};
+    }
+    
+    // Ray against a mesh collider's triangles (BVH traversal)
+    static bool rayMesh(glm::vec3 origin, glm::vec3 direction, float maxDistance,
+                        const Transform* transform, const Collider* collider, RaycastHit& hit) {
+        if (!collider->mesh) return false;
+        
+        TriangleHit triHit;
+        if (!placementOf(transform).raycast(*collider->mesh, origin, direction, maxDistance, triHit)) {
+            return false;
+        }
+        
+        hit.hit = true;
+        hit.distance = triHit.distance;
+        hit.point = origin + direction * triHit.distance;
+        hit.normal = triHit.normal;
+        return true;
+    }
+    
+    // Closest point on a mesh collider within maxDistance of point
+    static bool closestPointOnMesh(glm::vec3 point, float maxDistance, const Transform* transform,
+                                   const Collider* collider, glm::vec3& outPoint) {
+        MeshPlacement placement = placementOf(transform);
+        glm::vec3 localMin, localMax;
+        placement.boxToLocal(point, glm::vec3(maxDistance), localMin, localMax);
+        
+        float bestSq = maxDistance * maxDistance;
+        bool found = false;
+        collider->mesh->queryAABB(localMin, localMax,
+            [&](const TriangleMeshShape::Triangle& tri, uint32_t) {
+                glm::vec3 q = TriangleMeshShape::closestPointOnTriangle(
+                    point, placement.toWorld(tri.v0), placement.toWorld(tri.v1), placement.toWorld(tri.v2));
+                float distSq = glm::distance2(point, q);
+                if (distSq < bestSq) {
+                    bestSq = distSq;
+                    outPoint = q;
+                    found = true;
+                }
+            });
+        return found;
+    }
+    
+    // AABB against a mesh collider's triangles
+    static bool boxMesh(glm::vec3 center, glm::vec3 halfExtents, const Transform* transform,
+                        const Collider* collider) {
+        MeshPlacement placement = placementOf(transform);
+        glm::vec3 localMin, localMax;
+        placement.boxToLocal(center, halfExtents, localMin, localMax);
+        
+        bool overlaps = false;
+        collider->mesh->queryAABB(localMin, localMax,
+            [&](const TriangleMeshShape::Triangle& tri, uint32_t) {
+                if (overlaps) return;
+                glm::vec3 axis;
+                float depth;
+                overlaps = TriangleMeshShape::boxTriangleSAT(center, halfExtents,
+                    placement.toWorld(tri.v0), placement.toWorld(tri.v1), placement.toWorld(tri.v2),
+                    axis, depth);
+            });
+        return overlaps;
+    }
+    
     // Ray-sphere intersection
-    static bool raySphere(glm::vec3 origin, glm::vec3 direction, glm::vec3 center, 
+    static bool raySphere(glm::vec3 origin, glm::vec3 direction, glm::vec3 center,
                          float radius, RaycastHit& hit) {
         glm::vec3 oc = origin - center;
         float a = glm::dot(direction, direction);
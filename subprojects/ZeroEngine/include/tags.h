@@ -1,17 +1,25 @@
 #pragma once
 #include "Engine.h"
+#include "Name.h"
 #include <string>
 #include <unordered_set>
 #include <vector>
 
-// Tag component - simple string identifier
+// Tag component - string identifier, compared by its Name ID.
+// Change the name with set() so the ID follows.
 struct Tag : Component {
     std::string name;
+    Name id;
     
     Tag() = default;
-    Tag(const std::string& n) : name(n) {}
+    Tag(const std::string& n) : name(n), id(n) {}
     
-    bool operator==(const std::string& other) const { return name == other; }
+    void set(const std::string& n) {
+        name = n;
+        id = Name(n);
+    }
+    
+    bool operator==(Name other) const { return id == other; }
 };
 
 // Layer component - bitmask for collision/rendering layers
@@ -72,11 +80,11 @@ namespace Layers {
 class TagLayerQuery {
 public:
     // Find first entity with tag
-    static EntityID findEntityWithTag(ECS* ecs, const std::string& tagName) {
+    static EntityID findEntityWithTag(ECS* ecs, Name tagName) {
         // Iterate through all entities (in a real engine, you'd have a tag index)
         for (size_t i = 0; i < 10000; ++i) { // Reasonable entity limit
             auto* tag = ecs->getComponent<Tag>(i);
-            if (tag && tag->name == tagName) {
+            if (tag && tag->id == tagName) {
                 return i;
             }
         }
@@ -84,11 +92,11 @@ public:
     }
     
     // Find all entities with tag
-    static std::vector<EntityID> findEntitiesWithTag(ECS* ecs, const std::string& tagName) {
+    static std::vector<EntityID> findEntitiesWithTag(ECS* ecs, Name tagName) {
         std::vector<EntityID> results;
         for (size_t i = 0; i < 10000; ++i) {
             auto* tag = ecs->getComponent<Tag>(i);
-            if (tag && tag->name == tagName) {
+            if (tag && tag->id == tagName) {
                 results.push_back(i);
             }
         }
@@ -121,13 +129,13 @@ public:
     
     // Find entities with specific tag AND on specific layer
     static std::vector<EntityID> findEntitiesWithTagAndLayer(ECS* ecs, 
-                                                             const std::string& tagName, 
+                                                             Name tagName, 
                                                              int layer) {
         std::vector<EntityID> results;
         for (size_t i = 0; i < 10000; ++i) {
             auto* tag = ecs->getComponent<Tag>(i);
             auto* layerComp = ecs->getComponent<Layer>(i);
-            if (tag && tag->name == tagName && 
+            if (tag && tag->id == tagName && 
                 layerComp && layerComp->hasLayer(layer)) {
                 results.push_back(i);
             }
@@ -148,7 +156,7 @@ public:
 
 // Tag manager - maintains index for fast lookups (optional optimization)
 class TagManager {
-    std::unordered_map<std::string, std::unordered_set<EntityID>> tagIndex;
+    std::unordered_map<Name, std::unordered_set<EntityID>> tagIndex;
     ECS* ecs = nullptr;
     
 public:
@@ -156,11 +164,11 @@ public:
         ecs = ecsInstance;
     }
     
-    void addTag(EntityID entity, const std::string& tag) {
+    void addTag(EntityID entity, Name tag) {
         tagIndex[tag].insert(entity);
     }
     
-    void removeTag(EntityID entity, const std::string& tag) {
+    void removeTag(EntityID entity, Name tag) {
         auto it = tagIndex.find(tag);
         if (it != tagIndex.end()) {
             it->second.erase(entity);
@@ -176,7 +184,7 @@ public:
         }
     }
     
-    EntityID findFirstWithTag(const std::string& tag) const {
+    EntityID findFirstWithTag(Name tag) const {
         auto it = tagIndex.find(tag);
         if (it != tagIndex.end() && !it->second.empty()) {
             return *it->second.begin();
@@ -184,7 +192,7 @@ public:
         return 0;
     }
     
-    std::vector<EntityID> findAllWithTag(const std::string& tag) const {
+    std::vector<EntityID> findAllWithTag(Name tag) const {
         auto it = tagIndex.find(tag);
         if (it != tagIndex.end()) {
             return std::vector<EntityID>(it->second.begin(), it->second.end());
@@ -192,7 +200,7 @@ public:
         return {};
     }
     
-    bool hasTag(EntityID entity, const std::string& tag) const {
+    bool hasTag(EntityID entity, Name tag) const {
         auto it = tagIndex.find(tag);
         return it != tagIndex.end() && it->second.count(entity) > 0;
     }
@@ -208,8 +216,8 @@ public:
         
         for (size_t i = 0; i < 10000; ++i) {
             auto* tag = ecs->getComponent<Tag>(i);
-            if (tag && !tag->name.empty()) {
-                tagIndex[tag->name].insert(i);
+            if (tag && !tag->id.empty()) {
+                tagIndex[tag->id].insert(i);
             }
         }
     }
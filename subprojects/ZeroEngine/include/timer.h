@@ -3,6 +3,11 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
 // Simple timer with callback
 class Timer {
 public:
@@ -65,93 +70,474 @@ public:
 };
 
 // Timer manager
-class TimerManager {
-    std::vector<Timer> timers;
-    bool updating = false;
-    std::vector<size_t> toRemove;
+//
+// Timers live in hierarchical timing wheels, one per group: four levels of
+// 256 slots, each slot an intrusive list of timers, so adding, cancelling
+// and pausing are O(1) and update() only touches timers that are due (plus
+// the occasional cascade of a coarse slot into finer ones). Time is counted
+// in ticks (1 ms by default). Expired timers are collected first and their
+// callbacks run afterwards, so callbacks can add or cancel timers freely;
+// timers without a callback are handed to their group's batch handler in
+// one call per update. Handles carry a generation and go stale once their
+// timer is freed, so an old handle never reaches a newer timer.
+
+struct TimerHandle {
+    uint32_t index = 0xFFFFFFFF;
+    uint32_t generation = 0;
     
+    bool valid() const { return index != 0xFFFFFFFF; }
+    explicit operator bool() const { return valid(); }
+    bool operator==(const TimerHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const TimerHandle& other) const { return !(*this == other); }
+};
+
+// Passed to group batch handlers
+struct ExpiredTimer {
+    TimerHandle handle;
+    uint64_t userData = 0;
+};
+
+class TimerManager {
 public:
-    // Add timer and get its index
-    size_t addTimer(float duration, Timer::Callback callback, bool repeat = false, const std::string& name = "") {
-        timers.emplace_back(duration, callback, repeat, name);
-        return timers.size() - 1;
+    using BatchCallback = std::function<void(const ExpiredTimer*, size_t)>;
+    
+    static constexpr uint32_t DEFAULT_GROUP = 0;
+    
+    // Whole ticks per second, so common frame times convert exactly
+    explicit TimerManager(uint32_t ticksPerSecond = 1000) : ticksPerSecond(double(std::max(ticksPerSecond, 1u))) {}
+    
+    // Add timer; it fires after duration seconds of its group's time
+    TimerHandle addTimer(float duration, Timer::Callback callback, bool repeat = false,
+                         const std::string& name = "", uint32_t group = DEFAULT_GROUP) {
+        TimerHandle handle = allocate(duration, repeat, group, false);
+        callbacks[handle.index] = std::move(callback);
+        if (!name.empty()) {
+            removeTimer(name);
+            names[handle.index] = name;
+            named[name] = handle;
+        }
+        return handle;
+    }
+    
+    // Timer without a callback: it goes to the group's batch handler with
+    // userData when it expires. Cheapest for large numbers of cooldowns.
+    TimerHandle addTimer(float duration, uint64_t userData, bool repeat = false, uint32_t group = DEFAULT_GROUP) {
+        TimerHandle handle = allocate(duration, repeat, group, true);
+        nodes[handle.index].userData = userData;
+        return handle;
     }
     
     // Convenience methods
-    size_t after(float seconds, Timer::Callback callback, const std::string& name = "") {
-        return addTimer(seconds, callback, false, name);
+    TimerHandle after(float seconds, Timer::Callback callback, const std::string& name = "") {
+        return addTimer(seconds, std::move(callback), false, name);
     }
     
-    size_t every(float seconds, Timer::Callback callback, const std::string& name = "") {
-        return addTimer(seconds, callback, true, name);
+    TimerHandle every(float seconds, Timer::Callback callback, const std::string& name = "") {
+        return addTimer(seconds, std::move(callback), true, name);
     }
     
-    // Update all timers
+    // Advance every unpaused group by dt (scaled per group) and fire what's due
     void update(float dt) {
+        if (updating) return;
         updating = true;
-        toRemove.clear();
+        fired.clear();
         
-        for (size_t i = 0; i < timers.size(); ++i) {
-            if (timers[i].update(dt)) {
-                toRemove.push_back(i);
-            }
+        for (Group& g : groups) {
+            if (g.paused || g.scale <= 0.0f) continue;
+            g.carry += double(dt) * g.scale * ticksPerSecond;
+            uint64_t ticks = static_cast<uint64_t>(g.carry);
+            g.carry -= double(ticks);
+            if (ticks) advance(g, g.now + ticks);
         }
         
+        deliver();
         updating = false;
+    }
+    
+    // === Per timer ===
+    
+    bool isActive(TimerHandle handle) const {
+        const Node* node = find(handle);
+        return node && (node->state == State::Scheduled || node->state == State::Paused);
+    }
+    
+    bool isPaused(TimerHandle handle) const {
+        const Node* node = find(handle);
+        return node && node->state == State::Paused;
+    }
+    
+    // Stop a timer; false if it already finished or was removed
+    bool removeTimer(TimerHandle handle) {
+        Node* node = find(handle);
+        if (!node) return false;
+        switch (node->state) {
+            case State::Scheduled:
+                unlink(handle.index);
+                release(handle.index);
+                return true;
+            case State::Paused:
+                release(handle.index);
+                return true;
+            case State::Fired:
+                node->state = State::Cancelled;   // Freed once update() is done with it
+                return true;
+            default:
+                return false;
+        }
+    }
+    
+    bool removeTimer(const std::string& name) {
+        auto it = named.find(name);
+        return it != named.end() && removeTimer(it->second);
+    }
+    
+    bool pause(TimerHandle handle) {
+        Node* node = find(handle);
+        if (!node || node->state != State::Scheduled) return false;
+        unlink(handle.index);
+        node->expires -= groups[node->group].now;   // Ticks left while paused
+        node->state = State::Paused;
+        return true;
+    }
+    
+    bool resume(TimerHandle handle) {
+        Node* node = find(handle);
+        if (!node || node->state != State::Paused) return false;
+        node->expires += groups[node->group].now;
+        node->state = State::Scheduled;
+        link(handle.index);
+        return true;
+    }
+    
+    // Start counting from now again
+    bool reset(TimerHandle handle) {
+        Node* node = find(handle);
+        if (!node || (node->state != State::Scheduled && node->state != State::Paused)) return false;
+        if (node->state == State::Paused) {
+            node->expires = node->length;
+            return true;
+        }
+        unlink(handle.index);
+        node->expires = groups[node->group].now + node->length;
+        link(handle.index);
+        return true;
+    }
+    
+    // Seconds until it fires (of its group's time); 0 for finished timers
+    float getRemaining(TimerHandle handle) const {
+        const Node* node = find(handle);
+        if (!node) return 0.0f;
+        if (node->state == State::Paused) return float(double(node->expires) / ticksPerSecond);
+        if (node->state != State::Scheduled) return 0.0f;
+        const Group& g = groups[node->group];
+        double ticks = double(node->expires - g.now) - g.carry;
+        return float(std::max(ticks, 0.0) / ticksPerSecond);
+    }
+    
+    float getDuration(TimerHandle handle) const {
+        const Node* node = find(handle);
+        return node ? float(double(node->length) / ticksPerSecond) : 0.0f;
+    }
+    
+    float getProgress(TimerHandle handle) const {
+        float duration = getDuration(handle);
+        return duration > 0.0f ? 1.0f - getRemaining(handle) / duration : 1.0f;
+    }
+    
+    // Named timers
+    TimerHandle findTimer(const std::string& name) const {
+        auto it = named.find(name);
+        return it != named.end() ? it->second : TimerHandle{};
+    }
+    
+    bool hasTimer(const std::string& name) const {
+        return isActive(findTimer(name));
+    }
+    
+    // === Groups ===
+    //
+    // Each group has its own clock: a paused group's timers keep their time
+    // left, and a scaled group (slow motion, a sped-up UI) runs at
+    // dt * scale. Groups are created on first use.
+    
+    void setGroupPaused(uint32_t group, bool paused) { getGroup(group).paused = paused; }
+    void setGroupScale(uint32_t group, float scale) { getGroup(group).scale = std::max(scale, 0.0f); }
+    bool isGroupPaused(uint32_t group) const { return group < groups.size() && groups[group].paused; }
+    float getGroupScale(uint32_t group) const { return group < groups.size() ? groups[group].scale : 1.0f; }
+    
+    // Receives the group's callback-less timers that expired in an update
+    void setBatchHandler(uint32_t group, BatchCallback handler) { getGroup(group).handler = std::move(handler); }
+    
+    // Clear all timers
+    void clear() {
+        if (updating) {
+            // Timers are mid-delivery; cancel them instead of freeing
+            for (uint32_t i = 0; i < nodes.size(); i++) {
+                removeTimer(TimerHandle{i, nodes[i].generation});
+            }
+            return;
+        }
+        for (uint32_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i].state != State::Free) release(i);
+        }
+        for (Group& g : groups) g.clearSlots();
+    }
+    
+    // Query
+    size_t getTimerCount() const { return activeCount; }
+    
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+    static constexpr uint32_t LEVEL_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << LEVEL_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t LEVELS = 4;
+    static constexpr uint32_t OVERFLOW_SLOT = LEVELS * SLOTS;   // Beyond 2^32 ticks
+    
+    enum class State : uint8_t { Free, Scheduled, Paused, Fired, Cancelled };
+    
+    struct Node {
+        uint64_t expires = 0;       // Group tick it fires on; ticks left while paused
+        uint64_t length = 0;        // Duration in ticks
+        uint64_t userData = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;       // Slot list, or the free list
+        uint32_t generation = 0;
+        uint32_t group = 0;
+        uint16_t slot = 0;
+        State state = State::Free;
+        bool repeat = false;
+        bool batched = false;       // No callback; goes to the group's handler
+    };
+    
+    struct Group {
+        uint64_t now = 0;
+        double carry = 0.0;         // Fraction of a tick not yet advanced
+        float scale = 1.0f;
+        bool paused = false;
+        BatchCallback handler;
+        uint32_t heads[OVERFLOW_SLOT + 1];
+        uint64_t occupied[LEVELS][SLOTS / 64];
         
-        // Remove finished timers (in reverse order to maintain indices)
-        for (auto it = toRemove.rbegin(); it != toRemove.rend(); ++it) {
-            timers.erase(timers.begin() + *it);
+        Group() { clearSlots(); }
+        
+        void clearSlots() {
+            std::fill(std::begin(heads), std::end(heads), NONE);
+            std::memset(occupied, 0, sizeof(occupied));
+        }
+    };
+    
+    std::vector<Node> nodes;
+    std::vector<Timer::Callback> callbacks;     // Cold, by node index
+    std::vector<std::string> names;
+    std::unordered_map<std::string, TimerHandle> named;
+    std::vector<Group> groups;
+    std::vector<uint32_t> fired;
+    std::vector<ExpiredTimer> batch;
+    uint32_t freeList = NONE;
+    size_t activeCount = 0;
+    double ticksPerSecond;
+    bool updating = false;
+    
+    Group& getGroup(uint32_t group) {
+        if (group >= groups.size()) groups.resize(group + 1);
+        return groups[group];
+    }
+    
+    Node* find(TimerHandle handle) {
+        if (handle.index >= nodes.size() || nodes[handle.index].generation != handle.generation) return nullptr;
+        return nodes[handle.index].state == State::Free ? nullptr : &nodes[handle.index];
+    }
+    
+    const Node* find(TimerHandle handle) const {
+        if (handle.index >= nodes.size() || nodes[handle.index].generation != handle.generation) return nullptr;
+        return nodes[handle.index].state == State::Free ? nullptr : &nodes[handle.index];
+    }
+    
+    TimerHandle allocate(float duration, bool repeat, uint32_t group, bool batched) {
+        uint32_t index;
+        if (freeList != NONE) {
+            index = freeList;
+            freeList = nodes[index].next;
+        } else {
+            index = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+            callbacks.emplace_back();
+            names.emplace_back();
         }
+        
+        Group& g = getGroup(group);
+        Node& node = nodes[index];
+        // At least one tick, so a timer never fires in the update that adds it;
+        // float durations a hair over a whole tick count round down to it
+        double ticks = std::ceil(std::max(double(duration), 0.0) * ticksPerSecond - 1e-3);
+        node.length = std::max<uint64_t>(1, static_cast<uint64_t>(ticks));
+        node.expires = g.now + node.length;
+        node.userData = 0;
+        node.group = group;
+        node.repeat = repeat;
+        node.batched = batched;
+        node.state = State::Scheduled;
+        link(index);
+        activeCount++;
+        return {index, node.generation};
     }
     
-    // Access timers
-    Timer* getTimer(size_t index) {
-        return index < timers.size() ? &timers[index] : nullptr;
+    void release(uint32_t index) {
+        Node& node = nodes[index];
+        if (!names[index].empty()) {
+            auto it = named.find(names[index]);
+            if (it != named.end() && it->second.index == index) named.erase(it);
+            names[index].clear();
+        }
+        callbacks[index] = nullptr;
+        node.state = State::Free;
+        node.generation++;
+        node.next = freeList;
+        freeList = index;
+        activeCount--;
     }
     
-    Timer* findTimer(const std::string& name) {
-        for (auto& timer : timers) {
-            if (timer.getName() == name) {
-                return &timer;
+    // Level 0 holds timers due within the current 256-tick block, level 1
+    // those within the current 65536-tick block, and so on
+    void link(uint32_t index) {
+        Node& node = nodes[index];
+        Group& g = groups[node.group];
+        uint32_t slot = OVERFLOW_SLOT;
+        for (uint32_t level = 0; level < LEVELS; level++) {
+            uint32_t shift = (level + 1) * LEVEL_BITS;
+            if ((node.expires >> shift) == (g.now >> shift)) {
+                uint32_t local = uint32_t((node.expires >> (level * LEVEL_BITS)) & SLOT_MASK);
+                slot = level * SLOTS + local;
+                g.occupied[level][local / 64] |= uint64_t(1) << (local % 64);
+                break;
             }
         }
-        return nullptr;
+        node.slot = static_cast<uint16_t>(slot);
+        node.prev = NONE;
+        node.next = g.heads[slot];
+        if (node.next != NONE) nodes[node.next].prev = index;
+        g.heads[slot] = index;
     }
     
-    // Remove timer
-    void removeTimer(size_t index) {
-        if (index < timers.size()) {
-            if (updating) {
-                toRemove.push_back(index);
-            } else {
-                timers.erase(timers.begin() + index);
+    void unlink(uint32_t index) {
+        Node& node = nodes[index];
+        Group& g = groups[node.group];
+        if (node.prev != NONE) nodes[node.prev].next = node.next;
+        else g.heads[node.slot] = node.next;
+        if (node.next != NONE) nodes[node.next].prev = node.prev;
+        if (g.heads[node.slot] == NONE && node.slot != OVERFLOW_SLOT) {
+            uint32_t local = node.slot % SLOTS;
+            g.occupied[node.slot / SLOTS][local / 64] &= ~(uint64_t(1) << (local % 64));
+        }
+    }
+    
+    // Detach a whole slot; returns its first node
+    uint32_t takeSlot(Group& g, uint32_t slot) {
+        uint32_t head = g.heads[slot];
+        g.heads[slot] = NONE;
+        if (slot != OVERFLOW_SLOT) {
+            uint32_t local = slot % SLOTS;
+            g.occupied[slot / SLOTS][local / 64] &= ~(uint64_t(1) << (local % 64));
+        }
+        return head;
+    }
+    
+    // First occupied level 0 slot at or after from, or SLOTS
+    static uint32_t nextOccupied(const Group& g, uint32_t from) {
+        while (from < SLOTS) {
+            uint64_t bits = g.occupied[0][from / 64] >> (from % 64);
+            if (bits) {
+                uint32_t zeros = 0;
+                while (!(bits & 1)) {
+                    bits >>= 1;
+                    zeros++;
+                }
+                return from + zeros;
             }
+            from = (from / 64 + 1) * 64;
         }
+        return SLOTS;
     }
     
-    void removeTimer(const std::string& name) {
-        for (size_t i = 0; i < timers.size(); ++i) {
-            if (timers[i].getName() == name) {
-                removeTimer(i);
+    // Step the group's clock to target, jumping over empty slots
+    void advance(Group& g, uint64_t target) {
+        while (g.now < target) {
+            uint32_t slot = nextOccupied(g, uint32_t(g.now & SLOT_MASK) + 1);
+            uint64_t next = slot < SLOTS ? (g.now & ~SLOT_MASK) | slot : (g.now | SLOT_MASK) + 1;
+            if (next > target) {
+                g.now = target;
                 return;
             }
+            g.now = next;
+            if ((g.now & SLOT_MASK) == 0) cascade(g);
+            
+            for (uint32_t i = takeSlot(g, uint32_t(g.now & SLOT_MASK)); i != NONE; ) {
+                uint32_t following = nodes[i].next;
+                nodes[i].state = State::Fired;
+                fired.push_back(i);
+                i = following;
+            }
         }
     }
     
-    // Clear all timers
-    void clear() {
-        timers.clear();
-        toRemove.clear();
+    // At a block boundary, move the coarser slots that just came due down
+    // a level (coarsest first, so nothing is re-filed into a slot that's
+    // already been handled)
+    void cascade(Group& g) {
+        uint32_t top = 1;
+        while (top < LEVELS && (g.now & ((uint64_t(1) << ((top + 1) * LEVEL_BITS)) - 1)) == 0) top++;
+        
+        if (top == LEVELS && (g.now & 0xFFFFFFFFull) == 0) relinkSlot(g, OVERFLOW_SLOT);
+        for (uint32_t level = std::min(top, LEVELS - 1); level >= 1; level--) {
+            relinkSlot(g, level * SLOTS + uint32_t((g.now >> (level * LEVEL_BITS)) & SLOT_MASK));
+        }
     }
     
-    // Query
-    size_t getTimerCount() const { return timers.size(); }
-    bool hasTimer(const std::string& name) const {
-        for (const auto& timer : timers) {
-            if (timer.getName() == name) return true;
+    void relinkSlot(Group& g, uint32_t slot) {
+        for (uint32_t i = takeSlot(g, slot); i != NONE; ) {
+            uint32_t following = nodes[i].next;
+            link(i);
+            i = following;
+        }
+    }
+    
+    // Run callbacks and batch handlers, then reschedule or free the timers
+    void deliver() {
+        for (uint32_t index : fired) {
+            if (nodes[index].state != State::Fired || nodes[index].batched || !callbacks[index]) continue;
+            // Moved out so the callback can add timers (and grow the vector)
+            Timer::Callback callback = std::move(callbacks[index]);
+            callback();
+            if (nodes[index].state == State::Fired && nodes[index].repeat) callbacks[index] = std::move(callback);
+        }
+        
+        for (uint32_t group = 0; group < groups.size(); group++) {
+            if (!groups[group].handler) continue;
+            batch.clear();
+            for (uint32_t index : fired) {
+                const Node& node = nodes[index];
+                if (node.group == group && node.batched && node.state == State::Fired) {
+                    batch.push_back({TimerHandle{index, node.generation}, node.userData});
+                }
+            }
+            if (!batch.empty()) groups[group].handler(batch.data(), batch.size());
+        }
+        
+        // A repeating timer fires at most once per update; after a long
+        // frame it picks up from now rather than firing to catch up
+        for (uint32_t index : fired) {
+            Node& node = nodes[index];
+            if (node.state == State::Fired && node.repeat) {
+                const Group& g = groups[node.group];
+                node.expires = std::max(node.expires + node.length, g.now + 1);
+                node.state = State::Scheduled;
+                link(index);
+            } else {
+                release(index);
+            }
         }
-        return false;
+        fired.clear();
     }
 };
 
@@ -286,7 +672,7 @@ namespace Easing {
     }
 }
 
-// Tween helper with easing
+// Tween helper with easing (TweenSystem.h batches large numbers of these)
 template<typename T>
 class Tween {
     T startValue;
@@ -4,14 +4,111 @@
 #include "transform.h"
 
 
+namespace {
+
+// Half extents of a collider's world AABB (spheres/capsules use their scaled radius)
+glm::vec3 colliderExtents(const Transform* transform, const Collider* collider) {
+    if (collider->type == ColliderType::Box) {
+        return collider->size * transform->scale * 0.5f;
+    }
+    float scale = glm::max(glm::max(transform->scale.x, transform->scale.y), transform->scale.z);
+    return glm::vec3(collider->radius * scale);
+}
+
+MeshPlacement meshPlacement(const Transform* transform) {
+    return MeshPlacement{transform->position, transform->rotation, transform->scale};
+}
+
+// Slab test of a segment (origin + delta * t, t in [0,1]) against an AABB.
+// Reports the entry time and the face normal that was crossed.
+bool segmentBox(glm::vec3 origin, glm::vec3 delta, glm::vec3 center, glm::vec3 halfExtents,
+                float& tEntry, glm::vec3& normal) {
+    float tNear = 0.0f;
+    float tFar = 1.0f;
+    int axis = -1;
+    float axisSign = 0.0f;
+    
+    for (int i = 0; i < 3; ++i) {
+        float lo = center[i] - halfExtents[i];
+        float hi = center[i] + halfExtents[i];
+        
+        if (glm::abs(delta[i]) < 1e-8f) {
+            if (origin[i] < lo || origin[i] > hi) return false;
+            continue;
+        }
+        
+        float inv = 1.0f / delta[i];
+        float t1 = (lo - origin[i]) * inv;
+        float t2 = (hi - origin[i]) * inv;
+        float sign = -1.0f;
+        if (t1 > t2) { std::swap(t1, t2); sign = 1.0f; }
+        
+        if (t1 > tNear) { tNear = t1; axis = i; axisSign = sign; }
+        tFar = glm::min(tFar, t2);
+        if (tNear > tFar) return false;
+    }
+    
+    // Started inside: the discrete pass owns this contact
+    if (axis < 0) return false;
+    
+    tEntry = tNear;
+    normal = glm::vec3(0);
+    normal[axis] = axisSign;
+    return true;
+}
+
+// Segment against a sphere, same conventions as segmentBox
+bool segmentSphere(glm::vec3 origin, glm::vec3 delta, glm::vec3 center, float radius,
+                   float& tEntry, glm::vec3& normal) {
+    glm::vec3 oc = origin - center;
+    float c = glm::dot(oc, oc) - radius * radius;
+    if (c <= 0.0f) return false;
+    
+    float a = glm::dot(delta, delta);
+    if (a < 1e-12f) return false;
+    
+    float b = glm::dot(oc, delta);
+    if (b >= 0.0f) return false; // Moving apart
+    
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) return false;
+    
+    float t = (-b - glm::sqrt(discriminant)) / a;
+    if (t < 0.0f || t > 1.0f) return false;
+    
+    tEntry = t;
+    normal = glm::normalize(oc + delta * t);
+    return true;
+}
+
+} // namespace
+
+void getColliderBounds(const Transform* transform, const Collider* collider, glm::vec3& min, glm::vec3& max) {
+    if (collider->type == ColliderType::Mesh) {
+        if (collider->mesh) {
+            meshPlacement(transform).worldBounds(*collider->mesh, min, max);
+        } else {
+            min = max = transform->position;
+        }
+        return;
+    }
+    glm::vec3 half = colliderExtents(transform, collider);
+    min = transform->position - half;
+    max = transform->position + half;
+}
+
 void PhysicsSystem::update(float dt) {
     if (!ecs) return;
     
+    stepStart.resize(entities.size());
+    
     // Apply forces
-    for (EntityID entity : entities) {
+    for (size_t i = 0; i < entities.size(); ++i) {
+        EntityID entity = entities[i];
         auto* transform = ecs->getComponent<Transform>(entity);
         auto* rb = ecs->getComponent<RigidBody>(entity);
         
+        if (transform) stepStart[i] = transform->position;
         if (!transform || !rb || rb->isKinematic) continue;
         
         // Gravity
@@ -31,41 +128,236 @@ void PhysicsSystem::update(float dt) {
     
     // Collision detection and resolution
     if (config.enableCollisions) {
+        // Fast bodies are pulled back to their time of impact before the
+        // discrete pass, so they can't skip over thin geometry in one step
+        if (config.enableContinuousCollision) {
+            buildBroadphase(true);
+            findCandidatePairs();
+            solveContinuous();
+        }
+        
         auto collisions = detectCollisions();
+        if (events) {
+            for (const auto& col : collisions) {
+                bool trigger = ecs->getComponent<Collider>(col.entityA)->isTrigger ||
+                               ecs->getComponent<Collider>(col.entityB)->isTrigger;
+                events->publish<CollisionEvent>(col.entityA, col.entityB, col.point, col.normal,
+                                                col.penetration, trigger);
+            }
+        }
+        
+        // Mesh contacts push the body out by the full depth, and the depth
+        // isn't recomputed between iterations, so they're resolved once
+        auto againstMesh = [this](const CollisionInfo& col) {
+            return ecs->getComponent<Collider>(col.entityA)->type == ColliderType::Mesh ||
+                   ecs->getComponent<Collider>(col.entityB)->type == ColliderType::Mesh;
+        };
         for (int iter = 0; iter < config.solverIterations; ++iter) {
             for (const auto& col : collisions) {
-                resolveCollision(col);
+                if (!againstMesh(col)) resolveCollision(col);
             }
         }
+        for (const auto& col : collisions) {
+            if (againstMesh(col)) resolveCollision(col);
+        }
     }
+    
+    stepStart.clear();
 }
 
-std::vector<CollisionInfo> PhysicsSystem::detectCollisions() {
-    std::vector<CollisionInfo> collisions;
+void PhysicsSystem::buildBroadphase(bool swept) {
+    proxies.clear();
     
     for (size_t i = 0; i < entities.size(); ++i) {
-        for (size_t j = i + 1; j < entities.size(); ++j) {
-            CollisionInfo info;
-            
-            auto* collA = ecs->getComponent<Collider>(entities[i]);
-            auto* collB = ecs->getComponent<Collider>(entities[j]);
-            
-            if (!collA || !collB) continue;
-            
-            bool collided = false;
-            
-            if (collA->type == ColliderType::Box && collB->type == ColliderType::Box) {
-                collided = checkBoxBox(entities[i], entities[j], info);
-            } else if (collA->type == ColliderType::Sphere && collB->type == ColliderType::Sphere) {
-                collided = checkSphereSphere(entities[i], entities[j], info);
-            } else {
-                collided = checkBoxSphere(entities[i], entities[j], info);
-            }
-            
-            if (collided) {
-                collisions.push_back(info);
+        EntityID entity = entities[i];
+        auto* transform = ecs->getComponent<Transform>(entity);
+        auto* collider = ecs->getComponent<Collider>(entity);
+        if (!transform || !collider) continue;
+        
+        BroadphaseProxy proxy{entity, glm::vec3(0), glm::vec3(0), glm::vec3(0)};
+        getColliderBounds(transform, collider, proxy.min, proxy.max);
+        
+        if (swept && i < stepStart.size() && !collider->isTrigger && collider->type != ColliderType::Mesh) {
+            glm::vec3 half = colliderExtents(transform, collider);
+            auto* rb = ecs->getComponent<RigidBody>(entity);
+            if (rb && rb->continuousCollision) {
+                proxy.sweep = transform->position - stepStart[i];
+                proxy.min = glm::min(proxy.min, stepStart[i] - half);
+                proxy.max = glm::max(proxy.max, stepStart[i] + half);
             }
         }
+        
+        proxies.push_back(proxy);
+    }
+}
+
+void PhysicsSystem::findCandidatePairs() {
+    candidatePairs.clear();
+    
+    // Sort and sweep along X
+    std::sort(proxies.begin(), proxies.end(),
+        [](const BroadphaseProxy& a, const BroadphaseProxy& b) { return a.min.x < b.min.x; });
+    
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        const auto& a = proxies[i];
+        for (size_t j = i + 1; j < proxies.size() && proxies[j].min.x <= a.max.x; ++j) {
+            const auto& b = proxies[j];
+            if (a.min.y > b.max.y || a.max.y < b.min.y) continue;
+            if (a.min.z > b.max.z || a.max.z < b.min.z) continue;
+            candidatePairs.emplace_back(i, j);
+        }
+    }
+}
+
+void PhysicsSystem::solveContinuous() {
+    // Earliest impact per proxy
+    struct Impact {
+        float toi = 2.0f;
+        size_t other = 0;
+        glm::vec3 normal{0};
+    };
+    std::vector<Impact> impacts(proxies.size());
+    
+    const glm::vec3 zero(0);
+    for (const auto& [i, j] : candidatePairs) {
+        const auto& a = proxies[i];
+        const auto& b = proxies[j];
+        if (a.sweep == zero && b.sweep == zero) continue;
+        
+        float toi;
+        glm::vec3 normal; // Points from b towards a
+        if (!sweepPair(a, b, toi, normal)) continue;
+        
+        if (a.sweep != zero && toi < impacts[i].toi) impacts[i] = {toi, j, normal};
+        if (b.sweep != zero && toi < impacts[j].toi) impacts[j] = {toi, i, -normal};
+    }
+    
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        const Impact& impact = impacts[i];
+        if (impact.toi > 1.0f) continue;
+        
+        const auto& proxy = proxies[i];
+        auto* transform = ecs->getComponent<Transform>(proxy.entity);
+        auto* rb = ecs->getComponent<RigidBody>(proxy.entity);
+        if (!transform || !rb) continue;
+        
+        // Advance to the impact and drop the rest of the step
+        transform->position -= proxy.sweep * (1.0f - impact.toi);
+        
+        auto* otherRb = ecs->getComponent<RigidBody>(proxies[impact.other].entity);
+        glm::vec3 otherVel = otherRb ? otherRb->velocity : glm::vec3(0);
+        
+        float approach = glm::dot(rb->velocity - otherVel, impact.normal);
+        if (approach >= 0.0f) continue;
+        
+        if (otherRb && !otherRb->isKinematic) {
+            float j = -(1.0f + config.restitution) * approach;
+            j /= (1.0f / rb->mass + 1.0f / otherRb->mass);
+            rb->velocity += impact.normal * (j / rb->mass);
+            otherRb->velocity -= impact.normal * (j / otherRb->mass);
+        } else {
+            rb->velocity -= impact.normal * ((1.0f + config.restitution) * approach);
+        }
+    }
+}
+
+bool PhysicsSystem::sweepPair(const BroadphaseProxy& a, const BroadphaseProxy& b,
+                              float& toi, glm::vec3& normal) {
+    auto* transA = ecs->getComponent<Transform>(a.entity);
+    auto* transB = ecs->getComponent<Transform>(b.entity);
+    auto* collA = ecs->getComponent<Collider>(a.entity);
+    auto* collB = ecs->getComponent<Collider>(b.entity);
+    if (collA->isTrigger || collB->isTrigger) return false;
+    
+    // Sweep A relative to B, with B held at its start position
+    glm::vec3 startA = transA->position - a.sweep;
+    glm::vec3 startB = transB->position - b.sweep;
+    glm::vec3 delta = a.sweep - b.sweep;
+    
+    if (collB->type == ColliderType::Mesh) {
+        return collA->type != ColliderType::Mesh &&
+               sweepMesh(a.entity, startA, delta, b.entity, toi, normal);
+    }
+    if (collA->type == ColliderType::Mesh) {
+        if (!sweepMesh(b.entity, startB, -delta, a.entity, toi, normal)) return false;
+        normal = -normal;
+        return true;
+    }
+    
+    bool sphereA = collA->type != ColliderType::Box;
+    bool sphereB = collB->type != ColliderType::Box;
+    glm::vec3 extA = colliderExtents(transA, collA);
+    glm::vec3 extB = colliderExtents(transB, collB);
+    
+    if (sphereA && sphereB) {
+        return segmentSphere(startA, delta, startB, extA.x + extB.x, toi, normal);
+    }
+    
+    // Minkowski sum of the boxes (rounded corners ignored, so slightly early)
+    return segmentBox(startA, delta, startB, extA + extB, toi, normal);
+}
+
+bool PhysicsSystem::sweepMesh(EntityID body, glm::vec3 start, glm::vec3 delta, EntityID meshEntity,
+                              float& toi, glm::vec3& normal) {
+    auto* transBody = ecs->getComponent<Transform>(body);
+    auto* collBody = ecs->getComponent<Collider>(body);
+    auto* transMesh = ecs->getComponent<Transform>(meshEntity);
+    auto* collMesh = ecs->getComponent<Collider>(meshEntity);
+    if (!collMesh->mesh) return false;
+    
+    float length = glm::length(delta);
+    if (length < 1e-6f) return false;
+    glm::vec3 dir = delta / length;
+    
+    // Cast the body's center and stop short by its extent along the motion.
+    // Grazing hits off-center are left to the discrete pass.
+    glm::vec3 half = colliderExtents(transBody, collBody);
+    float extent = collBody->type == ColliderType::Box ? glm::dot(glm::abs(dir), half) : half.x;
+    
+    TriangleHit hit;
+    if (!meshPlacement(transMesh).raycast(*collMesh->mesh, start, dir, length + extent, hit)) return false;
+    
+    toi = glm::max(0.0f, (hit.distance - extent) / length);
+    if (toi > 1.0f) return false;
+    normal = hit.normal; // Faces the incoming body
+    return true;
+}
+
+std::vector<CollisionInfo> PhysicsSystem::detectCollisions() {
+    std::vector<CollisionInfo> collisions;
+    if (!ecs) return collisions;
+    
+    buildBroadphase(false);
+    findCandidatePairs();
+    
+    for (const auto& [i, j] : candidatePairs) {
+        EntityID a = proxies[i].entity;
+        EntityID b = proxies[j].entity;
+        CollisionInfo info;
+        
+        auto* collA = ecs->getComponent<Collider>(a);
+        auto* collB = ecs->getComponent<Collider>(b);
+        
+        bool collided = false;
+        
+        bool meshA = collA->type == ColliderType::Mesh;
+        bool meshB = collB->type == ColliderType::Mesh;
+        
+        if (meshA || meshB) {
+            // Static level geometry never collides with itself
+            if (meshA && meshB) continue;
+            collided = meshB ? checkMesh(a, b, info) : checkMesh(b, a, info);
+        } else if (collA->type == ColliderType::Box && collB->type == ColliderType::Box) {
+            collided = checkBoxBox(a, b, info);
+        } else if (collA->type == ColliderType::Sphere && collB->type == ColliderType::Sphere) {
+            collided = checkSphereSphere(a, b, info);
+        } else {
+            collided = checkBoxSphere(a, b, info);
+        }
+        
+        if (collided) {
+            collisions.push_back(info);
+        }
     }
     
     return collisions;
@@ -82,6 +374,29 @@ void PhysicsSystem::resolveCollision(const CollisionInfo& info) {
     if (!transA || !transB) return;
     if (collA->isTrigger || collB->isTrigger) return;
     
+    // Mesh colliders are static: push the body out fully and reflect its
+    // velocity (update() calls this once per mesh contact, not per iteration)
+    bool staticA = collA->type == ColliderType::Mesh;
+    bool staticB = collB->type == ColliderType::Mesh;
+    if (staticA || staticB) {
+        if (staticA && staticB) return;
+        
+        Transform* trans = staticA ? transB : transA;
+        RigidBody* rb = staticA ? rbB : rbA;
+        glm::vec3 normal = staticA ? info.normal : -info.normal; // From the mesh towards the body
+        
+        if (rb && rb->isKinematic) return;
+        trans->position += normal * info.penetration;
+        
+        if (rb) {
+            float approach = glm::dot(rb->velocity, normal);
+            if (approach < 0.0f) {
+                rb->velocity -= normal * ((1.0f + config.restitution) * approach);
+            }
+        }
+        return;
+    }
+    
     // Separate objects
     float totalMass = (rbA ? rbA->mass : 1.0f) + (rbB ? rbB->mass : 1.0f);
     float ratioA = rbB ? rbB->mass / totalMass : 0.5f;
@@ -100,8 +415,7 @@ void PhysicsSystem::resolveCollision(const CollisionInfo& info) {
         float velAlongNormal = glm::dot(relVel, info.normal);
         
         if (velAlongNormal < 0) {
-            float restitution = 0.5f;
-            float j = -(1.0f + restitution) * velAlongNormal;
+            float j = -(1.0f + config.restitution) * velAlongNormal;
             j /= (1.0f / rbA->mass + 1.0f / rbB->mass);
             
             glm::vec3 impulse = j * info.normal;
@@ -173,3 +487,79 @@ bool PhysicsSystem::checkBoxSphere(EntityID /*a*/, EntityID /*b*/, CollisionInfo
     // Simplified box-sphere collision
     return false;
 }
+
+bool PhysicsSystem::checkMesh(EntityID body, EntityID meshEntity, CollisionInfo& info) {
+    auto* transBody = ecs->getComponent<Transform>(body);
+    auto* collBody = ecs->getComponent<Collider>(body);
+    auto* transMesh = ecs->getComponent<Transform>(meshEntity);
+    auto* collMesh = ecs->getComponent<Collider>(meshEntity);
+    if (!collMesh->mesh) return false;
+    
+    MeshPlacement placement = meshPlacement(transMesh);
+    glm::vec3 center = transBody->position;
+    glm::vec3 half = colliderExtents(transBody, collBody);
+    
+    glm::vec3 localMin, localMax;
+    placement.boxToLocal(center, half, localMin, localMax);
+    
+    bool found = false;
+    float bestDepth = 0.0f;
+    glm::vec3 bestNormal(0);
+    glm::vec3 bestPoint(0);
+    
+    if (collBody->type == ColliderType::Box) {
+        collMesh->mesh->queryAABB(localMin, localMax,
+            [&](const TriangleMeshShape::Triangle& tri, uint32_t) {
+                glm::vec3 a = placement.toWorld(tri.v0);
+                glm::vec3 b = placement.toWorld(tri.v1);
+                glm::vec3 c = placement.toWorld(tri.v2);
+                
+                glm::vec3 axis;
+                float depth;
+                if (!TriangleMeshShape::boxTriangleSAT(center, half, a, b, c, axis, depth)) return;
+                if (depth > bestDepth) {
+                    bestDepth = depth;
+                    bestNormal = axis;
+                    bestPoint = TriangleMeshShape::closestPointOnTriangle(center, a, b, c);
+                    found = true;
+                }
+            });
+    } else {
+        // Spheres and capsules (capsules approximated as spheres)
+        float radius = half.x;
+        collMesh->mesh->queryAABB(localMin, localMax,
+            [&](const TriangleMeshShape::Triangle& tri, uint32_t) {
+                glm::vec3 a = placement.toWorld(tri.v0);
+                glm::vec3 b = placement.toWorld(tri.v1);
+                glm::vec3 c = placement.toWorld(tri.v2);
+                
+                glm::vec3 q = TriangleMeshShape::closestPointOnTriangle(center, a, b, c);
+                glm::vec3 d = q - center;
+                float dist = glm::length(d);
+                float depth = radius - dist;
+                if (depth <= 0.0f || depth <= bestDepth) return;
+                
+                glm::vec3 normal;
+                if (dist > 1e-6f) {
+                    normal = d / dist;
+                } else {
+                    // Center on the surface: push out along the face normal
+                    normal = -glm::normalize(glm::cross(b - a, c - a));
+                }
+                
+                bestDepth = depth;
+                bestNormal = normal;
+                bestPoint = q;
+                found = true;
+            });
+    }
+    
+    if (!found) return false;
+    
+    info.entityA = body;
+    info.entityB = meshEntity;
+    info.normal = bestNormal; // From the body into the mesh
+    info.penetration = bestDepth;
+    info.point = bestPoint;
+    return true;
+}
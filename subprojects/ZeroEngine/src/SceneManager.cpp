@@ -1,6 +1,10 @@
 #include "SceneManager.h"
 #include <iostream>
 
+SceneManager::~SceneManager() {
+    if (buildThread.joinable()) buildThread.join();
+}
+
 void SceneManager::registerScene(const std::string& name, Scene* scene) {
     scene->name = name;
     scenes[name] = scene;
@@ -12,12 +16,47 @@ void SceneManager::loadScene(const std::string& name) {
         std::cerr << "Scene not found: " << name << std::endl;
         return;
     }
+    if (it->second == buildingScene) {
+        std::cerr << "Scene is still building: " << name << std::endl;
+        return;
+    }
     
     nextScene = it->second;
     transitioning = true;
 }
 
+bool SceneManager::loadSceneAsync(const std::string& name) {
+    if (buildingScene) return false;
+    
+    auto it = scenes.find(name);
+    if (it == scenes.end()) {
+        std::cerr << "Scene not found: " << name << std::endl;
+        return false;
+    }
+    if (it->second == currentScene || it->second == nextScene) {
+        std::cerr << "Scene is active or pending: " << name << std::endl;
+        return false;
+    }
+    
+    // A rebuild starts from scratch rather than adding to the last build
+    it->second->ecs = ECS();
+    buildingScene = it->second;
+    buildDone = false;
+    buildThread = std::thread([this] {
+        buildingScene->onBuild();
+        buildDone = true;
+    });
+    return true;
+}
+
 void SceneManager::update(float dt) {
+    if (buildingScene && buildDone) {
+        buildThread.join();
+        nextScene = buildingScene;
+        buildingScene = nullptr;
+        transitioning = true;
+    }
+    
     if (transitioning) {
         if (currentScene) {
             currentScene->onUnload();
@@ -35,6 +74,9 @@ void SceneManager::update(float dt) {
 }
 
 void SceneManager::cleanup() {
+    if (buildThread.joinable()) buildThread.join();
+    buildingScene = nullptr;
+    
     if (currentScene) {
         currentScene->onUnload();
     }
@@ -9,8 +9,17 @@
 #include "Pipeline.h"
 #include "PostProcessing.h"
 #include "ResourcePath.h"
+#include "VirtualFileSystem.h"
 #include "SceneManager.h"
 #include "ScenePackager.h"
+#include "SceneLoadPipeline.h"
+#include "SceneAutosave.h"
+#include "asset_manager.h"
+#include "WorldPartition.h"
+#include "WorldBuilder.h"
+#include "spatial_query.h"
+#include "PhysicsSystem.h"
+#include "event_system.h"
 #include "Skybox.h"
 #include "Time.h"
 #include "Engine.h"
@@ -212,6 +221,9 @@ struct ZeroEngine::Impl {
     // ECS
     ECS* ecs = nullptr;
     
+    // Game events; each world's PhysicsSystem publishes CollisionEvents here
+    EventSystem events;
+    
     // Cameras
     Camera editorCamera;
     CameraController* cameraController = nullptr;  // For editor camera controls
@@ -241,6 +253,20 @@ struct ZeroEngine::Impl {
     // Track loaded models for cleanup
     std::vector<EntityID> modelEntities;
     
+    // Background saves (saveSceneAsync / autosave)
+    SceneAutosaver autosaver;
+    
+    // Streams cells of an open partitioned world around the camera
+    WorldPartition world;
+    
+    // Path-keyed model/texture cache; frees evicted assets between frames
+    AssetManager assets;
+    
+    // loadSceneAsync: the next world being built, and swapped-out ones being freed
+    WorldBuilder worldBuilder;
+    RetiredWorlds retiredWorlds;
+    std::function<void(const SceneLoadProgress&)> asyncLoadProgress;
+    
     // Snapshot for play mode
    struct SceneSnapshot {
     std::vector<EntityInfo> entities;
@@ -254,7 +280,10 @@ SceneSnapshot sceneSnapshot;
         config = cfg;
         mode = cfg.mode;
         
-        ResourcePath::init();
+        ResourcePath::init(cfg.resourceRoot);
+        for (const auto& package : cfg.packages) {
+            VFS::FileSystem::get().mountPackage(package, "", 1);
+        }
         
         if (mode == EngineMode::Standalone) {
             return initStandalone();
@@ -393,6 +422,7 @@ SceneSnapshot sceneSnapshot;
             return false;
         }
         g_modelLoader = &modelLoader;
+        assets.init(&modelLoader);
         
         defaultBoneBuffer.create(allocator);
         
@@ -413,11 +443,7 @@ SceneSnapshot sceneSnapshot;
         }
         
         ecs = new ECS();
-        ecs->registerComponent<Transform>();
-        ecs->registerComponent<Tag>();
-        ecs->registerComponent<Layer>();
-        ecs->registerComponent<ModelComponent>();
-        ecs->registerComponent<CameraComponent>();
+        setupWorld(ecs);
         
         return true;
     }
@@ -440,6 +466,33 @@ SceneSnapshot sceneSnapshot;
             updateEmbedded(dt);
         }
         
+        // Deliver what systems published this frame, before the world can change
+        events.processQueue();
+        
+        // A background load finishes between frames, never mid-frame
+        if (worldBuilder.isBuilding()) {
+            bool complete = worldBuilder.update([&](EntityID, Model* model) { fixDescriptorSet(model); });
+            if (asyncLoadProgress) asyncLoadProgress(worldBuilder.getProgress());
+            if (complete) {
+                swapWorld();
+            } else if (worldBuilder.hasFailed() && !worldBuilder.isBuilding()) {
+                std::cerr << "Failed to load scene in background\n";
+            }
+        }
+        retiredWorlds.update(modelLoader, MAX_FRAMES_IN_FLIGHT + 1);
+        assets.update(MAX_FRAMES_IN_FLIGHT + 1);
+        
+        // Source 0 is the active camera; others come from setStreamingSource
+        if (world.isOpen()) {
+            world.setSource(0, getActiveCamera()->position);
+            world.update();
+        }
+        
+        // Autosave only while editing; play mode mutates the scene every frame
+        if (playState == PlayState::Editing) {
+            autosaver.update(ecs, dt);
+        }
+        
         frameCount++;
     }
     
@@ -454,6 +507,10 @@ SceneSnapshot sceneSnapshot;
             cameraController->update(dt, renderer->getWindow());
         }
         
+        // Refit the query index before systems run, so their queries see
+        // everything spawned or moved since the last frame
+        SpatialQuery::update(ecs);
+        
         if (playState == PlayState::Playing) {
             ecs->updateSystems(dt);
         }
@@ -497,6 +554,10 @@ SceneSnapshot sceneSnapshot;
     void updateEmbedded(float dt) {
         if (!offscreen.valid) return;
         
+        // Refit the query index before systems run, so their queries see
+        // everything spawned or moved since the last frame
+        SpatialQuery::update(ecs);
+        
         if (playState == PlayState::Playing) {
             ecs->updateSystems(dt);
         }
@@ -775,53 +836,154 @@ SceneSnapshot sceneSnapshot;
     
     // ==================== Scene ====================
     
-    bool loadScene(const std::string& path) {
+    // Scene packages are read in place, so a VFS path has to name a loose file
+    static std::string packagePath(const std::string& path) {
+        std::string file = VFS::FileSystem::get().resolve(path);
+        if (file.empty()) std::cerr << "✗ Can't open a package stored inside another package: " << path << std::endl;
+        return file;
+    }
+    
+    bool loadScene(const std::string& path,
+                   const std::function<void(const SceneLoadProgress&)>& onProgress = nullptr) {
+        std::string file = packagePath(path);
+        if (file.empty()) return false;
         clearScene();
         
-        if (!ScenePackaging::ScenePackager::loadScene(ecs, path)) {
+        // Columns decode and models import on worker threads while finished
+        // models are uploaded here in batches
+        bool ok = SceneLoadPipeline::load(ecs, modelLoader, file, SceneLoadOptions{}, onProgress,
+            [&](EntityID e, Model* model) {
+                fixDescriptorSet(model);
+                modelEntities.push_back(e);
+            });
+        if (!ok) {
             std::cerr << "Failed to load scene: " << path << "\n";
             return false;
         }
         
-        // Load model components
-        std::cout << "Loading models from scene...\n";
-        int modelsLoaded = 0;
-        for (EntityID e = 0; e < 10000; e++) {
+        std::cout << "Models loaded: " << modelEntities.size() << "\n";
+        std::cout << "✓ Scene loaded: " << path << "\n";
+        return true;
+    }
+    
+    // Build the scene into a new world on a worker thread; the current one
+    // keeps running until the new one is swapped in by update()
+    bool loadSceneAsync(const std::string& path,
+                        const std::function<void(const SceneLoadProgress&)>& onProgress = nullptr) {
+        std::string file = packagePath(path);
+        if (file.empty()) return false;
+        asyncLoadProgress = onProgress;
+        return worldBuilder.start(file, modelLoader, [this](ECS* target) { setupWorld(target); });
+    }
+    
+    void swapWorld() {
+        std::vector<EntityID> nextModelEntities;
+        std::unique_ptr<ECS> next = worldBuilder.take(nextModelEntities);
+        
+        // Streamed cells belong to the old world and free their models at once
+        if (world.isOpen()) {
+            vkDeviceWaitIdle(device);
+            world.close();
+        }
+        
+        // Frames in flight may still draw the old models; retire, don't free
+        std::vector<Model*> oldModels;
+        for (EntityID e : modelEntities) {
             auto* mc = ecs->getComponent<ModelComponent>(e);
-            if (mc) {
-                std::cout << "  Entity " << e << " has ModelComponent, path: '" << mc->modelPath << "'\n";
-                if (!mc->loadedModel && !mc->modelPath.empty()) {
-                    std::cout << "    Loading model: " << mc->modelPath << "\n";
-                    Model m = modelLoader.load(mc->modelPath);
-                    if (!m.vertices.empty()) {
-                        mc->loadedModel = new Model(std::move(m));
-                        fixDescriptorSet(mc->loadedModel);
-                        modelEntities.push_back(e);
-                        modelsLoaded++;
-                        std::cout << "    ✓ Model loaded successfully\n";
-                    } else {
-                        std::cout << "    ✗ Model load failed (empty vertices)\n";
-                    }
-                } else if (mc->loadedModel) {
-                    std::cout << "    Model already loaded\n";
-                } else {
-                    std::cout << "    ModelPath is empty!\n";
-                }
+            if (mc && mc->loadedModel) {
+                oldModels.push_back(mc->loadedModel);
+                mc->loadedModel = nullptr;
             }
         }
-        std::cout << "Models loaded: " << modelsLoaded << "/" << modelEntities.size() << "\n";
+        SpatialQuery::release(ecs);
+        retiredWorlds.retire(ecs, std::move(oldModels));
         
-        std::cout << "✓ Scene loaded: " << path << "\n";
-        return true;
+        ecs = next.release();
+        modelEntities = std::move(nextModelEntities);
+        g_camera = nullptr;
+        
+        // A play-mode snapshot refers to the old world's entities
+        sceneSnapshot.entities.clear();
+        sceneSnapshot.parentMap.clear();
+        
+        std::cout << "✓ Scene swapped in (" << modelEntities.size() << " models)\n";
     }
     
+    // Synchronous saves let a background save (saveSceneAsync, autosave)
+    // finish first, so an older snapshot can't land on top of this one
     bool saveScene(const std::string& path) {
+        autosaver.wait();
         return ScenePackaging::ScenePackager::saveScene(ecs, path, "GameScene");
     }
     
+    bool saveSceneAsync(const std::string& path) {
+        return autosaver.save(ecs, path, "GameScene");
+    }
+    
+    bool saveSceneBundle(const std::string& path) {
+        autosaver.wait();
+        return AssetBundleWriter::saveScene(ecs, modelLoader, path, "GameScene");
+    }
+    
+    bool saveWorld(const std::string& path, float cellSize, bool bundleAssets) {
+        return WorldPartition::save(ecs, path, "GameScene", cellSize, ScenePackage::CompressionType::LZ4,
+                                    bundleAssets ? &modelLoader : nullptr);
+    }
+    
+    bool openWorld(const std::string& path) {
+        std::string file = packagePath(path);
+        if (file.empty()) return false;
+        clearScene();
+        
+        world.setCallbacks(
+            [&](EntityID e, Model* model) {
+                fixDescriptorSet(model);
+                modelEntities.push_back(e);
+            },
+            [&](const std::vector<EntityID>& entities) {
+                std::unordered_set<EntityID> leaving(entities.begin(), entities.end());
+                modelEntities.erase(std::remove_if(modelEntities.begin(), modelEntities.end(),
+                                                   [&](EntityID e) { return leaving.count(e) > 0; }),
+                                    modelEntities.end());
+            });
+        return world.open(file, ecs, modelLoader);
+    }
+    
+    void setAutosave(const std::string& path, float intervalSeconds) {
+        if (intervalSeconds > 0.0f) {
+            autosaver.enableAutosave(path, intervalSeconds, "GameScene");
+        } else {
+            autosaver.disableAutosave();
+        }
+    }
+    
+    // Components and systems of every world. loadSceneAsync runs this on
+    // its worker before the scene is read, so systems see every entity.
+    void setupWorld(ECS* target) {
+        target->registerComponent<Transform>();
+        target->registerComponent<Tag>();
+        target->registerComponent<Layer>();
+        target->registerComponent<ModelComponent>();
+        target->registerComponent<CameraComponent>();
+        target->registerComponent<RigidBody>();
+        target->registerComponent<Collider>();
+        
+        // Members are the entities that can collide; bodies need a Collider too
+        auto physics = target->registerSystem<PhysicsSystem>();
+        physics->signature.set(target->getComponentType<Transform>());
+        physics->signature.set(target->getComponentType<Collider>());
+        physics->ecs = target;
+        physics->events = &events;
+    }
+    
     void clearScene() {
         vkDeviceWaitIdle(device);
         
+        worldBuilder.cancel();
+        retiredWorlds.flush(modelLoader);
+        assets.clear();
+        world.close();
+        
         for (EntityID e : modelEntities) {
             auto* mc = ecs->getComponent<ModelComponent>(e);
             if (mc && mc->loadedModel) {
@@ -832,13 +994,10 @@ SceneSnapshot sceneSnapshot;
         }
         modelEntities.clear();
         
+        SpatialQuery::release(ecs);
         delete ecs;
         ecs = new ECS();
-        ecs->registerComponent<Transform>();
-        ecs->registerComponent<Tag>();
-        ecs->registerComponent<Layer>();
-        ecs->registerComponent<ModelComponent>();
-        ecs->registerComponent<CameraComponent>();
+        setupWorld(ecs);
     }
     
     // ==================== Play Mode ====================
@@ -939,8 +1098,13 @@ void restoreSnapshot() {
         if (!running) return;
         running = false;
         
+        autosaver.wait();
         vkDeviceWaitIdle(device);
         
+        worldBuilder.cancel();
+        retiredWorlds.flush(modelLoader);
+        world.close();
+        
         for (EntityID e : modelEntities) {
             auto* mc = ecs->getComponent<ModelComponent>(e);
             if (mc && mc->loadedModel) {
@@ -949,6 +1113,7 @@ void restoreSnapshot() {
             }
         }
         
+        SpatialQuery::release(ecs);
         delete ecs;
         ecs = nullptr;
         
@@ -1010,7 +1175,23 @@ EngineFrame ZeroEngine::getOutputFrame() const {
 VkSampler ZeroEngine::getOutputSampler() const { return impl->offscreen.sampler; }
 
 bool ZeroEngine::loadScene(const std::string& path) { return impl->loadScene(path); }
+bool ZeroEngine::loadScene(const std::string& path, const std::function<void(const SceneLoadProgress&)>& onProgress) {
+    return impl->loadScene(path, onProgress);
+}
+bool ZeroEngine::loadSceneAsync(const std::string& path, const std::function<void(const SceneLoadProgress&)>& onProgress) {
+    return impl->loadSceneAsync(path, onProgress);
+}
+bool ZeroEngine::isSceneLoading() const { return impl->worldBuilder.isBuilding(); }
 bool ZeroEngine::saveScene(const std::string& path) { return impl->saveScene(path); }
+bool ZeroEngine::saveSceneAsync(const std::string& path) { return impl->saveSceneAsync(path); }
+bool ZeroEngine::saveSceneBundle(const std::string& path) { return impl->saveSceneBundle(path); }
+bool ZeroEngine::saveWorld(const std::string& path, float cellSize, bool bundleAssets) {
+    return impl->saveWorld(path, cellSize, bundleAssets);
+}
+bool ZeroEngine::openWorld(const std::string& path) { return impl->openWorld(path); }
+void ZeroEngine::setStreamingSource(uint32_t id, const glm::vec3& position) { impl->world.setSource(id, position); }
+void ZeroEngine::removeStreamingSource(uint32_t id) { impl->world.removeSource(id); }
+void ZeroEngine::setAutosave(const std::string& path, float intervalSeconds) { impl->setAutosave(path, intervalSeconds); }
 void ZeroEngine::newScene() { impl->clearScene(); }
 
 EntityID ZeroEngine::createEntity(const std::string& name) { return impl->createEntity(name); }
@@ -1156,7 +1337,7 @@ void ZeroEngine::pause() { impl->playState = PlayState::Paused; }
 void ZeroEngine::setEntityName(EntityID id, const std::string& name) {
     auto* tag = impl->ecs->getComponent<Tag>(id);
     if (tag) {
-        tag->name = name;
+        tag->set(name);
     } else {
         impl->ecs->addComponent(id, Tag{name});
     }
@@ -1205,6 +1386,10 @@ void ZeroEngine::setDirectionalLight(glm::vec3 dir, glm::vec3 color, float ambie
     impl->shadowMap.lightDir = impl->lightDir;
 }
 
+AssetManager& ZeroEngine::getAssets() { return impl->assets; }
+
+EventSystem& ZeroEngine::getEvents() { return impl->events; }
+
 VkDevice ZeroEngine::getDevice() const { return impl->device; }
 VmaAllocator ZeroEngine::getAllocator() const { return impl->allocator; }
 VkDescriptorPool ZeroEngine::getDescriptorPool() const { return impl->descriptorPool; }